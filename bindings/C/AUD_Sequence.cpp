@@ -16,6 +16,7 @@
 
 #include "devices/I3DDevice.h"
 #include "devices/DeviceManager.h"
+#include "sequence/Scrub.h"
 #include "sequence/Sequence.h"
 #include "Exception.h"
 
@@ -106,6 +107,18 @@ AUD_API void AUD_Sequence_setFPS(AUD_Sound* sequence, float value)
 	dynamic_cast<Sequence *>(sequence->get())->setFPS(value);
 }
 
+AUD_API float AUD_Sequence_getLookAhead(AUD_Sound* sequence)
+{
+	assert(sequence);
+	return dynamic_cast<Sequence *>(sequence->get())->getLookAhead();
+}
+
+AUD_API void AUD_Sequence_setLookAhead(AUD_Sound* sequence, float value)
+{
+	assert(sequence);
+	dynamic_cast<Sequence *>(sequence->get())->setLookAhead(value);
+}
+
 AUD_API int AUD_Sequence_isMuted(AUD_Sound* sequence)
 {
 	assert(sequence);
@@ -158,6 +171,12 @@ AUD_API void AUD_Sequence_setSpeedOfSound(AUD_Sound* sequence, float value)
 	dynamic_cast<Sequence *>(sequence->get())->setSpeedOfSound(value);
 }
 
+AUD_API AUD_Sound* AUD_Sequence_scrub(AUD_Sound* sequence, float range, int quality)
+{
+	assert(sequence);
+	return new AUD_Sound(new Scrub(std::dynamic_pointer_cast<Sequence>(*sequence), range, quality));
+}
+
 
 
 AUD_API void AUD_SequenceEntry_move(AUD_SequenceEntry* entry, float begin, float end, float skip)
@@ -251,6 +270,18 @@ AUD_API void AUD_SequenceEntry_setDistanceReference(AUD_SequenceEntry* sequence_
 	(*sequence_entry)->setDistanceReference(value);
 }
 
+AUD_API int AUD_SequenceEntry_isFrozen(AUD_SequenceEntry* sequence_entry)
+{
+	assert(sequence_entry);
+	return (*sequence_entry)->isFrozen();
+}
+
+AUD_API void AUD_SequenceEntry_setFrozen(AUD_SequenceEntry* sequence_entry, int value)
+{
+	assert(sequence_entry);
+	(*sequence_entry)->freeze(value);
+}
+
 AUD_API int AUD_SequenceEntry_isMuted(AUD_SequenceEntry* sequence_entry)
 {
 	assert(sequence_entry);
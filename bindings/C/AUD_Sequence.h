@@ -116,6 +116,20 @@ extern AUD_API float AUD_Sequence_getFPS(AUD_Sound* sequence);
  */
 extern AUD_API void AUD_Sequence_setFPS(AUD_Sound* sequence, float value);
 
+/**
+ * Retrieves the look-ahead time of a sequence.
+ * param sequence The sequence to get the look-ahead time from.
+ * return The look-ahead time of the sequence in seconds.
+ */
+extern AUD_API float AUD_Sequence_getLookAhead(AUD_Sound* sequence);
+
+/**
+ * Sets the look-ahead time of a sequence, 0 disables prefetching.
+ * param sequence The sequence to set the look-ahead time from.
+ * param value The new look-ahead time to set in seconds.
+ */
+extern AUD_API void AUD_Sequence_setLookAhead(AUD_Sound* sequence, float value);
+
 /**
  * Retrieves the muted of a sequence.
  * param sequence The sequence to get the muted from.
@@ -158,6 +172,16 @@ extern AUD_API float AUD_Sequence_getSpeedOfSound(AUD_Sound* sequence);
  */
 extern AUD_API void AUD_Sequence_setSpeedOfSound(AUD_Sound* sequence, float value);
 
+/**
+ * Creates a sound for scrubbing a sequence, which caches the mix around the
+ * playback position and updates itself when the sequence is edited.
+ * \param sequence The sound scene.
+ * \param range How many seconds are cached before and after the position.
+ * \param quality Whether to render with high quality.
+ * \return The scrub sound, which has to be freed with AUD_Sound_free.
+ */
+extern AUD_API AUD_Sound* AUD_Sequence_scrub(AUD_Sound* sequence, float range, int quality);
+
 
 
 /**
@@ -263,6 +287,20 @@ extern AUD_API float AUD_SequenceEntry_getDistanceReference(AUD_SequenceEntry* s
  */
 extern AUD_API void AUD_SequenceEntry_setDistanceReference(AUD_SequenceEntry* sequence_entry, float value);
 
+/**
+ * Retrieves whether a sequence_entry is frozen.
+ * param sequence_entry The sequence_entry to get the frozen state from.
+ * return Whether the sequence_entry plays a pre-rendered version of its sound.
+ */
+extern AUD_API int AUD_SequenceEntry_isFrozen(AUD_SequenceEntry* sequence_entry);
+
+/**
+ * Freezes a sequence_entry, pre-rendering its sound in the background.
+ * param sequence_entry The sequence_entry to set the frozen state from.
+ * param value The new frozen state to set.
+ */
+extern AUD_API void AUD_SequenceEntry_setFrozen(AUD_SequenceEntry* sequence_entry, int value);
+
 /**
  * Retrieves the muted of a sequence_entry.
  * param sequence_entry The sequence_entry to get the muted from.
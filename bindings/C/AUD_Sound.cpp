@@ -22,6 +22,8 @@
 #include "file/File.h"
 #include "file/FileWriter.h"
 #include "util/StreamBuffer.h"
+#include "util/AsyncLoader.h"
+#include "util/LoadProgress.h"
 #include "fx/Accumulator.h"
 #include "fx/ADSR.h"
 #include "fx/BinauralSound.h"
@@ -42,7 +44,7 @@
 #include "fx/SoundList.h"
 #include "fx/MutableSound.h"
 #include "sequence/Double.h"
-#include "sequence/Superpose.h"
+#include "sequence/Mix.h"
 #include "sequence/PingPong.h"
 #include "respec/LinearResample.h"
 #include "respec/JOSResample.h"
@@ -262,6 +264,71 @@ AUD_API AUD_Sound* AUD_Sound_cache(AUD_Sound* sound)
 	}
 }
 
+AUD_API AUD_LoadRequest* AUD_Sound_cacheAsync(AUD_Sound* sound, AUD_LoadPriority priority)
+{
+	assert(sound);
+
+	return new AUD_LoadRequest(AsyncLoader::cacheAsync(*sound, static_cast<LoadPriority>(priority)));
+}
+
+AUD_API AUD_LoadRequest* AUD_Sound_loadAsync(const char* filename, AUD_LoadPriority priority)
+{
+	assert(filename);
+
+	return new AUD_LoadRequest(AsyncLoader::loadAsync(filename, static_cast<LoadPriority>(priority)));
+}
+
+AUD_API AUD_LoadStatus AUD_LoadRequest_getStatus(AUD_LoadRequest* request)
+{
+	assert(request);
+
+	return static_cast<AUD_LoadStatus>((*request)->getStatus());
+}
+
+AUD_API float AUD_LoadRequest_getProgress(AUD_LoadRequest* request)
+{
+	assert(request);
+
+	return (*request)->getProgress()->getProgress();
+}
+
+AUD_API AUD_Sound* AUD_LoadRequest_getSound(AUD_LoadRequest* request)
+{
+	assert(request);
+
+	std::shared_ptr<ISound> sound = (*request)->getSound();
+
+	if(!sound)
+		return nullptr;
+
+	return new AUD_Sound(sound);
+}
+
+AUD_API AUD_LoadStatus AUD_LoadRequest_wait(AUD_LoadRequest* request, float timeout)
+{
+	assert(request);
+
+	if(timeout < 0)
+		(*request)->wait();
+	else
+		(*request)->wait(timeout);
+
+	return static_cast<AUD_LoadStatus>((*request)->getStatus());
+}
+
+AUD_API void AUD_LoadRequest_cancel(AUD_LoadRequest* request)
+{
+	assert(request);
+
+	(*request)->cancel();
+}
+
+AUD_API void AUD_LoadRequest_free(AUD_LoadRequest* request)
+{
+	assert(request);
+	delete request;
+}
+
 AUD_API AUD_Sound* AUD_Sound_file(const char* filename)
 {
 	assert(filename);
@@ -593,7 +660,7 @@ AUD_API AUD_Sound* AUD_Sound_mix(AUD_Sound* first, AUD_Sound* second)
 
 	try
 	{
-		return new AUD_Sound(new Superpose(*first, *second));
+		return new AUD_Sound(new Mix(*first, *second));
 	}
 	catch(Exception&)
 	{
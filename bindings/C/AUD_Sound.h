@@ -96,6 +96,64 @@ extern AUD_API AUD_Sound* AUD_Sound_bufferFile(unsigned char* buffer, int size);
  */
 extern AUD_API AUD_Sound* AUD_Sound_cache(AUD_Sound* sound);
 
+/**
+ * Caches a sound into a memory buffer in the background.
+ * \param sound The sound to cache.
+ * \param priority The priority of the load.
+ * \return A handle of the load request, which has to be freed.
+ */
+extern AUD_API AUD_LoadRequest* AUD_Sound_cacheAsync(AUD_Sound* sound, AUD_LoadPriority priority);
+
+/**
+ * Opens a sound file in the background and checks that it can be read.
+ * \param filename The path to the file.
+ * \param priority The priority of the load.
+ * \return A handle of the load request, which has to be freed.
+ */
+extern AUD_API AUD_LoadRequest* AUD_Sound_loadAsync(const char* filename, AUD_LoadPriority priority);
+
+/**
+ * Retrieves the status of an asynchronous load.
+ * \param request The load request.
+ * \return The status of the load.
+ */
+extern AUD_API AUD_LoadStatus AUD_LoadRequest_getStatus(AUD_LoadRequest* request);
+
+/**
+ * Retrieves the progress of an asynchronous load.
+ * \param request The load request.
+ * \return The progress between 0 and 1.
+ */
+extern AUD_API float AUD_LoadRequest_getProgress(AUD_LoadRequest* request);
+
+/**
+ * Retrieves the loaded sound.
+ * \param request The load request.
+ * \return A handle of the loaded sound or NULL if the load hasn't finished
+ *         successfully.
+ */
+extern AUD_API AUD_Sound* AUD_LoadRequest_getSound(AUD_LoadRequest* request);
+
+/**
+ * Waits until an asynchronous load has finished.
+ * \param request The load request.
+ * \param timeout The maximum time to wait in seconds, negative to wait without limit.
+ * \return The status of the load.
+ */
+extern AUD_API AUD_LoadStatus AUD_LoadRequest_wait(AUD_LoadRequest* request, float timeout);
+
+/**
+ * Cancels an asynchronous load.
+ * \param request The load request.
+ */
+extern AUD_API void AUD_LoadRequest_cancel(AUD_LoadRequest* request);
+
+/**
+ * Frees a load request handle, the load itself continues.
+ * \param request The load request.
+ */
+extern AUD_API void AUD_LoadRequest_free(AUD_LoadRequest* request);
+
 /**
  * Loads a sound file.
  * \param filename The filename of the sound file.
@@ -311,6 +369,7 @@ extern AUD_API AUD_Sound* AUD_Sound_join(AUD_Sound* first, AUD_Sound* second);
 
 /**
  * Mixes two sound, which means superposing the sound samples.
+ * Mixing already mixed sounds again results in a single flat mix.
  * \param first The first sound.
  * \param second The second sound.
  * \return A handle of the mixed sound.
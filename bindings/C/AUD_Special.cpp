@@ -29,17 +29,24 @@
 #include "fx/Limiter.h"
 #include "devices/DeviceManager.h"
 #include "sequence/Sequence.h"
+#include "sequence/SegmentedReader.h"
+#include "file/FileManager.h"
 #include "file/FileWriter.h"
 #include "devices/ReadDevice.h"
 #include "plugin/PluginManager.h"
+#include "util/ThreadPool.h"
+#include "util/WaveformCache.h"
 #include "devices/DeviceManager.h"
 #include "devices/IDeviceFactory.h"
 #include "devices/NULLDevice.h"
 
+#include <atomic>
 #include <cassert>
+#include <chrono>
 #include <cstring>
 #include <cmath>
 #include <sstream>
+#include <thread>
 
 using namespace aud;
 
@@ -270,14 +277,65 @@ AUD_API int AUD_readSound(AUD_Sound* sound, float* buffer, int length, int sampl
 	return length;
 }
 
+AUD_API int AUD_readWaveform(const char* filename, float* buffer, int length, float start, int samples_per_second, int wait)
+{
+	assert(filename);
+
+	std::shared_future<std::shared_ptr<Waveform> > future = WaveformCache::get(filename);
+
+	if(!wait && future.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+		return 0;
+
+	float overallmax;
+
+	try
+	{
+		std::shared_ptr<Waveform> waveform = future.get();
+		length = waveform->read(buffer, length, start, samples_per_second);
+
+		// the whole sound is normalized the same way, independent of the window
+		overallmax = waveform->getPeak();
+	}
+	catch(Exception&)
+	{
+		return -1;
+	}
+
+	if(overallmax > 1.0f)
+	{
+		for(int i = 0; i < length * 3; i++)
+		{
+			buffer[i] /= overallmax;
+		}
+	}
+
+	return length;
+}
+
+static std::atomic<int> mixdown_threads(0);
+
+static std::shared_ptr<IReader> createMixdownReader(std::shared_ptr<Sequence> sequence)
+{
+	int threads = mixdown_threads;
+
+	if(threads < 0)
+		threads = std::thread::hardware_concurrency();
+
+	// segments are only exact for sources that seek sample accurately, so this is opt-in
+	if(threads > 1)
+		return std::make_shared<SegmentedReader>(sequence, std::make_shared<ThreadPool>(threads));
+
+	return sequence->createQualityReader();
+}
+
 AUD_API const char* AUD_mixdown(AUD_Sound* sound, unsigned int start, unsigned int length, unsigned int buffersize, const char* filename, AUD_DeviceSpecs specs, AUD_Container format, AUD_Codec codec, unsigned int bitrate)
 {
 	try
 	{
-		Sequence* f = dynamic_cast<Sequence *>(sound->get());
+		std::shared_ptr<Sequence> f = std::dynamic_pointer_cast<Sequence>(*sound);
 
 		f->setSpecs(convCToSpec(specs.specs));
-		std::shared_ptr<IReader> reader = f->createQualityReader();
+		std::shared_ptr<IReader> reader = createMixdownReader(f);
 		reader->seek(start);
 		std::shared_ptr<IWriter> writer = FileWriter::createWriter(filename, convCToDSpec(specs), static_cast<Container>(format), static_cast<Codec>(codec), bitrate);
 		FileWriter::writeReader(reader, writer, length, buffersize);
@@ -294,7 +352,7 @@ AUD_API const char* AUD_mixdown_per_channel(AUD_Sound* sound, unsigned int start
 {
 	try
 	{
-		Sequence* f = dynamic_cast<Sequence *>(sound->get());
+		std::shared_ptr<Sequence> f = std::dynamic_pointer_cast<Sequence>(*sound);
 
 		f->setSpecs(convCToSpec(specs.specs));
 
@@ -324,7 +382,7 @@ AUD_API const char* AUD_mixdown_per_channel(AUD_Sound* sound, unsigned int start
 			writers.push_back(FileWriter::createWriter(stream.str(), convCToDSpec(specs), static_cast<Container>(format), static_cast<Codec>(codec), bitrate));
 		}
 
-		std::shared_ptr<IReader> reader = f->createQualityReader();
+		std::shared_ptr<IReader> reader = createMixdownReader(f);
 		reader->seek(start);
 		FileWriter::writeReader(reader, writers, length, buffersize);
 
@@ -336,6 +394,11 @@ AUD_API const char* AUD_mixdown_per_channel(AUD_Sound* sound, unsigned int start
 	}
 }
 
+AUD_API void AUD_setMixdownThreads(int threads)
+{
+	mixdown_threads = threads;
+}
+
 AUD_API AUD_Device* AUD_openMixdownDevice(AUD_DeviceSpecs specs, AUD_Sound* sequencer, float volume, float start)
 {
 	try
@@ -418,3 +481,19 @@ AUD_API char** AUD_getDeviceNames()
 
 	return names;
 }
+
+AUD_API void AUD_setReadAhead(int length)
+{
+	FileManager::setReadAhead(length);
+}
+
+AUD_API int AUD_getReadAhead()
+{
+	return FileManager::getReadAhead();
+}
+
+AUD_API void AUD_setSeekIndexing(int enabled, const char* directory)
+{
+	FileManager::setSeekIndexDirectory(directory ? directory : "");
+	FileManager::setSeekIndexing(enabled);
+}
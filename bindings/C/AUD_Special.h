@@ -57,6 +57,21 @@ extern AUD_API AUD_Handle* AUD_pauseAfter(AUD_Handle* handle, float seconds);
  */
 extern AUD_API int AUD_readSound(AUD_Sound* sound, float* buffer, int length, int samples_per_second, short* interrupt);
 
+/**
+ * Reads the waveform of a sound file for drawing at a specific sampling rate.
+ * The waveform is computed once in the background and cached, also in a
+ * sidecar file, so that any zoom level can be read quickly.
+ * \param filename The path of the sound file.
+ * \param buffer The buffer to write to. Must have a size of 3*4*length.
+ * \param length How many samples to read.
+ * \param start The time in seconds to start reading at.
+ * \param samples_per_second How many samples to read per second of the sound.
+ * \param wait Whether to wait for the waveform if it hasn't been computed yet.
+ * \return How many samples really have been read, 0 if the waveform isn't
+ *         computed yet and -1 if the file couldn't be read.
+ */
+extern AUD_API int AUD_readWaveform(const char* filename, float* buffer, int length, float start, int samples_per_second, int wait);
+
 /**
  * Mixes a sound down into a file.
  * \param sound The sound scene to mix down.
@@ -93,6 +108,17 @@ extern AUD_API const char* AUD_mixdown_per_channel(AUD_Sound* sound, unsigned in
 										   AUD_DeviceSpecs specs, AUD_Container format,
 										   AUD_Codec codec, unsigned int bitrate);
 
+/**
+ * Sets how many threads mixdowns are rendered with.
+ * With more than one thread the scene is rendered in parallel segments that
+ * start rendering a second early to warm up resamplers and effects. The
+ * result differs from a serial render if sounds don't seek sample accurately
+ * or effects have longer tails.
+ * \param threads The amount of threads, a negative value for one per
+ *        hardware thread or 0 or 1 to render serially, which is the default.
+ */
+extern AUD_API void AUD_setMixdownThreads(int threads);
+
 /**
  * Opens a read device and prepares it for mixdown of the sound scene.
  * \param specs Output audio specifications.
@@ -133,6 +159,31 @@ extern AUD_API void AUD_exit(AUD_Device* device);
  */
 extern AUD_API char** AUD_getDeviceNames();
 
+/**
+ * Sets the read-ahead window for newly opened sound files.
+ * File readers that support it decode this many samples in advance on a
+ * background thread, so that playback doesn't wait for the decoder.
+ * \param length The amount of samples to decode in advance or 0 to decode
+ *        synchronously, which is the default.
+ */
+extern AUD_API void AUD_setReadAhead(int length);
+
+/**
+ * Retrieves the read-ahead window for newly opened sound files.
+ * \return The amount of samples decoded in advance, 0 if synchronous.
+ */
+extern AUD_API int AUD_getReadAhead();
+
+/**
+ * Enables or disables seek indices for newly opened sound files.
+ * File readers that support it index the packets of a file on a background
+ * thread, so that seeking is sample accurate and cheap.
+ * \param enabled Whether files should be indexed, disabled by default.
+ * \param directory The directory to store completed indices in, so that each
+ *        file only has to be indexed once, or nullptr to not store them.
+ */
+extern AUD_API void AUD_setSeekIndexing(int enabled, const char* directory);
+
 #ifdef __cplusplus
 }
 #endif
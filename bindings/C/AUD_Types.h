@@ -29,6 +29,7 @@
 #include "fx/HRTF.h"
 #include "fx/Source.h"
 #include "util/ThreadPool.h"
+#include "util/LoadRequest.h"
 
 typedef std::shared_ptr<aud::ISound> AUD_Sound;
 typedef std::shared_ptr<aud::IHandle> AUD_Handle;
@@ -40,6 +41,7 @@ typedef std::shared_ptr<aud::ThreadPool> AUD_ThreadPool;
 typedef std::shared_ptr<aud::ImpulseResponse> AUD_ImpulseResponse;
 typedef std::shared_ptr<aud::HRTF> AUD_HRTF;
 typedef std::shared_ptr<aud::Source> AUD_Source;
+typedef std::shared_ptr<aud::LoadRequest> AUD_LoadRequest;
 #else
 typedef void AUD_Sound;
 typedef void AUD_Handle;
@@ -51,6 +53,7 @@ typedef void AUD_ThreadPool;
 typedef void AUD_ImpulseResponse;
 typedef void AUD_HRTF;
 typedef void AUD_Source;
+typedef void AUD_LoadRequest;
 #endif
 
 /// Container formats for writers.
@@ -161,6 +164,24 @@ typedef struct
 	};
 } AUD_DeviceSpecs;
 
+/// Status of an asynchronous load.
+typedef enum
+{
+	AUD_LOAD_STATUS_QUEUED = 0,	/// Waiting for a loader thread.
+	AUD_LOAD_STATUS_LOADING,	/// Being loaded.
+	AUD_LOAD_STATUS_DONE,		/// Loaded successfully.
+	AUD_LOAD_STATUS_FAILED,		/// Loading failed.
+	AUD_LOAD_STATUS_CANCELLED	/// Loading has been cancelled.
+} AUD_LoadStatus;
+
+/// Priority of an asynchronous load.
+typedef enum
+{
+	AUD_LOAD_PRIORITY_LOW = 0,	/// Load when nothing else is waiting.
+	AUD_LOAD_PRIORITY_NORMAL,	/// Default priority.
+	AUD_LOAD_PRIORITY_HIGH		/// Load before everything else.
+} AUD_LoadPriority;
+
 /// Sound information structure.
 typedef struct
 {
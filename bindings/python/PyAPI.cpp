@@ -23,6 +23,7 @@
 #include "PyPlaybackManager.h"
 #include "PyDynamicMusic.h"
 #include "PyThreadPool.h"
+#include "PyLoadRequest.h"
 #include "PyImpulseResponse.h"
 #include "PyHRTF.h"
 #include "PySource.h"
@@ -33,6 +34,7 @@
 #include "file/IWriter.h"
 #include "plugin/PluginManager.h"
 #include "sequence/AnimateableProperty.h"
+#include "util/LoadRequest.h"
 #include "ISound.h"
 
 #include <memory>
@@ -104,6 +106,9 @@ PyInit_aud()
 	if(!initializeSource())
 		return nullptr;
 
+	if(!initializeLoadRequest())
+		return nullptr;
+
 	module = PyModule_Create(&audmodule);
 	if(module == nullptr)
 		return nullptr;
@@ -119,6 +124,7 @@ PyInit_aud()
 	addImpulseResponseToModule(module);
 	addHRTFToModule(module);
 	addSourceToModule(module);
+	addLoadRequestToModule(module);
 
 	AUDError = PyErr_NewException("aud.error", nullptr, nullptr);
 	Py_INCREF(AUDError);
@@ -176,6 +182,16 @@ PyInit_aud()
 	PY_MODULE_ADD_CONSTANT(module, FORMAT_S24);
 	PY_MODULE_ADD_CONSTANT(module, FORMAT_S32);
 	PY_MODULE_ADD_CONSTANT(module, FORMAT_U8);
+	// load priority constants
+	PY_MODULE_ADD_CONSTANT(module, LOAD_PRIORITY_LOW);
+	PY_MODULE_ADD_CONSTANT(module, LOAD_PRIORITY_NORMAL);
+	PY_MODULE_ADD_CONSTANT(module, LOAD_PRIORITY_HIGH);
+	// load status constants
+	PY_MODULE_ADD_CONSTANT(module, LOAD_STATUS_QUEUED);
+	PY_MODULE_ADD_CONSTANT(module, LOAD_STATUS_LOADING);
+	PY_MODULE_ADD_CONSTANT(module, LOAD_STATUS_DONE);
+	PY_MODULE_ADD_CONSTANT(module, LOAD_STATUS_FAILED);
+	PY_MODULE_ADD_CONSTANT(module, LOAD_STATUS_CANCELLED);
 	// rate constants
 	PY_MODULE_ADD_CONSTANT(module, RATE_INVALID);
 	PY_MODULE_ADD_CONSTANT(module, RATE_8000);
@@ -0,0 +1,225 @@
+/*******************************************************************************
+ * Copyright 2009-2016 Jörg Müller
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ ******************************************************************************/
+
+
+#include "PyLoadRequest.h"
+#include "PySound.h"
+
+#include "Exception.h"
+#include "util/LoadProgress.h"
+#include "util/LoadRequest.h"
+
+extern PyObject* AUDError;
+
+using aud::LoadRequest;
+using aud::ISound;
+
+static void
+LoadRequest_dealloc(LoadRequestP* self)
+{
+	if(self->request)
+		delete reinterpret_cast<std::shared_ptr<LoadRequest>*>(self->request);
+	Py_TYPE(self)->tp_free((PyObject *)self);
+}
+
+PyDoc_STRVAR(M_aud_LoadRequest_cancel_doc,
+			 "cancel()\n\n"
+			 "Cancels the load. Queued loads are dropped, running ones stop as "
+			 "soon as possible.");
+
+static PyObject *
+LoadRequest_cancel(LoadRequestP* self)
+{
+	(*reinterpret_cast<std::shared_ptr<LoadRequest>*>(self->request))->cancel();
+
+	Py_RETURN_NONE;
+}
+
+PyDoc_STRVAR(M_aud_LoadRequest_wait_doc,
+			 "wait(timeout=-1)\n\n"
+			 "Waits until loading has finished.\n\n"
+			 ":arg timeout: The maximum time to wait in seconds, negative to "
+			 "wait without limit.\n"
+			 ":type timeout: float\n"
+			 ":return: Whether loading has finished.\n"
+			 ":rtype: bool");
+
+static PyObject *
+LoadRequest_wait(LoadRequestP* self, PyObject* args)
+{
+	float timeout = -1.0f;
+
+	if(!PyArg_ParseTuple(args, "|f:wait", &timeout))
+		return nullptr;
+
+	std::shared_ptr<LoadRequest> request = *reinterpret_cast<std::shared_ptr<LoadRequest>*>(self->request);
+	bool finished = true;
+
+	Py_BEGIN_ALLOW_THREADS
+	if(timeout < 0)
+		request->wait();
+	else
+		finished = request->wait(timeout);
+	Py_END_ALLOW_THREADS
+
+	return PyBool_FromLong(finished);
+}
+
+static PyMethodDef LoadRequest_methods[] = {
+	{"cancel", (PyCFunction)LoadRequest_cancel, METH_NOARGS,
+	 M_aud_LoadRequest_cancel_doc
+	},
+	{"wait", (PyCFunction)LoadRequest_wait, METH_VARARGS,
+	 M_aud_LoadRequest_wait_doc
+	},
+	{ nullptr }  /* Sentinel */
+};
+
+PyDoc_STRVAR(M_aud_LoadRequest_error_doc,
+			 "The reason why loading failed, empty unless the status is "
+			 ":const:`LOAD_STATUS_FAILED`.");
+
+static PyObject *
+LoadRequest_get_error(LoadRequestP* self, void* nothing)
+{
+	return Py_BuildValue("s", (*reinterpret_cast<std::shared_ptr<LoadRequest>*>(self->request))->getError().c_str());
+}
+
+PyDoc_STRVAR(M_aud_LoadRequest_progress_doc,
+			 "The progress of the load between 0 and 1.");
+
+static PyObject *
+LoadRequest_get_progress(LoadRequestP* self, void* nothing)
+{
+	return Py_BuildValue("f", (*reinterpret_cast<std::shared_ptr<LoadRequest>*>(self->request))->getProgress()->getProgress());
+}
+
+PyDoc_STRVAR(M_aud_LoadRequest_sound_doc,
+			 "The loaded :class:`Sound` or None if loading hasn't finished "
+			 "successfully.");
+
+static PyObject *
+LoadRequest_get_sound(LoadRequestP* self, void* nothing)
+{
+	std::shared_ptr<ISound> sound = (*reinterpret_cast<std::shared_ptr<LoadRequest>*>(self->request))->getSound();
+
+	if(!sound)
+		Py_RETURN_NONE;
+
+	Sound* object = (Sound*)Sound_empty();
+
+	if(object != nullptr)
+		object->sound = new std::shared_ptr<ISound>(sound);
+
+	return (PyObject *)object;
+}
+
+PyDoc_STRVAR(M_aud_LoadRequest_status_doc,
+			 "The status of the load, one of the LOAD_STATUS_* constants.");
+
+static PyObject *
+LoadRequest_get_status(LoadRequestP* self, void* nothing)
+{
+	return Py_BuildValue("i", (*reinterpret_cast<std::shared_ptr<LoadRequest>*>(self->request))->getStatus());
+}
+
+static PyGetSetDef LoadRequest_properties[] = {
+	{(char*)"error", (getter)LoadRequest_get_error, nullptr,
+	 M_aud_LoadRequest_error_doc, nullptr },
+	{(char*)"progress", (getter)LoadRequest_get_progress, nullptr,
+	 M_aud_LoadRequest_progress_doc, nullptr },
+	{(char*)"sound", (getter)LoadRequest_get_sound, nullptr,
+	 M_aud_LoadRequest_sound_doc, nullptr },
+	{(char*)"status", (getter)LoadRequest_get_status, nullptr,
+	 M_aud_LoadRequest_status_doc, nullptr },
+	{ nullptr }  /* Sentinel */
+};
+
+PyDoc_STRVAR(M_aud_LoadRequest_doc,
+			 "A LoadRequest represents a sound that is loaded in the background. "
+			 "It is returned by :meth:`Sound.cacheAsync` and "
+			 ":meth:`Sound.loadAsync`.");
+
+PyTypeObject LoadRequestType = {
+	PyVarObject_HEAD_INIT(nullptr, 0)
+	"aud.LoadRequest",						/* tp_name */
+	sizeof(LoadRequestP),					/* tp_basicsize */
+	0,										/* tp_itemsize */
+	(destructor)LoadRequest_dealloc,		/* tp_dealloc */
+	0,										/* tp_print */
+	0,										/* tp_getattr */
+	0,										/* tp_setattr */
+	0,										/* tp_reserved */
+	0,										/* tp_repr */
+	0,										/* tp_as_number */
+	0,										/* tp_as_sequence */
+	0,										/* tp_as_mapping */
+	0,										/* tp_hash  */
+	0,										/* tp_call */
+	0,										/* tp_str */
+	0,										/* tp_getattro */
+	0,										/* tp_setattro */
+	0,										/* tp_as_buffer */
+	Py_TPFLAGS_DEFAULT,						/* tp_flags */
+	M_aud_LoadRequest_doc,					/* tp_doc */
+	0,										/* tp_traverse */
+	0,										/* tp_clear */
+	0,										/* tp_richcompare */
+	0,										/* tp_weaklistoffset */
+	0,										/* tp_iter */
+	0,										/* tp_iternext */
+	LoadRequest_methods,					/* tp_methods */
+	0,										/* tp_members */
+	LoadRequest_properties,					/* tp_getset */
+	0,										/* tp_base */
+	0,										/* tp_dict */
+	0,										/* tp_descr_get */
+	0,										/* tp_descr_set */
+	0,										/* tp_dictoffset */
+	0,										/* tp_init */
+	0,										/* tp_alloc */
+	0,										/* tp_new */
+};
+
+AUD_API PyObject* LoadRequest_empty()
+{
+	return LoadRequestType.tp_alloc(&LoadRequestType, 0);
+}
+
+
+AUD_API LoadRequestP* checkLoadRequest(PyObject* request)
+{
+	if(!PyObject_TypeCheck(request, &LoadRequestType))
+	{
+		PyErr_SetString(PyExc_TypeError, "Object is not of type LoadRequest!");
+		return nullptr;
+	}
+
+	return (LoadRequestP*)request;
+}
+
+
+bool initializeLoadRequest()
+{
+	return PyType_Ready(&LoadRequestType) >= 0;
+}
+
+
+void addLoadRequestToModule(PyObject* module)
+{
+	Py_INCREF(&LoadRequestType);
+	PyModule_AddObject(module, "LoadRequest", (PyObject *)&LoadRequestType);
+}
@@ -20,6 +20,7 @@
 #include "PySequenceEntry.h"
 
 #include "sequence/AnimateableProperty.h"
+#include "sequence/Scrub.h"
 #include "sequence/Sequence.h"
 #include "Exception.h"
 
@@ -269,6 +270,60 @@ Sequence_setAnimationData(Sequence* self, PyObject* args)
 	}
 }
 
+PyDoc_STRVAR(M_aud_Sequence_scrub_doc,
+			 "scrub(range=2.0, quality=False)\n\n"
+			 "Creates a sound for scrubbing the sequence, which caches the mix "
+			 "around the playback position and updates itself when the "
+			 "sequence is edited.\n\n"
+			 ":arg range: How many seconds are cached before and after the position.\n"
+			 ":type range: float\n"
+			 ":arg quality: Whether to render with high quality.\n"
+			 ":type quality: bool\n"
+			 ":return: The created :class:`Sound` object.\n"
+			 ":rtype: :class:`Sound`");
+
+static PyObject *
+Sequence_scrub(Sequence* self, PyObject* args, PyObject* kwds)
+{
+	float range = 2.0f;
+	PyObject* qualityo = nullptr;
+	bool quality = false;
+
+	static const char* kwlist[] = {"range", "quality", nullptr};
+
+	if(!PyArg_ParseTupleAndKeywords(args, kwds, "|fO:scrub", const_cast<char**>(kwlist), &range, &qualityo))
+		return nullptr;
+
+	if(qualityo)
+	{
+		if(!PyBool_Check(qualityo))
+		{
+			PyErr_SetString(PyExc_TypeError, "quality is not a boolean!");
+			return nullptr;
+		}
+
+		quality = qualityo == Py_True;
+	}
+
+	Sound* sound = (Sound*)Sound_empty();
+
+	if(sound != nullptr)
+	{
+		try
+		{
+			sound->sound = new std::shared_ptr<ISound>(new aud::Scrub(*reinterpret_cast<std::shared_ptr<aud::Sequence>*>(self->sequence), range, quality));
+		}
+		catch(Exception& e)
+		{
+			Py_DECREF(sound);
+			PyErr_SetString(AUDError, e.what());
+			return nullptr;
+		}
+	}
+
+	return (PyObject *)sound;
+}
+
 static PyMethodDef Sequence_methods[] = {
 	{"add", (PyCFunction)Sequence_add, METH_VARARGS | METH_KEYWORDS,
 	 M_aud_Sequence_add_doc
@@ -279,6 +334,9 @@ static PyMethodDef Sequence_methods[] = {
 	{"setAnimationData", (PyCFunction)Sequence_setAnimationData, METH_VARARGS,
 	 M_aud_Sequence_setAnimationData_doc
 	},
+	{"scrub", (PyCFunction)Sequence_scrub, METH_VARARGS | METH_KEYWORDS,
+	 M_aud_Sequence_scrub_doc
+	},
 	{nullptr}  /* Sentinel */
 };
 
@@ -16,6 +16,7 @@
 
 #include "PyHRTF.h"
 #include "PyImpulseResponse.h"
+#include "PyLoadRequest.h"
 #include "PySound.h"
 #include "PySource.h"
 #include "PyThreadPool.h"
@@ -24,6 +25,7 @@
 #include "file/File.h"
 #include "file/FileWriter.h"
 #include "util/StreamBuffer.h"
+#include "util/AsyncLoader.h"
 #include "generator/Sawtooth.h"
 #include "generator/Silence.h"
 #include "generator/Sine.h"
@@ -54,8 +56,8 @@
 #include "respec/JOSResample.h"
 #include "respec/JOSResampleReader.h"
 #include "sequence/Double.h"
+#include "sequence/Mix.h"
 #include "sequence/PingPong.h"
-#include "sequence/Superpose.h"
 
 #include <cstring>
 #include <structmember.h>
@@ -385,6 +387,31 @@ Sound_cache(Sound* self)
 	return (PyObject *)parent;
 }
 
+PyDoc_STRVAR(M_aud_Sound_cacheAsync_doc,
+			 "cacheAsync(priority=LOAD_PRIORITY_NORMAL)\n\n"
+			 "Caches a sound into RAM in the background, see :meth:`cache`.\n\n"
+			 ":arg priority: The priority of the load, one of the "
+			 "LOAD_PRIORITY_* constants.\n"
+			 ":type priority: int\n"
+			 ":return: The request to poll or wait for.\n"
+			 ":rtype: :class:`LoadRequest`");
+
+static PyObject *
+Sound_cacheAsync(Sound* self, PyObject* args)
+{
+	int priority = LOAD_PRIORITY_NORMAL;
+
+	if(!PyArg_ParseTuple(args, "|i:cacheAsync", &priority))
+		return nullptr;
+
+	LoadRequestP* request = (LoadRequestP*)LoadRequest_empty();
+
+	if(request != nullptr)
+		request->request = new std::shared_ptr<LoadRequest>(AsyncLoader::cacheAsync(*reinterpret_cast<std::shared_ptr<ISound>*>(self->sound), static_cast<LoadPriority>(priority)));
+
+	return (PyObject *)request;
+}
+
 PyDoc_STRVAR(M_aud_Sound_file_doc,
 			 "file(filename)\n\n"
 			 "Creates a sound object of a sound file.\n\n"
@@ -424,6 +451,35 @@ Sound_file(PyTypeObject* type, PyObject* args)
 	return (PyObject *)self;
 }
 
+PyDoc_STRVAR(M_aud_Sound_loadAsync_doc,
+			 "loadAsync(filename, priority=LOAD_PRIORITY_NORMAL)\n\n"
+			 "Opens a sound file in the background and checks that it can be "
+			 "read.\n\n"
+			 ":arg filename: Path of the file.\n"
+			 ":type filename: string\n"
+			 ":arg priority: The priority of the load, one of the "
+			 "LOAD_PRIORITY_* constants.\n"
+			 ":type priority: int\n"
+			 ":return: The request to poll or wait for.\n"
+			 ":rtype: :class:`LoadRequest`");
+
+static PyObject *
+Sound_loadAsync(PyTypeObject* type, PyObject* args)
+{
+	const char* filename = nullptr;
+	int priority = LOAD_PRIORITY_NORMAL;
+
+	if(!PyArg_ParseTuple(args, "s|i:loadAsync", &filename, &priority))
+		return nullptr;
+
+	LoadRequestP* request = (LoadRequestP*)LoadRequest_empty();
+
+	if(request != nullptr)
+		request->request = new std::shared_ptr<LoadRequest>(AsyncLoader::loadAsync(filename, static_cast<LoadPriority>(priority)));
+
+	return (PyObject *)request;
+}
+
 PyDoc_STRVAR(M_aud_Sound_sawtooth_doc,
 			 "sawtooth(frequency, rate=48000)\n\n"
 			 "Creates a sawtooth sound which plays a sawtooth wave.\n\n"
@@ -1449,6 +1505,7 @@ Sound_join(Sound* self, PyObject* object)
 PyDoc_STRVAR(M_aud_Sound_mix_doc,
 			 "mix(sound)\n\n"
 			 "Mixes two factories.\n\n"
+			 "Chained mixing of sounds results in a single flat mix.\n\n"
 			 ":arg sound: The sound to mix over the other.\n"
 			 ":type sound: :class:`Sound`\n"
 			 ":return: The created :class:`Sound` object.\n"
@@ -1474,7 +1531,7 @@ Sound_mix(Sound* self, PyObject* object)
 	{
 		try
 		{
-			parent->sound = new std::shared_ptr<ISound>(new Superpose(*reinterpret_cast<std::shared_ptr<ISound>*>(self->sound), *reinterpret_cast<std::shared_ptr<ISound>*>(child->sound)));
+			parent->sound = new std::shared_ptr<ISound>(new Mix(*reinterpret_cast<std::shared_ptr<ISound>*>(self->sound), *reinterpret_cast<std::shared_ptr<ISound>*>(child->sound)));
 		}
 		catch(Exception& e)
 		{
@@ -1732,9 +1789,15 @@ static PyMethodDef Sound_methods[] = {
 	{"cache", (PyCFunction)Sound_cache, METH_NOARGS,
 	 M_aud_Sound_cache_doc
 	},
+	{"cacheAsync", (PyCFunction)Sound_cacheAsync, METH_VARARGS,
+	 M_aud_Sound_cacheAsync_doc
+	},
 	{"file", (PyCFunction)Sound_file, METH_VARARGS | METH_CLASS,
 	 M_aud_Sound_file_doc
 	},
+	{"loadAsync", (PyCFunction)Sound_loadAsync, METH_VARARGS | METH_CLASS,
+	 M_aud_Sound_loadAsync_doc
+	},
 	{"sawtooth", (PyCFunction)Sound_sawtooth, METH_VARARGS | METH_CLASS,
 	 M_aud_Sound_sawtooth_doc
 	},
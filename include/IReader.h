@@ -87,6 +87,25 @@ public:
 	 * \param[in] buffer The pointer to the buffer to read into.
 	 */
 	virtual void read(int& length, bool& eos, sample_t* buffer)=0;
+
+	/**
+	 * Tells whether the samples returned by the last read call are silent.
+	 * This is an optional hint which allows readers and devices to skip the
+	 * processing of silent blocks, the buffer still has to be filled with
+	 * zeros by the read call in any case.
+	 * \return Whether all samples of the last read are known to be zero.
+	 *         Readers that don't track silence always return false.
+	 */
+	virtual bool isSilent() const { return false; }
+
+	/**
+	 * Tells whether seeking is sample accurate and the samples read after
+	 * seeking are exactly the ones read when reading from the start.
+	 * Readers with state that is lost on seeking, like filters, or whose
+	 * seeking may be off by some samples must return false.
+	 * \return Whether seeking is sample accurate, false if unknown.
+	 */
+	virtual bool isSeekAccurate() const { return false; }
 };
 
 AUD_NAMESPACE_END
@@ -37,6 +37,11 @@ private:
 	 */
 	bool m_playing;
 
+	/**
+	 * Whether the last read was silent.
+	 */
+	bool m_silent;
+
 	// delete copy constructor and operator=
 	ReadDevice(const ReadDevice&) = delete;
 	ReadDevice& operator=(const ReadDevice&) = delete;
@@ -72,6 +77,12 @@ public:
 	 */
 	bool read(data_t* buffer, int length);
 
+	/**
+	 * Tells whether the samples returned by the last read are silent.
+	 * \return Whether nothing but silence has been mixed in the last read.
+	 */
+	bool isSilent() const;
+
 	/**
 	 * Changes the output specification.
 	 * \param specs The new audio data specification.
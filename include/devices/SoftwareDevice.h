@@ -87,6 +87,9 @@ protected:
 		/// The calculated final volume of the source.
 		float m_volume;
 
+		/// Per sample volumes applied in addition for the next mixed block, nullptr if there are none.
+		const float* m_envelope;
+
 		/// The loop count of the source.
 		int m_loopcount;
 
@@ -243,8 +246,10 @@ protected:
 	 * Mixes the next samples into the buffer.
 	 * \param buffer The target buffer.
 	 * \param length The length in samples to be filled.
+	 * \return Whether the mixed samples are silent, because there were no
+	 *         sounds playing back or all of them reported silence.
 	 */
-	void mix(data_t* buffer, int length);
+	bool mix(data_t* buffer, int length);
 
 	/**
 	 * This function tells the device, to start or pause playback.
@@ -323,6 +328,15 @@ private:
 	SoftwareDevice(const SoftwareDevice&) = delete;
 	SoftwareDevice& operator=(const SoftwareDevice&) = delete;
 
+	/**
+	 * Mixes the samples read from a sound with its volume and envelope.
+	 * \param sound The sound the samples were read from.
+	 * \param buffer The samples.
+	 * \param start The start sample of the samples in the block.
+	 * \param length The count of samples.
+	 */
+	AUD_LOCAL void mixSound(SoftwareHandle* sound, sample_t* buffer, int start, int length);
+
 public:
 
 	/**
@@ -332,6 +346,15 @@ public:
 	 */
 	static void setPanning(IHandle* handle, float pan);
 
+	/**
+	 * Sets a volume envelope for the next block the handle is mixed into.
+	 * \param handle The handle to set the envelope for.
+	 * \param envelope One volume per sample of the block, applied in addition
+	 *        to the handle's volume. It has to stay valid until the block is
+	 *        mixed and is only used once.
+	 */
+	static void setVolumeEnvelope(IHandle* handle, const float* envelope);
+
 	/**
 	 * Sets the resampling quality.
 	 * \param quality Low (false) or high (true) quality.
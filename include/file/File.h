@@ -34,6 +34,8 @@ class Buffer;
 /**
  * The File sound tries to read a sound file via all available file inputs
  * that have been registered in the FileManager class.
+ * If the PageCache is enabled, files are read through the cache so that
+ * multiple readers of the same file share the decoded data.
  */
 class AUD_API File : public ISound
 {
@@ -68,6 +70,13 @@ public:
 	 */
 	File(const data_t* buffer, int size);
 
+	/**
+	 * Creates a new sound.
+	 * The file is read from memory using the supplied buffer without copying it.
+	 * \param buffer The buffer containing the file data.
+	 */
+	File(std::shared_ptr<Buffer> buffer);
+
 	virtual std::shared_ptr<IReader> createReader();
 };
 
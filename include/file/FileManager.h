@@ -27,6 +27,7 @@
 
 #include <list>
 #include <memory>
+#include <string>
 
 AUD_NAMESPACE_BEGIN
 
@@ -37,6 +38,11 @@ class Buffer;
 
 /**
  * The FileManager manages all file input and output plugins.
+ *
+ * To open a file, its first bytes and extension are probed by all file
+ * inputs and only those that may read the file are tried, the ones that
+ * recognize it first. The file input that opened a file is remembered in a
+ * small cache, so opening the same unchanged file again skips probing.
  */
 class AUD_API FileManager
 {
@@ -44,6 +50,28 @@ private:
 	static std::list<std::shared_ptr<IFileInput>>& inputs();
 	static std::list<std::shared_ptr<IFileOutput>>& outputs();
 
+	/**
+	 * Returns a copy of the registered file inputs.
+	 * Inputs are iterated over a copy, as they can unregister while in use.
+	 * \return The file inputs.
+	 */
+	AUD_LOCAL static std::list<std::shared_ptr<IFileInput>> getInputs();
+
+	/**
+	 * Returns a copy of the registered file outputs.
+	 * \return The file outputs.
+	 */
+	AUD_LOCAL static std::list<std::shared_ptr<IFileOutput>> getOutputs();
+
+	/**
+	 * Returns the file inputs that may read a file, ordered by the probe results.
+	 * \param header The first bytes of the file.
+	 * \param size The amount of bytes in header.
+	 * \param extension The lower case file extension.
+	 * \return The file inputs to try.
+	 */
+	AUD_LOCAL static std::list<std::shared_ptr<IFileInput>> probe(const unsigned char* header, int size, const std::string& extension);
+
 	// delete copy constructor and operator=
 	FileManager(const FileManager&) = delete;
 	FileManager& operator=(const FileManager&) = delete;
@@ -62,6 +90,18 @@ public:
 	 */
 	static void registerOutput(std::shared_ptr<IFileOutput> output);
 
+	/**
+	 * Unregisters a file input.
+	 * @param input The IFileInput to unregister.
+	 */
+	static void unregisterInput(std::shared_ptr<IFileInput> input);
+
+	/**
+	 * Unregisters a file output.
+	 * @param output The IFileOutput to unregister.
+	 */
+	static void unregisterOutput(std::shared_ptr<IFileOutput> output);
+
 	/**
 	 * Creates a file reader for the given filename if a registed IFileInput is able to read it.
 	 * @param filename The path to the file.
@@ -90,6 +130,66 @@ public:
 	 * @exception Exception If no file output can write the file with the given specification an exception is thrown.
 	 */
 	static std::shared_ptr<IWriter> createWriter(std::string filename, DeviceSpecs specs, Container format, Codec codec, unsigned int bitrate);
+
+	/**
+	 * Sets the maximum number of files whose file input is remembered.
+	 * @param size The number of cached files, 0 disables the cache.
+	 */
+	static void setProbeCacheSize(unsigned int size);
+
+	/**
+	 * Returns the maximum number of files whose file input is remembered.
+	 * @return The number of cached files, default is 256.
+	 */
+	static unsigned int getProbeCacheSize();
+
+	/**
+	 * Forgets the file inputs remembered for all files.
+	 */
+	static void clearProbeCache();
+
+	/**
+	 * Sets the read-ahead window for newly created file readers.
+	 * File inputs that support it decode this many samples in advance on a
+	 * background thread, so that reading doesn't wait for the decoder.
+	 * @param length The amount of samples to decode in advance or 0 to decode
+	 *        synchronously, which is the default.
+	 */
+	static void setReadAhead(int length);
+
+	/**
+	 * Returns the read-ahead window for newly created file readers.
+	 * @return The amount of samples decoded in advance, 0 if synchronous.
+	 */
+	static int getReadAhead();
+
+	/**
+	 * Enables or disables seek indices for newly opened files.
+	 * File inputs that support it index the packets of a file on a background
+	 * thread, so that seeking is sample accurate and cheap.
+	 * @param enabled Whether files should be indexed, disabled by default.
+	 */
+	static void setSeekIndexing(bool enabled);
+
+	/**
+	 * Returns whether seek indices are enabled.
+	 * @return Whether files are indexed.
+	 */
+	static bool isSeekIndexing();
+
+	/**
+	 * Sets the directory that completed seek indices are stored in and
+	 * loaded from, so that each file only has to be indexed once.
+	 * @param directory The directory or an empty string to disable
+	 *        persistence, which is the default.
+	 */
+	static void setSeekIndexDirectory(std::string directory);
+
+	/**
+	 * Returns the directory that seek indices are stored in.
+	 * @return The directory or an empty string if persistence is disabled.
+	 */
+	static std::string getSeekIndexDirectory();
 };
 
 AUD_NAMESPACE_END
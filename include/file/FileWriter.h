@@ -25,6 +25,7 @@
 #include "respec/Specification.h"
 #include "file/IWriter.h"
 
+#include <functional>
 #include <string>
 #include <vector>
 #include <memory>
@@ -35,6 +36,10 @@ class IReader;
 
 /**
  * The FileWriter class is able to create IWriter classes as well as write readers to them.
+ *
+ * Writing is pipelined: the reader is rendered on the calling thread while
+ * the data is encoded and written on another thread, connected by a bounded
+ * lock-free ring buffer that lets rendering run a few buffers ahead.
  */
 class AUD_API FileWriter
 {
@@ -44,6 +49,17 @@ private:
 	FileWriter(const FileWriter&) = delete;
 	FileWriter& operator=(const FileWriter&) = delete;
 
+	/**
+	 * Renders a reader on the calling thread and encodes it on another one.
+	 * \param reader The reader to read from.
+	 * \param channels The channel count of the reader.
+	 * \param length How many samples should be transferred.
+	 * \param buffersize How many samples should be transferred at once.
+	 * \param encode Called on the encoding thread with clamped samples.
+	 * \exception Exception Thrown if rendering or encoding failed.
+	 */
+	AUD_LOCAL static void pipeline(std::shared_ptr<IReader> reader, int channels, unsigned int length, unsigned int buffersize, std::function<void(sample_t* buffer, int length)> encode);
+
 public:
 	/**
 	 * Creates a new IWriter.
@@ -67,6 +83,9 @@ public:
 
 	/**
 	 * Writes a reader to several writers.
+	 *
+	 * Each channel of the reader is written to its own writer, the writers
+	 * encode their blocks in parallel but each of them in order.
 	 * \param reader The reader to read from.
 	 * \param writers The writers to write to.
 	 * \param length How many samples should be transferred.
@@ -32,6 +32,14 @@ AUD_NAMESPACE_BEGIN
 class IReader;
 class Buffer;
 
+/// Result of checking whether a file input can read a file.
+enum ProbeResult
+{
+	PROBE_UNSUPPORTED = 0,	/// The file can't be read.
+	PROBE_UNKNOWN,			/// The file may be readable, opening it has to be tried.
+	PROBE_SUPPORTED			/// The file format has been recognized.
+};
+
 /**
  * @interface IFileInput
  * The IFileInput interface represents a file input plugin that can create file
@@ -55,6 +63,22 @@ public:
 	 * \exception Exception Thrown if the file specified cannot be read.
 	 */
 	virtual std::shared_ptr<IReader> createReader(std::shared_ptr<Buffer> buffer)=0;
+
+	/**
+	 * Checks whether a file can be read from its first bytes and extension,
+	 * so that the FileManager can choose a file input without opening the
+	 * file with every one of them.
+	 * \param header The first bytes of the file.
+	 * \param size The amount of bytes in header, which might be less than
+	 *        requested for short files.
+	 * \param extension The lower case file extension without the dot, empty
+	 *        for buffers or files without extension.
+	 * \return The result, PROBE_UNKNOWN unless the file input overrides this.
+	 */
+	virtual ProbeResult probe(const unsigned char* /*header*/, int /*size*/, const std::string& /*extension*/)
+	{
+		return PROBE_UNKNOWN;
+	}
 };
 
 AUD_NAMESPACE_END
@@ -0,0 +1,61 @@
+/*******************************************************************************
+ * Copyright 2009-2016 Jörg Müller
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ ******************************************************************************/
+
+#pragma once
+
+/**
+ * @file PCMFile.h
+ * @ingroup file
+ * The PCMFile class.
+ */
+
+#include "file/IFileInput.h"
+#include "file/IFileOutput.h"
+
+AUD_NAMESPACE_BEGIN
+
+/**
+ * This built-in file input and output handles uncompressed PCM WAV, RF64 and
+ * AIFF files without any external library.
+ * Files are memory mapped and the samples are converted directly from the
+ * mapped pages, which makes opening and seeking practically free.
+ * Anything else is rejected so that the FileManager falls back to the plugins.
+ */
+class AUD_API PCMFile : public IFileInput, public IFileOutput
+{
+private:
+	// delete copy constructor and operator=
+	PCMFile(const PCMFile&) = delete;
+	PCMFile& operator=(const PCMFile&) = delete;
+
+public:
+	/**
+	 * Creates a new PCM file input and output.
+	 */
+	PCMFile();
+
+	/**
+	 * Registers this file input and output.
+	 */
+	static void registerPlugin();
+
+	virtual std::shared_ptr<IReader> createReader(std::string filename);
+	virtual std::shared_ptr<IReader> createReader(std::shared_ptr<Buffer> buffer);
+	virtual ProbeResult probe(const unsigned char* header, int size, const std::string& extension);
+	virtual std::shared_ptr<IWriter> createWriter(std::string filename, DeviceSpecs specs, Container format, Codec codec, unsigned int bitrate);
+};
+
+AUD_NAMESPACE_END
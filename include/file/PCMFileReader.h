@@ -0,0 +1,123 @@
+/*******************************************************************************
+ * Copyright 2009-2016 Jörg Müller
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ ******************************************************************************/
+
+#pragma once
+
+/**
+ * @file PCMFileReader.h
+ * @ingroup file
+ * The PCMFileReader class.
+ */
+
+#include "IReader.h"
+#include "respec/ConverterFunctions.h"
+
+#include <string>
+#include <memory>
+
+AUD_NAMESPACE_BEGIN
+
+class Buffer;
+class MappedFile;
+
+/**
+ * This class reads uncompressed PCM WAV, RF64 and AIFF/AIFC files.
+ * The file is memory mapped and the samples are converted straight from the
+ * mapped data into the read buffer; float data in native byte order is
+ * copied without any conversion. Seeking is a simple position update.
+ */
+class AUD_API PCMFileReader : public IReader
+{
+private:
+	/**
+	 * The current position in samples.
+	 */
+	int m_position;
+
+	/**
+	 * The sample count in the file.
+	 */
+	int m_length;
+
+	/**
+	 * The specification of the audio data.
+	 */
+	Specs m_specs;
+
+	/**
+	 * The size of one frame of the stored data in bytes.
+	 */
+	int m_frame_size;
+
+	/**
+	 * The conversion function from the stored format to float.
+	 */
+	convert_f m_convert;
+
+	/**
+	 * The start of the sample data.
+	 */
+	const data_t* m_data;
+
+	/**
+	 * The memory mapped file.
+	 */
+	std::shared_ptr<MappedFile> m_file;
+
+	/**
+	 * The pointer to the memory file.
+	 */
+	std::shared_ptr<Buffer> m_membuffer;
+
+	/**
+	 * Parses the file header and sets up the reader.
+	 * \param data The file contents.
+	 * \param size The size of the file contents in bytes.
+	 * \exception FileException Thrown if the data is no supported PCM file.
+	 */
+	AUD_LOCAL void parse(const data_t* data, size_t size);
+
+	// delete copy constructor and operator=
+	PCMFileReader(const PCMFileReader&) = delete;
+	PCMFileReader& operator=(const PCMFileReader&) = delete;
+
+public:
+	/**
+	 * Creates a new reader.
+	 * \param filename The path to the file to be read.
+	 * \exception FileException Thrown if the file specified does not exist or
+	 *            is no uncompressed PCM WAV, RF64 or AIFF file.
+	 */
+	PCMFileReader(std::string filename);
+
+	/**
+	 * Creates a new reader.
+	 * \param buffer The buffer to read from.
+	 * \exception FileException Thrown if the buffer doesn't contain an
+	 *            uncompressed PCM WAV, RF64 or AIFF file.
+	 */
+	PCMFileReader(std::shared_ptr<Buffer> buffer);
+
+	virtual bool isSeekable() const;
+	virtual void seek(int position);
+	virtual int getLength() const;
+	virtual int getPosition() const;
+	virtual Specs getSpecs() const;
+	virtual void read(int& length, bool& eos, sample_t* buffer);
+	virtual bool isSeekAccurate() const;
+};
+
+AUD_NAMESPACE_END
@@ -0,0 +1,96 @@
+/*******************************************************************************
+ * Copyright 2009-2016 Jörg Müller
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ ******************************************************************************/
+
+#pragma once
+
+/**
+ * @file PCMFileWriter.h
+ * @ingroup file
+ * The PCMFileWriter class.
+ */
+
+#include "file/IWriter.h"
+#include "respec/ConverterFunctions.h"
+#include "util/Buffer.h"
+
+#include <string>
+#include <cstdio>
+
+AUD_NAMESPACE_BEGIN
+
+/**
+ * This class writes uncompressed PCM WAV files.
+ * Files that grow beyond the 4 GB limit of RIFF are turned into RF64 files
+ * when the writer is closed.
+ */
+class AUD_API PCMFileWriter : public IWriter
+{
+private:
+	/**
+	 * The current position in samples.
+	 */
+	int m_position;
+
+	/**
+	 * The specification of the audio data.
+	 */
+	DeviceSpecs m_specs;
+
+	/**
+	 * The file being written.
+	 */
+	std::FILE* m_file;
+
+	/**
+	 * The conversion function from float to the output format.
+	 */
+	convert_f m_convert;
+
+	/**
+	 * The conversion buffer.
+	 */
+	Buffer m_buffer;
+
+	/**
+	 * Writes the file header for the amount of data written so far.
+	 */
+	AUD_LOCAL void writeHeader();
+
+	// delete copy constructor and operator=
+	PCMFileWriter(const PCMFileWriter&) = delete;
+	PCMFileWriter& operator=(const PCMFileWriter&) = delete;
+
+public:
+	/**
+	 * Creates a new writer.
+	 * \param filename The path to the file to be written.
+	 * \param specs The file's audio specification.
+	 * \exception FileException Thrown if the format is unsupported or the file
+	 *            cannot be written.
+	 */
+	PCMFileWriter(std::string filename, DeviceSpecs specs);
+
+	/**
+	 * Destroys the writer and closes the file.
+	 */
+	virtual ~PCMFileWriter();
+
+	virtual int getPosition() const;
+	virtual DeviceSpecs getSpecs() const;
+	virtual void write(unsigned int length, sample_t* buffer);
+};
+
+AUD_NAMESPACE_END
@@ -72,6 +72,17 @@ private:
 	 */
 	int m_channel;
 
+	/**
+	 * Whether the last read was silent.
+	 */
+	bool m_silent;
+
+	/**
+	 * Checks whether the filter state has decayed to silence.
+	 * \return Whether all past input and output samples are negligible.
+	 */
+	AUD_LOCAL bool isStateSilent() const;
+
 	// delete copy constructor and operator=
 	BaseIIRFilterReader(const BaseIIRFilterReader&) = delete;
 	BaseIIRFilterReader& operator=(const BaseIIRFilterReader&) = delete;
@@ -92,6 +103,13 @@ protected:
 	 */
 	void setLengths(int in, int out);
 
+	/**
+	 * Tells whether the filter outputs silence for silent input once its
+	 * state has decayed, which allows to skip filtering silent blocks.
+	 * \return Whether zero input and state result in zero output.
+	 */
+	virtual bool preservesSilence() const;
+
 public:
 	/**
 	 * Retrieves the last input samples.
@@ -116,6 +134,7 @@ public:
 	virtual ~BaseIIRFilterReader();
 
 	virtual void read(int& length, bool& eos, sample_t* buffer);
+	virtual bool isSilent() const;
 
 	/**
 	 * Runs the filtering function.
@@ -42,6 +42,11 @@ private:
 	 */
 	int m_remdelay;
 
+	/**
+	 * Whether the last read was silent.
+	 */
+	bool m_silent;
+
 	// delete copy constructor and operator=
 	DelayReader(const DelayReader&) = delete;
 	DelayReader& operator=(const DelayReader&) = delete;
@@ -58,6 +63,7 @@ public:
 	virtual int getLength() const;
 	virtual int getPosition() const;
 	virtual void read(int& length, bool& eos, sample_t* buffer);
+	virtual bool isSilent() const;
 };
 
 AUD_NAMESPACE_END
@@ -56,6 +56,11 @@ private:
 	 */
 	const float m_length;
 
+	/**
+	 * Whether the last read was silent.
+	 */
+	bool m_silent;
+
 	// delete copy constructor and operator=
 	FaderReader(const FaderReader&) = delete;
 	FaderReader& operator=(const FaderReader&) = delete;
@@ -72,6 +77,7 @@ public:
 					float start,float length);
 
 	virtual void read(int& length, bool& eos, sample_t* buffer);
+	virtual bool isSilent() const;
 };
 
 AUD_NAMESPACE_END
@@ -48,6 +48,9 @@ private:
 	IIRFilterReader(const IIRFilterReader&) = delete;
 	IIRFilterReader& operator=(const IIRFilterReader&) = delete;
 
+protected:
+	virtual bool preservesSilence() const;
+
 public:
 	/**
 	 * Creates a new IIR filter reader.
@@ -60,6 +60,7 @@ public:
 	virtual int getLength() const;
 	virtual int getPosition() const;
 	virtual void read(int& length, bool& eos, sample_t* buffer);
+	virtual bool isSeekAccurate() const;
 };
 
 AUD_NAMESPACE_END
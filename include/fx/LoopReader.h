@@ -43,6 +43,11 @@ private:
 	 */
 	int m_left;
 
+	/**
+	 * Whether the last read was silent.
+	 */
+	bool m_silent;
+
 	// delete copy constructor and operator=
 	LoopReader(const LoopReader&) = delete;
 	LoopReader& operator=(const LoopReader&) = delete;
@@ -60,6 +65,7 @@ public:
 	virtual int getLength() const;
 	virtual int getPosition() const;
 	virtual void read(int& length, bool& eos, sample_t* buffer);
+	virtual bool isSilent() const;
 };
 
 AUD_NAMESPACE_END
@@ -0,0 +1,100 @@
+/*******************************************************************************
+ * Copyright 2009-2016 Jörg Müller
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ ******************************************************************************/
+
+#pragma once
+
+/**
+ * @file LazyPlugin.h
+ * @ingroup plugin
+ * The LazyPlugin class.
+ */
+
+#include "Audaspace.h"
+
+#include <mutex>
+#include <string>
+
+AUD_NAMESPACE_BEGIN
+
+/**
+ * This class represents a plugin library listed in a plugin manifest that is
+ * only loaded when it is first needed.
+ *
+ * The manifest (plugins.manifest in the plugin directory) lists the devices
+ * and file extensions of every plugin, which are registered as lightweight
+ * stubs. A stub loads its library when a device is opened or a file is read
+ * or written with it, after which the plugin registers itself as usual.
+ *
+ * Each line of the manifest is either
+ *  - "file <library> <extension>..." for file input and output plugins or
+ *  - "device <library> <priority> <name>" for device plugins.
+ * Empty lines and lines starting with # are ignored.
+ */
+class AUD_API LazyPlugin
+{
+private:
+	/**
+	 * The path to the plugin library.
+	 */
+	std::string m_path;
+
+	/**
+	 * Whether loading has been attempted.
+	 */
+	bool m_loaded;
+
+	/**
+	 * Whether the library could be loaded.
+	 */
+	bool m_valid;
+
+	/**
+	 * Mutex for loading, shared by all lazy plugins.
+	 */
+	static std::mutex& mutex();
+
+	// delete copy constructor and operator=
+	LazyPlugin(const LazyPlugin&) = delete;
+	LazyPlugin& operator=(const LazyPlugin&) = delete;
+
+public:
+	/**
+	 * Creates a plugin that isn't loaded yet.
+	 * \param path The path to the plugin library.
+	 */
+	LazyPlugin(std::string path);
+
+	/**
+	 * Loads the plugin library if that hasn't been attempted yet.
+	 * \return Whether the plugin is loaded.
+	 */
+	bool load();
+
+	/**
+	 * Returns the path of the plugin library.
+	 * \return The path.
+	 */
+	std::string getPath() const;
+
+	/**
+	 * Registers stubs for all plugins listed in the manifest of a directory.
+	 * \param directory The plugin directory.
+	 * \return Whether the directory contains a manifest.
+	 */
+	static bool loadManifest(const std::string& directory);
+};
+
+AUD_NAMESPACE_END
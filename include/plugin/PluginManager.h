@@ -36,6 +36,7 @@ class AUD_API PluginManager
 {
 private:
 	static std::unordered_map<std::string, void*> m_plugins;
+	static bool m_lazy;
 
 	// delete copy constructor and operator=
 	PluginManager(const PluginManager&) = delete;
@@ -52,9 +53,24 @@ public:
 
 	/**
 	 * Loads all plugins found in a folder.
+	 * If the folder contains a plugin manifest and lazy loading is enabled,
+	 * only stubs are registered and the plugins are loaded on first use,
+	 * see LazyPlugin.
 	 * @param path The path to the folder containing the plugins.
 	 */
 	static void loadPlugins(const std::string& path = "");
+
+	/**
+	 * Sets whether plugins listed in a manifest are loaded on first use.
+	 * @param lazy Whether to load plugins lazily, default is true.
+	 */
+	static void setLazyLoading(bool lazy);
+
+	/**
+	 * Returns whether plugins listed in a manifest are loaded on first use.
+	 * @return Whether plugins are loaded lazily.
+	 */
+	static bool isLazyLoading();
 };
 
 AUD_NAMESPACE_END
@@ -146,6 +146,7 @@ public:
 
 	virtual Specs getSpecs() const;
 	virtual void read(int& length, bool& eos, sample_t* buffer);
+	virtual bool isSeekAccurate() const;
 };
 
 AUD_NAMESPACE_END
@@ -62,6 +62,8 @@ public:
 	ConverterReader(std::shared_ptr<IReader> reader, DeviceSpecs specs);
 
 	virtual void read(int& length, bool& eos, sample_t* buffer);
+	virtual bool isSilent() const;
+	virtual bool isSeekAccurate() const;
 };
 
 AUD_NAMESPACE_END
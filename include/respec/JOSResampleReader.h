@@ -90,6 +90,16 @@ private:
 	 */
 	double m_last_factor;
 
+	/**
+	 * How many samples at the end of the cache are known to be silent.
+	 */
+	int m_silent_samples;
+
+	/**
+	 * Whether the last read was silent.
+	 */
+	bool m_silent;
+
 	// delete copy constructor and operator=
 	JOSResampleReader(const JOSResampleReader&) = delete;
 	JOSResampleReader& operator=(const JOSResampleReader&) = delete;
@@ -107,6 +117,12 @@ private:
 	 */
 	void AUD_LOCAL updateBuffer(int size, double factor, int samplesize);
 
+	/**
+	 * Updates the amount of silent samples at the end of the cache.
+	 * \param length The amount of samples just read into the cache.
+	 */
+	void AUD_LOCAL updateSilence(int length);
+
 	void AUD_LOCAL resample(double target_factor, int length, sample_t* buffer);
 	void AUD_LOCAL resample_mono(double target_factor, int length, sample_t* buffer);
 	void AUD_LOCAL resample_stereo(double target_factor, int length, sample_t* buffer);
@@ -124,6 +140,7 @@ public:
 	virtual int getPosition() const;
 	virtual Specs getSpecs() const;
 	virtual void read(int& length, bool& eos, sample_t* buffer);
+	virtual bool isSilent() const;
 };
 
 AUD_NAMESPACE_END
@@ -58,6 +58,11 @@ private:
 	 */
 	bool m_cache_ok;
 
+	/**
+	 * Whether the last read was silent.
+	 */
+	bool m_silent;
+
 	// delete copy constructor and operator=
 	LinearResampleReader(const LinearResampleReader&) = delete;
 	LinearResampleReader& operator=(const LinearResampleReader&) = delete;
@@ -75,6 +80,7 @@ public:
 	virtual int getPosition() const;
 	virtual Specs getSpecs() const;
 	virtual void read(int& length, bool& eos, sample_t* buffer);
+	virtual bool isSilent() const;
 };
 
 AUD_NAMESPACE_END
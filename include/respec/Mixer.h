@@ -96,6 +96,16 @@ public:
 	 */
 	void mix(sample_t* buffer, int start, int length, float volume);
 
+	/**
+	 * Mixes a buffer with a volume envelope.
+	 * \param buffer The buffer to superpose.
+	 * \param start The start sample of the buffer.
+	 * \param length The length of the buffer in samples.
+	 * \param volume The mixing volume. Must be a value between 0.0 and 1.0.
+	 * \param envelope A volume per sample the samples are additionally multiplied with.
+	 */
+	void mix(sample_t* buffer, int start, int length, float volume, const float* envelope);
+
 	/**
 	 * Writes the mixing buffer into an output buffer.
 	 * \param buffer The target buffer for superposing.
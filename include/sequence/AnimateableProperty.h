@@ -25,8 +25,11 @@
 #include "util/Buffer.h"
 #include "util/ILockable.h"
 
-#include <mutex>
+#include <atomic>
 #include <list>
+#include <memory>
+#include <mutex>
+#include <vector>
 
 AUD_NAMESPACE_BEGIN
 
@@ -42,9 +45,16 @@ enum AnimateablePropertyType
 
 /**
  * This class saves animation data for float properties.
+ *
+ * Reading doesn't lock: readers use an immutable snapshot of the data with
+ * precomputed interpolation coefficients, which is replaced after writes.
+ * Snapshots consist of chunks of frames and only the chunks around written
+ * frames are rebuilt, the others are shared with the previous snapshot.
  */
 class AUD_API AnimateableProperty : private Buffer
 {
+	friend class SequenceData;
+	friend class SequenceEntry;
 private:
 	struct Unknown {
 		int start;
@@ -54,6 +64,32 @@ private:
 			start(start), end(end) {}
 	};
 
+	/// The frames of a snapshot chunk.
+	static const int CHUNK_LENGTH = 256;
+
+	/// An immutable part of a snapshot with CHUNK_LENGTH frames.
+	struct Chunk
+	{
+		/// The values of the frames.
+		std::vector<float> values;
+
+		/// The four cubic coefficients of every value for interpolating to the next frame.
+		std::vector<float> coefficients;
+	};
+
+	/// An immutable version of the animation data for reading.
+	struct Snapshot
+	{
+		/// Whether the property is animated.
+		bool animated;
+
+		/// The index of the last frame.
+		int last;
+
+		/// The chunks of all frames, unchanged ones are shared between snapshots.
+		std::vector<std::shared_ptr<const Chunk> > chunks;
+	};
+
 	/// The count of floats for a single property.
 	const int m_count;
 
@@ -66,12 +102,68 @@ private:
 	/// The list of unknown buffer areas.
 	std::list<Unknown> m_unknown;
 
+	/// The current snapshot for reading, only accessed atomically.
+	std::shared_ptr<const Snapshot> m_snapshot;
+
+	/// Whether the snapshot is outdated.
+	std::atomic<bool> m_changed;
+
+	/// The first frame written since the last snapshot.
+	int m_changed_start;
+
+	/// The last frame written since the last snapshot.
+	int m_changed_end;
+
+	/// The edit counter of the sequence the property belongs to, may be nullptr.
+	std::shared_ptr<std::atomic<int> > m_edit_status;
+
 	// delete copy constructor and operator=
 	AnimateableProperty(const AnimateableProperty&) = delete;
 	AnimateableProperty& operator=(const AnimateableProperty&) = delete;
 
 	void AUD_LOCAL updateUnknownCache(int start, int end);
 
+	/**
+	 * Sets the edit counter that is incremented with every write.
+	 * \param status The edit counter of the sequence.
+	 */
+	AUD_LOCAL void setEditStatus(std::shared_ptr<std::atomic<int> > status);
+
+	/**
+	 * Marks frames as written, the mutex has to be locked.
+	 * \param start The first written frame.
+	 * \param end The last written frame.
+	 */
+	AUD_LOCAL void markChanged(int start, int end);
+
+	/**
+	 * Builds a chunk of a snapshot from the animation data.
+	 * \param index The index of the chunk.
+	 * \param last The index of the last frame.
+	 * \return The chunk.
+	 */
+	AUD_LOCAL std::shared_ptr<const Chunk> buildChunk(int index, int last) const;
+
+	/**
+	 * Builds and publishes a new snapshot, the mutex has to be locked.
+	 */
+	AUD_LOCAL void updateSnapshot();
+
+	/**
+	 * Retrieves the current snapshot, updating it if it is outdated.
+	 * \return The snapshot.
+	 */
+	AUD_LOCAL std::shared_ptr<const Snapshot> getSnapshot();
+
+	/**
+	 * Evaluates a snapshot at a position.
+	 * \param snapshot The snapshot to evaluate.
+	 * \param count The count of floats for a single property.
+	 * \param position The position in the animation in frames.
+	 * \param[out] out Where to write the value to.
+	 */
+	AUD_LOCAL static void evaluate(const Snapshot& snapshot, int count, float position, float* out);
+
 public:
 	/**
 	 * Creates a new animateable property.
@@ -119,6 +211,15 @@ public:
 	 */
 	void read(float position, float* out);
 
+	/**
+	 * Reads the properties value at evenly spaced positions.
+	 * \param position The first position in the animation in frames.
+	 * \param step The distance between two positions in frames.
+	 * \param count The count of positions to read.
+	 * \param[out] out Where to write the values to, getCount() floats per position.
+	 */
+	void read(float position, float step, int count, float* out);
+
 	/**
 	 * Returns whether the property is animated.
 	 * \return Whether the property is animated.
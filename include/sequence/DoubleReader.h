@@ -49,6 +49,11 @@ private:
 	 */
 	bool m_finished1;
 
+	/**
+	 * Whether the last read was silent.
+	 */
+	bool m_silent;
+
 	// delete copy constructor and operator=
 	DoubleReader(const DoubleReader&) = delete;
 	DoubleReader& operator=(const DoubleReader&) = delete;
@@ -72,6 +77,7 @@ public:
 	virtual int getPosition() const;
 	virtual Specs getSpecs() const;
 	virtual void read(int& length, bool& eos, sample_t* buffer);
+	virtual bool isSilent() const;
 };
 
 AUD_NAMESPACE_END
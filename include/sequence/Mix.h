@@ -0,0 +1,104 @@
+/*******************************************************************************
+ * Copyright 2009-2016 Jörg Müller
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ ******************************************************************************/
+
+#pragma once
+
+/**
+ * @file Mix.h
+ * @ingroup sequence
+ * The Mix class.
+ */
+
+#include "ISound.h"
+
+#include <vector>
+#include <memory>
+
+AUD_NAMESPACE_BEGIN
+
+/**
+ * This sound mixes an arbitrary number of other sounds, playing them all at
+ * the same time with individual volumes.
+ *
+ * Contrary to chaining Superpose sounds this only creates a single reader
+ * for mixing, which uses one shared buffer for all inputs.
+ * \note Readers from the underlying sounds must have the same sample rate
+ *       and channel count.
+ */
+class AUD_API Mix : public ISound
+{
+private:
+	/**
+	 * The mixed sounds.
+	 */
+	std::vector<std::shared_ptr<ISound>> m_sounds;
+
+	/**
+	 * The volumes of the mixed sounds.
+	 */
+	std::vector<float> m_volumes;
+
+	/**
+	 * Adds a sound to the inputs, taking over the inputs of mix sounds.
+	 * \param sound The sound to add.
+	 */
+	AUD_LOCAL void add(std::shared_ptr<ISound> sound);
+
+	// delete copy constructor and operator=
+	Mix(const Mix&) = delete;
+	Mix& operator=(const Mix&) = delete;
+
+public:
+	/**
+	 * Creates a new mix sound with all volumes set to 1.
+	 * \param sounds The input sounds.
+	 */
+	Mix(std::vector<std::shared_ptr<ISound>> sounds);
+
+	/**
+	 * Creates a new mix sound.
+	 * \param sounds The input sounds.
+	 * \param volumes The volume of each input sound.
+	 * \exception Exception Thrown if the amount of volumes differs from the
+	 *            amount of sounds.
+	 */
+	Mix(std::vector<std::shared_ptr<ISound>> sounds, std::vector<float> volumes);
+
+	/**
+	 * Creates a new mix sound of two sounds with volume 1.
+	 * If any of the two sounds is a mix sound itself, its inputs are mixed
+	 * directly instead, so that chained mixing results in a flat mix.
+	 * \param sound1 The first input sound.
+	 * \param sound2 The second input sound.
+	 */
+	Mix(std::shared_ptr<ISound> sound1, std::shared_ptr<ISound> sound2);
+
+	/**
+	 * Returns the mixed sounds.
+	 * \return The input sounds.
+	 */
+	const std::vector<std::shared_ptr<ISound>>& getSounds() const;
+
+	/**
+	 * Returns the volumes of the mixed sounds.
+	 * \return The volume of each input sound.
+	 */
+	const std::vector<float>& getVolumes() const;
+
+	virtual std::shared_ptr<IReader> createReader();
+};
+
+AUD_NAMESPACE_END
@@ -0,0 +1,88 @@
+/*******************************************************************************
+ * Copyright 2009-2016 Jörg Müller
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ ******************************************************************************/
+
+#pragma once
+
+/**
+ * @file MixReader.h
+ * @ingroup sequence
+ * The MixReader class.
+ */
+
+#include "IReader.h"
+#include "util/Buffer.h"
+
+#include <vector>
+#include <memory>
+
+AUD_NAMESPACE_BEGIN
+
+/**
+ * This reader plays an arbitrary number of readers with the same specs in
+ * parallel.
+ */
+class AUD_API MixReader : public IReader
+{
+private:
+	/**
+	 * The mixed readers.
+	 */
+	std::vector<std::shared_ptr<IReader>> m_readers;
+
+	/**
+	 * The volumes of the mixed readers.
+	 */
+	std::vector<float> m_volumes;
+
+	/**
+	 * Buffer used for mixing, shared by all readers.
+	 */
+	Buffer m_buffer;
+
+	/**
+	 * Whether the last read was silent.
+	 */
+	bool m_silent;
+
+	// delete copy constructor and operator=
+	MixReader(const MixReader&) = delete;
+	MixReader& operator=(const MixReader&) = delete;
+
+public:
+	/**
+	 * Creates a new mix reader.
+	 * \param readers The readers to read from.
+	 * \param volumes The volume of each reader.
+	 * \exception Exception Thrown if there are no readers or the amount of
+	 *            volumes differs from the amount of readers.
+	 */
+	MixReader(std::vector<std::shared_ptr<IReader>> readers, std::vector<float> volumes);
+
+	/**
+	 * Destroys the reader.
+	 */
+	virtual ~MixReader();
+
+	virtual bool isSeekable() const;
+	virtual void seek(int position);
+	virtual int getLength() const;
+	virtual int getPosition() const;
+	virtual Specs getSpecs() const;
+	virtual void read(int& length, bool& eos, sample_t* buffer);
+	virtual bool isSilent() const;
+};
+
+AUD_NAMESPACE_END
@@ -0,0 +1,68 @@
+/*******************************************************************************
+ * Copyright 2009-2016 Jörg Müller
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ ******************************************************************************/
+
+#pragma once
+
+/**
+ * @file Scrub.h
+ * @ingroup sequence
+ * The Scrub class.
+ */
+
+#include "ISound.h"
+
+AUD_NAMESPACE_BEGIN
+
+class Sequence;
+
+/**
+ * This sound plays a sequence for scrubbing in an editor, see ScrubReader.
+ */
+class AUD_API Scrub : public ISound
+{
+private:
+	/**
+	 * The sequence to scrub.
+	 */
+	std::shared_ptr<Sequence> m_sequence;
+
+	/**
+	 * How many seconds are cached before and after the position.
+	 */
+	float m_range;
+
+	/**
+	 * Whether to use high quality sequence readers.
+	 */
+	bool m_quality;
+
+	// delete copy constructor and operator=
+	Scrub(const Scrub&) = delete;
+	Scrub& operator=(const Scrub&) = delete;
+
+public:
+	/**
+	 * Creates a new scrub sound.
+	 * \param sequence The sequence to scrub.
+	 * \param range How many seconds are cached before and after the position.
+	 * \param quality Whether to use high quality sequence readers.
+	 */
+	Scrub(std::shared_ptr<Sequence> sequence, float range = 2.0f, bool quality = false);
+
+	virtual std::shared_ptr<IReader> createReader();
+};
+
+AUD_NAMESPACE_END
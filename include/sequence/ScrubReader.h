@@ -0,0 +1,211 @@
+/*******************************************************************************
+ * Copyright 2009-2016 Jörg Müller
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ ******************************************************************************/
+
+#pragma once
+
+/**
+ * @file ScrubReader.h
+ * @ingroup sequence
+ * The ScrubReader class.
+ */
+
+#include "IReader.h"
+#include "util/Buffer.h"
+
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+AUD_NAMESPACE_BEGIN
+
+class Sequence;
+
+/**
+ * This reader is meant for scrubbing a sequence in an editor.
+ *
+ * It keeps a cache of the mixed output in blocks around the current position,
+ * which a background thread fills with its own sequence reader as the
+ * position moves. Seeking only moves the position, so short scrub bursts are
+ * served from the cache without seeking the sounds of the sequence. Blocks
+ * that aren't cached yet are rendered on the calling thread.
+ *
+ * The cache is cleared when the sequence, its entries or their animations
+ * change. Changes the reader can't detect, like the data of a sound being
+ * edited, require a call to invalidate().
+ */
+class AUD_API ScrubReader : public IReader
+{
+private:
+	/// A cached block of the mixed output.
+	struct Block
+	{
+		/// The number of the block, -1 if the block is empty.
+		int index;
+
+		/// The rendered samples.
+		Buffer data;
+	};
+
+	/**
+	 * The sequence to render.
+	 */
+	std::shared_ptr<Sequence> m_sequence;
+
+	/**
+	 * The reader rendering blocks that are missing when reading.
+	 */
+	std::shared_ptr<IReader> m_reader;
+
+	/**
+	 * The reader of the background thread.
+	 */
+	std::shared_ptr<IReader> m_cache_reader;
+
+	/**
+	 * The specification of the sequence when the reader was created.
+	 */
+	Specs m_specs;
+
+	/**
+	 * The current position.
+	 */
+	int m_position;
+
+	/**
+	 * How many blocks are cached before and after the current one.
+	 */
+	int m_range;
+
+	/**
+	 * The cached blocks, block n is stored at n modulo their count.
+	 */
+	std::vector<Block> m_blocks;
+
+	/**
+	 * The buffer for blocks rendered while reading.
+	 */
+	Buffer m_buffer;
+
+	/**
+	 * The block that contains the current position.
+	 */
+	int m_current;
+
+	/**
+	 * Counts the invalidations, to drop blocks rendered before one.
+	 */
+	int m_generation;
+
+	/**
+	 * The last edit status of the sequence the cache has been checked against.
+	 */
+	int m_edit_status;
+
+	/**
+	 * Whether the background thread should stop.
+	 */
+	bool m_stop;
+
+	/**
+	 * Mutex for the blocks and the state shared with the background thread.
+	 */
+	std::mutex m_mutex;
+
+	/**
+	 * Wakes up the background thread.
+	 */
+	std::condition_variable m_condition;
+
+	/**
+	 * The background thread filling the cache.
+	 */
+	std::thread m_thread;
+
+	/**
+	 * Returns the next block the background thread should render.
+	 * The mutex has to be locked.
+	 * \return The number of the block or -1 if all blocks are cached.
+	 */
+	AUD_LOCAL int findMissingBlock() const;
+
+	/**
+	 * Renders a block.
+	 * \param reader The reader to render with.
+	 * \param index The number of the block.
+	 * \param buffer The buffer to render to.
+	 */
+	AUD_LOCAL void renderBlock(IReader& reader, int index, sample_t* buffer);
+
+	/**
+	 * Stores a rendered block if it's still wanted.
+	 * The mutex has to be locked.
+	 * \param index The number of the block.
+	 * \param generation The generation the block has been rendered in.
+	 * \param buffer The rendered samples.
+	 */
+	AUD_LOCAL void storeBlock(int index, int generation, const sample_t* buffer);
+
+	/**
+	 * Clears the cache if the sequence changed.
+	 */
+	AUD_LOCAL void checkSequence();
+
+	/**
+	 * Moves the current block and wakes up the background thread.
+	 * \param position The new position.
+	 */
+	AUD_LOCAL void setPosition(int position);
+
+	/**
+	 * The function running in the background thread.
+	 */
+	AUD_LOCAL void run();
+
+	// delete copy constructor and operator=
+	ScrubReader(const ScrubReader&) = delete;
+	ScrubReader& operator=(const ScrubReader&) = delete;
+
+public:
+	/**
+	 * Creates a new scrub reader.
+	 * \param sequence The sequence to render.
+	 * \param range How many seconds are cached before and after the position.
+	 * \param quality Whether to use high quality sequence readers.
+	 */
+	ScrubReader(std::shared_ptr<Sequence> sequence, float range = 2.0f, bool quality = false);
+
+	/**
+	 * Destroys the reader and stops the background thread.
+	 */
+	virtual ~ScrubReader();
+
+	/**
+	 * Clears the cache, needed after changes to the sequence that the reader
+	 * can't detect itself.
+	 */
+	void invalidate();
+
+	virtual bool isSeekable() const;
+	virtual void seek(int position);
+	virtual int getLength() const;
+	virtual int getPosition() const;
+	virtual Specs getSpecs() const;
+	virtual void read(int& length, bool& eos, sample_t* buffer);
+};
+
+AUD_NAMESPACE_END
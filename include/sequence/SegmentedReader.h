@@ -0,0 +1,140 @@
+/*******************************************************************************
+ * Copyright 2009-2016 Jörg Müller
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ ******************************************************************************/
+
+#pragma once
+
+/**
+ * @file SegmentedReader.h
+ * @ingroup sequence
+ * The SegmentedReader class.
+ */
+
+#include "IReader.h"
+
+#include <atomic>
+#include <deque>
+#include <future>
+
+AUD_NAMESPACE_BEGIN
+
+class Buffer;
+class Sequence;
+class ThreadPool;
+
+/**
+ * This reader renders a sequence offline in segments that are rendered in
+ * parallel, each by its own sequence reader.
+ *
+ * Every segment starts rendering a pre-roll before its actual start, which is
+ * discarded and warms up resampler and effect states. The segments are read
+ * back in order, so for mixdowns the reader can replace a sequence reader.
+ */
+class AUD_API SegmentedReader : public IReader
+{
+private:
+	/// A segment that is rendered or queued for rendering.
+	struct Segment
+	{
+		/// The start position of the segment.
+		int start;
+
+		/// The rendered samples of the segment.
+		std::shared_future<std::shared_ptr<Buffer> > buffer;
+	};
+
+	/**
+	 * The sequence to render.
+	 */
+	std::shared_ptr<Sequence> m_sequence;
+
+	/**
+	 * The thread pool rendering the segments.
+	 */
+	std::shared_ptr<ThreadPool> m_pool;
+
+	/**
+	 * The specification of the sequence when the reader was created.
+	 */
+	Specs m_specs;
+
+	/**
+	 * The length of a segment in samples.
+	 */
+	int m_segment_length;
+
+	/**
+	 * The length of the pre-roll in samples.
+	 */
+	int m_preroll;
+
+	/**
+	 * The current position.
+	 */
+	int m_position;
+
+	/**
+	 * The start position of the next segment to queue.
+	 */
+	int m_next;
+
+	/**
+	 * The queued segments in order, the first one contains the current position.
+	 */
+	std::deque<Segment> m_segments;
+
+	/**
+	 * Set to cancel the currently queued segments.
+	 */
+	std::shared_ptr<std::atomic<bool> > m_cancelled;
+
+	/**
+	 * Queues segments until enough are rendered ahead of the current position.
+	 */
+	AUD_LOCAL void queueSegments();
+
+	/**
+	 * Cancels all queued segments.
+	 */
+	AUD_LOCAL void cancelSegments();
+
+	// delete copy constructor and operator=
+	SegmentedReader(const SegmentedReader&) = delete;
+	SegmentedReader& operator=(const SegmentedReader&) = delete;
+
+public:
+	/**
+	 * Creates a new segmented reader.
+	 * \param sequence The sequence to render, its readers are high quality.
+	 * \param pool The thread pool to render the segments in.
+	 * \param segment The length of a segment in seconds.
+	 * \param preroll How many seconds each segment starts rendering early.
+	 */
+	SegmentedReader(std::shared_ptr<Sequence> sequence, std::shared_ptr<ThreadPool> pool, float segment = 10.0f, float preroll = 1.0f);
+
+	/**
+	 * Destroys the reader and cancels rendering segments.
+	 */
+	virtual ~SegmentedReader();
+
+	virtual bool isSeekable() const;
+	virtual void seek(int position);
+	virtual int getLength() const;
+	virtual int getPosition() const;
+	virtual Specs getSpecs() const;
+	virtual void read(int& length, bool& eos, sample_t* buffer);
+};
+
+AUD_NAMESPACE_END
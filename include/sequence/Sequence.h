@@ -39,6 +39,7 @@ class SequenceData;
  */
 class AUD_API Sequence : public ISound
 {
+	friend class ScrubReader;
 	friend class SequenceReader;
 private:
 	/// The sequence.
@@ -135,6 +136,22 @@ public:
 	 */
 	void setDistanceModel(DistanceModel model);
 
+	/**
+	 * Retrieves the look-ahead time.
+	 * \return The look-ahead time in seconds.
+	 */
+	float getLookAhead() const;
+
+	/**
+	 * Sets the look-ahead time.
+	 * Entries starting within this time after the playback position are
+	 * opened, seeked and partially decoded in the background, so that
+	 * starting them doesn't stall playback. Entries are updated from ten
+	 * seconds before they start, so longer times have no further effect.
+	 * \param time The look-ahead time in seconds, 0 disables prefetching.
+	 */
+	void setLookAhead(float time);
+
 	/**
 	 * Retrieves one of the animated properties of the sound.
 	 * \param type Which animated property to retrieve.
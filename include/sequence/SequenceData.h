@@ -27,9 +27,11 @@
 #include "devices/I3DDevice.h"
 #include "util/ILockable.h"
 
-#include <list>
+#include <atomic>
+#include <deque>
 #include <memory>
 #include <mutex>
+#include <vector>
 
 AUD_NAMESPACE_BEGIN
 
@@ -39,24 +41,50 @@ class ISound;
 /**
  * This class represents sequenced entries to play a sound scene.
  */
-class AUD_API SequenceData : public ILockable
+class AUD_API SequenceData : public ILockable, public std::enable_shared_from_this<SequenceData>
 {
+	friend class ScrubReader;
+	friend class SequenceEntry;
 	friend class SequenceReader;
 private:
+	/// The kinds of changes to the entries.
+	enum EntryChangeType
+	{
+		ENTRY_ADDED,
+		ENTRY_REMOVED,
+		ENTRY_MOVED
+	};
+
+	/// A change to the entries, readers apply them in order.
+	struct EntryChange
+	{
+		/// What happened to the entry.
+		EntryChangeType type;
+
+		/// The ID of the entry.
+		int id;
+	};
+
 	/// The target specification.
 	Specs m_specs;
 
 	/// The status of the sequence. Changes every time a non-animated parameter changes.
 	int m_status;
 
-	/// The entry status. Changes every time an entry is removed or added.
+	/// The entry status. Counts the changes to the entries.
 	int m_entry_status;
 
+	/// Counts all edits of the sequence, its entries and their animations.
+	std::shared_ptr<std::atomic<int> > m_edit_status;
+
+	/// The most recent changes to the entries, the last one has been change number m_entry_status.
+	std::deque<EntryChange> m_entry_changes;
+
 	/// The next unused ID for the entries.
 	int m_id;
 
-	/// The sequenced entries.
-	std::list<std::shared_ptr<SequenceEntry> > m_entries;
+	/// The sequenced entries indexed by their ID, removed entries are nullptr.
+	std::vector<std::shared_ptr<SequenceEntry> > m_entries;
 
 	/// Whether the whole scene is muted.
 	bool m_muted;
@@ -73,6 +101,9 @@ private:
 	/// Distance model.
 	DistanceModel m_distance_model;
 
+	/// The time to prefetch entries ahead of playback.
+	float m_look_ahead;
+
 	/// The animated volume.
 	AnimateableProperty m_volume;
 
@@ -89,6 +120,25 @@ private:
 	SequenceData(const SequenceData&) = delete;
 	SequenceData& operator=(const SequenceData&) = delete;
 
+	/**
+	 * Adds a change to the entries to the change log.
+	 * \param type What happened to the entry.
+	 * \param id The ID of the entry.
+	 */
+	AUD_LOCAL void addEntryChange(EntryChangeType type, int id);
+
+	/**
+	 * Increments the status after a non-animated parameter changed.
+	 * The sequence has to be locked.
+	 */
+	AUD_LOCAL void changeStatus();
+
+	/**
+	 * Called by an entry after it has been moved.
+	 * \param entry The moved entry.
+	 */
+	AUD_LOCAL void entryMoved(SequenceEntry* entry);
+
 public:
 	/**
 	 * Creates a new sound scene.
@@ -187,6 +237,22 @@ public:
 	 */
 	void setDistanceModel(DistanceModel model);
 
+	/**
+	 * Retrieves the look-ahead time.
+	 * \return The look-ahead time in seconds.
+	 */
+	float getLookAhead() const;
+
+	/**
+	 * Sets the look-ahead time.
+	 * Entries starting within this time after the playback position are
+	 * opened, seeked and partially decoded in the background, so that
+	 * starting them doesn't stall playback. Entries are updated from ten
+	 * seconds before they start, so longer times have no further effect.
+	 * \param time The look-ahead time in seconds, 0 disables prefetching.
+	 */
+	void setLookAhead(float time);
+
 	/**
 	 * Retrieves one of the animated properties of the sequence.
 	 * \param type Which animated property to retrieve.
@@ -25,18 +25,22 @@
 #include "sequence/AnimateableProperty.h"
 #include "util/ILockable.h"
 
+#include <atomic>
 #include <mutex>
 #include <memory>
 
 AUD_NAMESPACE_BEGIN
 
 class ISound;
+class LoadRequest;
+class SequenceData;
 
 /**
  * This class represents a sequenced entry in a sequencer sound.
  */
 class AUD_API SequenceEntry : public ILockable
 {
+	friend class SequenceData;
 	friend class SequenceHandle;
 private:
 	/// The status of the entry. Changes every time a non-animated parameter changes.
@@ -48,12 +52,36 @@ private:
 	/// The sound status, changed when the sound is changed.
 	int m_sound_status;
 
+	/// The sequence the entry belongs to, which is notified about moves.
+	std::weak_ptr<SequenceData> m_sequence;
+
+	/// The edit counter of the sequence, nullptr until the entry is added.
+	std::shared_ptr<std::atomic<int> > m_edit_status;
+
 	/// The unique (regarding the sound) ID of the entry.
 	int m_id;
 
 	/// The sound this entry plays.
 	std::shared_ptr<ISound> m_sound;
 
+	/// Whether the entry plays a pre-rendered version of its sound.
+	bool m_frozen;
+
+	/// The pre-rendered sound, nullptr until rendering finished.
+	std::shared_ptr<ISound> m_frozen_sound;
+
+	/// The running pre-rendering of the sound.
+	std::shared_ptr<LoadRequest> m_freeze_request;
+
+	/// The sample rate the sound is pre-rendered at.
+	int m_freeze_rate;
+
+	/// The time of the sound the pre-rendering starts at.
+	float m_freeze_start;
+
+	/// The time of the sound the pre-rendering ends at, negative if it ends with the sound.
+	float m_freeze_end;
+
 	/// The begin time.
 	float m_begin;
 
@@ -115,6 +143,64 @@ private:
 	SequenceEntry(const SequenceEntry&) = delete;
 	SequenceEntry& operator=(const SequenceEntry&) = delete;
 
+	/**
+	 * Calculates the part of the sound that is played back.
+	 * The entry has to be locked.
+	 * \param start The time of the sound playback starts at.
+	 * \param end The time of the sound playback ends at, negative if it ends
+	 *        with the sound.
+	 */
+	AUD_LOCAL void getPlaybackRange(float& start, float& end);
+
+	/**
+	 * Starts pre-rendering the played part of the sound unless it has been
+	 * rendered before.
+	 * The entry has to be locked.
+	 */
+	AUD_LOCAL void startFreeze();
+
+	/**
+	 * Drops the pre-rendered sound and cancels a running pre-rendering.
+	 * The entry has to be locked.
+	 */
+	AUD_LOCAL void stopFreeze();
+
+	/**
+	 * Switches to the pre-rendered sound once pre-rendering finished.
+	 */
+	AUD_LOCAL void updateFreeze();
+
+	/**
+	 * Makes the entry and its animations count their edits in the sequence.
+	 * \param status The edit counter of the sequence.
+	 */
+	AUD_LOCAL void setEditStatus(std::shared_ptr<std::atomic<int> > status);
+
+	/**
+	 * Counts an edit in the sequence the entry belongs to.
+	 */
+	AUD_LOCAL void countEdit();
+
+	/**
+	 * Increments the status after a non-animated parameter changed.
+	 * The entry has to be locked.
+	 */
+	AUD_LOCAL void changeStatus();
+
+	/**
+	 * Returns the sound to play back.
+	 * The entry has to be locked.
+	 * \return The pre-rendered sound if available, otherwise the sound.
+	 */
+	AUD_LOCAL std::shared_ptr<ISound> getPlaybackSound() const;
+
+	/**
+	 * Returns how much of the playback sound is skipped at the beginning.
+	 * The entry has to be locked.
+	 * \return The time to skip in seconds.
+	 */
+	AUD_LOCAL float getPlaybackSkip() const;
+
 public:
 	/**
 	 * Creates a new sequenced entry.
@@ -149,6 +235,24 @@ public:
 	 */
 	void setSound(std::shared_ptr<ISound> sound);
 
+	/**
+	 * Freezes the entry, which pre-renders its sound at the sample rate of
+	 * the sequence in the background and then plays the rendered samples, so
+	 * that expensive effects don't have to be computed during playback.
+	 *
+	 * The rendering is shared by entries freezing the same sound and redone
+	 * when the sound is replaced. Sounds don't change after creation, so new
+	 * effect parameters mean a new sound, which invalidates it as well.
+	 * \param frozen Whether the entry should be frozen.
+	 */
+	void freeze(bool frozen);
+
+	/**
+	 * Retrieves whether the entry is frozen.
+	 * \return Whether the entry is frozen.
+	 */
+	bool isFrozen();
+
 	/**
 	 * Moves the entry.
 	 * \param begin The new start time.
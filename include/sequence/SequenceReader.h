@@ -25,10 +25,15 @@
 #include "IReader.h"
 #include "devices/ReadDevice.h"
 
+#include <unordered_map>
+#include <vector>
+
 AUD_NAMESPACE_BEGIN
 
+class ISound;
 class SequenceHandle;
 class SequenceData;
+class SharedSource;
 
 /**
  * This reader plays back sequenced entries.
@@ -36,6 +41,22 @@ class SequenceData;
 class AUD_API SequenceReader : public IReader
 {
 private:
+	/// A playback handle for an entry and its update range.
+	struct ScheduledHandle
+	{
+		/// The time from which on the handle is updated.
+		float begin;
+
+		/// The time after which the handle isn't updated anymore.
+		float end;
+
+		/// Whether the handle is currently updated.
+		bool active;
+
+		/// The playback handle, nullptr if the entry has been removed.
+		std::shared_ptr<SequenceHandle> handle;
+	};
+
 	/**
 	 * The current position.
 	 */
@@ -46,15 +67,20 @@ private:
 	 */
 	ReadDevice m_device;
 
+	/**
+	 * The sources shared by handles playing the same sound.
+	 */
+	std::unordered_map<const ISound*, std::weak_ptr<SharedSource> > m_sources;
+
 	/**
 	 * Saves the sequence the reader belongs to.
 	 */
 	std::shared_ptr<SequenceData> m_sequence;
 
 	/**
-	 * The list of playback handles for the entries.
+	 * The playback handles indexed by the ID of their entries.
 	 */
-	std::list<std::shared_ptr<SequenceHandle> > m_handles;
+	std::vector<ScheduledHandle> m_handles;
 
 	/**
 	 * Last status read from the sequence.
@@ -66,6 +92,114 @@ private:
 	 */
 	int m_entry_status;
 
+	/**
+	 * The IDs of the handles sorted by the time they have to be updated from.
+	 */
+	std::vector<int> m_schedule;
+
+	/**
+	 * The index of the next handle in the schedule to activate.
+	 */
+	std::size_t m_next_scheduled;
+
+	/**
+	 * The IDs of the handles currently updated.
+	 */
+	std::vector<int> m_active;
+
+	/**
+	 * The time of the last update.
+	 */
+	float m_schedule_time;
+
+	/**
+	 * Whether the schedule has to be rebuilt before the next update.
+	 */
+	bool m_schedule_invalid;
+
+	/**
+	 * Whether the last read was silent.
+	 */
+	bool m_silent;
+
+	/**
+	 * The overall volume envelope of the current slice.
+	 */
+	Buffer m_envelope;
+
+	/**
+	 * Compares the position of two handles in the schedule.
+	 * \param a The ID of the first handle.
+	 * \param b The ID of the second handle.
+	 * \return Whether the first handle is scheduled before the second.
+	 */
+	AUD_LOCAL bool isScheduledBefore(int a, int b) const;
+
+	/**
+	 * Inserts a handle into the schedule and activates it if necessary.
+	 * \param id The ID of the handle.
+	 */
+	AUD_LOCAL void schedule(int id);
+
+	/**
+	 * Removes a handle from the schedule and deactivates it.
+	 * \param id The ID of the handle.
+	 */
+	AUD_LOCAL void unschedule(int id);
+
+	/**
+	 * Creates the handle for an added entry.
+	 * \param id The ID of the entry.
+	 */
+	AUD_LOCAL void addHandle(int id);
+
+	/**
+	 * Stops and removes the handle of a removed entry.
+	 * \param id The ID of the entry.
+	 */
+	AUD_LOCAL void removeHandle(int id);
+
+	/**
+	 * Reschedules the handle of a moved entry.
+	 * \param id The ID of the entry.
+	 */
+	AUD_LOCAL void moveHandle(int id);
+
+	/**
+	 * Synchronizes the handles with all entries of the sequence.
+	 */
+	AUD_LOCAL void synchronizeHandles();
+
+	/**
+	 * Rebuilds the schedule and the active handles for a time.
+	 * \param time The time to build the schedule for.
+	 */
+	AUD_LOCAL void buildSchedule(float time);
+
+	/**
+	 * Activates the scheduled handles that have to be updated from a time on.
+	 * \param time The current time.
+	 */
+	AUD_LOCAL void activateHandles(float time);
+
+	/**
+	 * Calculates how long a slice can be, slices end where entries start or stop
+	 * and at frame boundaries while properties other than volumes are animated.
+	 * \param position The start position of the slice.
+	 * \param length The maximum length of the slice.
+	 * \return The length of the slice.
+	 */
+	AUD_LOCAL int getSliceLength(int position, int length) const;
+
+	/**
+	 * Updates the active handles for a slice.
+	 * \param time The current time.
+	 * \param frame The current animation frame.
+	 * \param length The length of the slice in samples.
+	 * \param step The animation frames per sample.
+	 */
+	AUD_LOCAL void updateHandles(float time, float frame, int length, float step);
+
 	// delete copy constructor and operator=
 	SequenceReader(const SequenceReader&) = delete;
 	SequenceReader& operator=(const SequenceReader&) = delete;
@@ -89,6 +223,7 @@ public:
 	virtual int getPosition() const;
 	virtual Specs getSpecs() const;
 	virtual void read(int& length, bool& eos, sample_t* buffer);
+	virtual bool isSilent() const;
 };
 
 AUD_NAMESPACE_END
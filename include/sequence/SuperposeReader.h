@@ -50,6 +50,11 @@ private:
 	 */
 	Buffer m_buffer;
 
+	/**
+	 * Whether the last read was silent.
+	 */
+	bool m_silent;
+
 	// delete copy constructor and operator=
 	SuperposeReader(const SuperposeReader&) = delete;
 	SuperposeReader& operator=(const SuperposeReader&) = delete;
@@ -74,6 +79,7 @@ public:
 	virtual int getPosition() const;
 	virtual Specs getSpecs() const;
 	virtual void read(int& length, bool& eos, sample_t* buffer);
+	virtual bool isSilent() const;
 };
 
 AUD_NAMESPACE_END
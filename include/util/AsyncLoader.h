@@ -0,0 +1,121 @@
+/*******************************************************************************
+ * Copyright 2009-2016 Jörg Müller
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ ******************************************************************************/
+
+#pragma once
+
+/**
+ * @file AsyncLoader.h
+ * @ingroup util
+ * The AsyncLoader class.
+ */
+
+#include "util/BlockBuffer.h"
+#include "util/LoadRequest.h"
+
+#include <string>
+
+AUD_NAMESPACE_BEGIN
+
+class ThreadPool;
+
+/**
+ * This class loads sounds in the background so that the calling thread,
+ * for example the main thread of a game, doesn't block.
+ *
+ * Requests are processed by a library managed set of loader threads in the
+ * order of their priority. Decoding sounds into memory can additionally use
+ * a shared decode thread pool to load ranges of a sound in parallel.
+ */
+class AUD_API AsyncLoader
+{
+public:
+	/**
+	 * A task that loads a sound.
+	 * \param progress The progress to report to and check for cancellation.
+	 * \return The loaded sound.
+	 * \exception Exception Thrown if loading fails.
+	 */
+	typedef std::function<std::shared_ptr<ISound>(std::shared_ptr<LoadProgress> progress)> task_t;
+
+private:
+	/**
+	 * Runs a load on the calling loader thread.
+	 * \param request The request to fulfill.
+	 * \param task The task that loads the sound.
+	 */
+	AUD_LOCAL static void load(std::shared_ptr<LoadRequest> request, const task_t& task);
+
+public:
+	AsyncLoader() = delete;
+
+	/**
+	 * Opens a sound file in the background.
+	 * The file is opened and its decoder is created once to check that the
+	 * file can be read, which also warms up the page cache if enabled.
+	 * \param filename The path of the file.
+	 * \param priority The priority of the load.
+	 * \param callback The callback to call on the loader thread when loading
+	 *        finished, may be empty.
+	 * \return The request to poll or wait for.
+	 */
+	static std::shared_ptr<LoadRequest> loadAsync(std::string filename, LoadPriority priority = LOAD_PRIORITY_NORMAL, LoadRequest::callback_t callback = nullptr);
+
+	/**
+	 * Decodes a sound into memory in the background, like StreamBuffer.
+	 * \param sound The sound to cache.
+	 * \param priority The priority of the load.
+	 * \param format The format the samples are stored in.
+	 * \param callback The callback to call on the loader thread when loading
+	 *        finished, may be empty.
+	 * \param parallel Whether sounds with sample accurate seeking are decoded
+	 *        in parallel ranges on the decode pool, by default they are
+	 *        decoded serially on the loader thread.
+	 * \return The request to poll or wait for, its sound is a StreamBuffer.
+	 */
+	static std::shared_ptr<LoadRequest> cacheAsync(std::shared_ptr<ISound> sound, LoadPriority priority = LOAD_PRIORITY_NORMAL, StorageFormat format = STORAGE_FLOAT32, LoadRequest::callback_t callback = nullptr, bool parallel = false);
+
+	/**
+	 * Runs a custom loading task in the background.
+	 * \param task The task to run.
+	 * \param priority The priority of the load.
+	 * \param callback The callback to call on the loader thread when loading
+	 *        finished, may be empty.
+	 * \return The request to poll or wait for.
+	 */
+	static std::shared_ptr<LoadRequest> submit(task_t task, LoadPriority priority = LOAD_PRIORITY_NORMAL, LoadRequest::callback_t callback = nullptr);
+
+	/**
+	 * Sets the number of loader threads.
+	 * Running loads are finished before the threads are replaced.
+	 * \param count The number of threads, at least 1, default is 2.
+	 */
+	static void setThreadCount(int count);
+
+	/**
+	 * Returns the number of loader threads.
+	 * \return The number of threads.
+	 */
+	static int getThreadCount();
+
+	/**
+	 * Returns the thread pool used to decode sounds in parallel.
+	 * \return The decode thread pool, which is created on first use with one
+	 *         thread per hardware thread.
+	 */
+	static std::shared_ptr<ThreadPool> getDecodePool();
+};
+
+AUD_NAMESPACE_END
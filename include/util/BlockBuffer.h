@@ -0,0 +1,241 @@
+/*******************************************************************************
+ * Copyright 2009-2016 Jörg Müller
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ ******************************************************************************/
+
+#pragma once
+
+/**
+ * @file BlockBuffer.h
+ * @ingroup util
+ * The BlockBuffer class.
+ */
+
+#include "respec/Specification.h"
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+AUD_NAMESPACE_BEGIN
+
+class Buffer;
+
+/// Storage formats of a BlockBuffer, integer formats clip to [-1, 1].
+enum StorageFormat
+{
+	STORAGE_FLOAT32 = 0,	/// Uncompressed 32 bit float samples.
+	STORAGE_S16,			/// 16 bit integer samples.
+	STORAGE_S24,			/// 24 bit integer samples.
+	STORAGE_LOSSLESS_S16,	/// 16 bit integer samples, losslessly compressed.
+	STORAGE_LOSSLESS_S24	/// 24 bit integer samples, losslessly compressed.
+};
+
+/**
+ * This class stores audio data in memory in independently encoded blocks of
+ * a fixed length. Besides plain float samples the blocks can be stored as
+ * 16 or 24 bit integers, optionally losslessly compressed with a fixed
+ * predictor and rice coding, to reduce the memory used by cached sounds.
+ *
+ * Since every block can be decoded on its own, random access stays O(1) at
+ * block granularity and encoded buffers can grow without copying existing
+ * data. Float blocks are kept in one contiguous piece of memory instead, so
+ * that the samples can be returned without copying them.
+ */
+class AUD_API BlockBuffer
+{
+public:
+	/// The length of a block in samples.
+	static const int BLOCK_LENGTH = 4096;
+
+private:
+	/// An encoded block.
+	struct Block
+	{
+		/// The memory holding the block.
+		std::shared_ptr<Buffer> buffer;
+
+		/// The byte offset of the block in the memory.
+		size_t offset;
+
+		/// The size of the encoded block in bytes.
+		size_t size;
+
+		/// The amount of samples in the block.
+		int length;
+	};
+
+	/**
+	 * The specification of the samples.
+	 */
+	Specs m_specs;
+
+	/**
+	 * The storage format of the blocks.
+	 */
+	StorageFormat m_format;
+
+	/**
+	 * The encoded blocks.
+	 */
+	std::vector<Block> m_blocks;
+
+	/**
+	 * The amount of samples stored.
+	 */
+	int m_length;
+
+	/**
+	 * The size of all blocks in bytes.
+	 */
+	size_t m_size;
+
+	/**
+	 * Samples appended that don't fill a block yet.
+	 */
+	std::shared_ptr<Buffer> m_pending;
+
+	/**
+	 * The amount of samples in m_pending.
+	 */
+	int m_pending_length;
+
+	/**
+	 * The contiguous memory holding the float blocks, which grows as they
+	 * are appended.
+	 */
+	std::shared_ptr<Buffer> m_data;
+
+	/**
+	 * Encodes samples into a block.
+	 * \param samples The samples to encode.
+	 * \param length The amount of samples, at most BLOCK_LENGTH.
+	 * \return The encoded block.
+	 */
+	AUD_LOCAL Block encode(const sample_t* samples, int length) const;
+
+	/**
+	 * Returns the amount of bytes used in m_data.
+	 * \return The size of the float blocks in m_data.
+	 */
+	AUD_LOCAL size_t getDataSize() const;
+
+	/**
+	 * Encodes and appends a block.
+	 * \param samples The samples of the block.
+	 * \param length The amount of samples, at most BLOCK_LENGTH.
+	 */
+	AUD_LOCAL void addBlock(const sample_t* samples, int length);
+
+	// delete copy constructor and operator=
+	BlockBuffer(const BlockBuffer&) = delete;
+	BlockBuffer& operator=(const BlockBuffer&) = delete;
+
+public:
+	/**
+	 * Creates a new empty block buffer.
+	 * \param specs The specification of the samples.
+	 * \param format The storage format of the blocks.
+	 */
+	BlockBuffer(Specs specs, StorageFormat format = STORAGE_FLOAT32);
+
+	/**
+	 * Creates a block buffer from float samples without copying them.
+	 * \param buffer The buffer holding the samples.
+	 * \param specs The specification of the samples.
+	 */
+	BlockBuffer(std::shared_ptr<Buffer> buffer, Specs specs);
+
+	/**
+	 * Appends samples to the buffer.
+	 * Samples that don't fill a whole block are kept until more are appended
+	 * or finish is called.
+	 * \param buffer The samples to append.
+	 * \param length The amount of samples.
+	 */
+	void append(const sample_t* buffer, int length);
+
+	/**
+	 * Appends the blocks of another buffer without reencoding them.
+	 * Float blocks are copied to keep the samples contiguous, encoded blocks
+	 * are shared.
+	 * \param buffer The finished buffer to append, it must have the same specs
+	 *        and format.
+	 * \exception StateException Thrown if the blocks of this buffer are not
+	 *            all full or the buffers don't match.
+	 */
+	void append(const BlockBuffer& buffer);
+
+	/**
+	 * Encodes samples that are still pending after appending and frees
+	 * memory reserved for further float samples.
+	 * \note This must be called before the buffer is read.
+	 */
+	void finish();
+
+	/**
+	 * Returns the specification of the samples.
+	 * \return The specification.
+	 */
+	Specs getSpecs() const;
+
+	/**
+	 * Returns the storage format of the blocks.
+	 * \return The storage format.
+	 */
+	StorageFormat getFormat() const;
+
+	/**
+	 * Returns the amount of samples stored.
+	 * \return The length in samples.
+	 */
+	int getLength() const;
+
+	/**
+	 * Returns the memory used by the blocks.
+	 * \return The size in bytes.
+	 */
+	size_t getSize() const;
+
+	/**
+	 * Returns whether samples can be read without decoding whole blocks.
+	 * \return False for compressed storage formats.
+	 */
+	bool isRandomAccess() const;
+
+	/**
+	 * Decodes a whole block.
+	 * \param index The index of the block.
+	 * \param buffer The buffer to decode to, with space for BLOCK_LENGTH samples.
+	 * \return The amount of samples in the block.
+	 */
+	int decodeBlock(int index, sample_t* buffer) const;
+
+	/**
+	 * Reads samples from the buffer.
+	 * \param position The position of the first sample to read.
+	 * \param length The amount of samples to read, must be within the buffer.
+	 * \param buffer The buffer to read to.
+	 */
+	void read(int position, int length, sample_t* buffer) const;
+
+	/**
+	 * Returns all samples in one contiguous float buffer.
+	 * \return The buffer, which is only a copy if the data is stored as
+	 *         integers or compressed.
+	 */
+	std::shared_ptr<Buffer> toBuffer() const;
+};
+
+AUD_NAMESPACE_END
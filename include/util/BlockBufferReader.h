@@ -0,0 +1,82 @@
+/*******************************************************************************
+ * Copyright 2009-2016 Jörg Müller
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ ******************************************************************************/
+
+#pragma once
+
+/**
+ * @file BlockBufferReader.h
+ * @ingroup util
+ * The BlockBufferReader class.
+ */
+
+#include "IReader.h"
+#include "util/Buffer.h"
+
+#include <memory>
+
+AUD_NAMESPACE_BEGIN
+
+class BlockBuffer;
+
+/**
+ * This class reads from a BlockBuffer, decoding the stored samples to float
+ * on the fly. For compressed storage formats the last decoded block is kept,
+ * so that small reads don't decode the same block repeatedly.
+ */
+class AUD_API BlockBufferReader : public IReader
+{
+private:
+	/**
+	 * The current position in the buffer.
+	 */
+	int m_position;
+
+	/**
+	 * The buffer that is read.
+	 */
+	std::shared_ptr<BlockBuffer> m_buffer;
+
+	/**
+	 * The last decoded block.
+	 */
+	Buffer m_block;
+
+	/**
+	 * The index of the decoded block, -1 if none.
+	 */
+	int m_block_index;
+
+	// delete copy constructor and operator=
+	BlockBufferReader(const BlockBufferReader&) = delete;
+	BlockBufferReader& operator=(const BlockBufferReader&) = delete;
+
+public:
+	/**
+	 * Creates a new block buffer reader.
+	 * \param buffer The buffer to read from.
+	 */
+	BlockBufferReader(std::shared_ptr<BlockBuffer> buffer);
+
+	virtual bool isSeekable() const;
+	virtual void seek(int position);
+	virtual int getLength() const;
+	virtual int getPosition() const;
+	virtual Specs getSpecs() const;
+	virtual void read(int& length, bool& eos, sample_t* buffer);
+	virtual bool isSeekAccurate() const;
+};
+
+AUD_NAMESPACE_END
@@ -71,6 +71,7 @@ public:
 	virtual int getPosition() const;
 	virtual Specs getSpecs() const;
 	virtual void read(int& length, bool& eos, sample_t* buffer);
+	virtual bool isSeekAccurate() const;
 };
 
 AUD_NAMESPACE_END
@@ -0,0 +1,93 @@
+/*******************************************************************************
+ * Copyright 2009-2016 Jörg Müller
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ ******************************************************************************/
+
+#pragma once
+
+/**
+ * @file DenormalCounter.h
+ * @ingroup util
+ * The DenormalCounter class.
+ */
+
+#include "Audaspace.h"
+
+#include <map>
+#include <string>
+
+AUD_NAMESPACE_BEGIN
+
+/**
+ * The DenormalCounter is a debugging aid which counts the denormal samples
+ * produced by the readers that are prone to generate them.
+ *
+ * Counting is disabled by default, as checking the samples costs performance.
+ * Denormals are only expected in threads that don't use a DenormalGuard or
+ * if the denormal-safe mode is disabled or not supported on the platform.
+ */
+class AUD_API DenormalCounter
+{
+private:
+	// delete copy constructor and operator=
+	DenormalCounter(const DenormalCounter&) = delete;
+	DenormalCounter& operator=(const DenormalCounter&) = delete;
+	DenormalCounter() = delete;
+
+	/**
+	 * Counts the denormal samples of a buffer.
+	 * \param name The name of the reader that produced the samples.
+	 * \param buffer The samples to check.
+	 * \param length The amount of samples in the buffer.
+	 */
+	static void countDenormals(const char* name, const sample_t* buffer, int length);
+
+public:
+	/**
+	 * Enables or disables counting of denormal samples.
+	 * \param enabled Whether denormal samples should be counted.
+	 */
+	static void setEnabled(bool enabled);
+
+	/**
+	 * Returns whether denormal samples are counted.
+	 * \return Whether counting is enabled.
+	 */
+	static bool isEnabled();
+
+	/**
+	 * Checks the samples of a buffer for denormals if counting is enabled.
+	 * \param name The name of the reader that produced the samples.
+	 * \param buffer The samples to check.
+	 * \param length The amount of samples in the buffer.
+	 */
+	static inline void check(const char* name, const sample_t* buffer, int length)
+	{
+		if(isEnabled())
+			countDenormals(name, buffer, length);
+	}
+
+	/**
+	 * Returns the amount of denormal samples counted so far.
+	 * \return A map from reader names to their amount of denormal samples.
+	 */
+	static std::map<std::string, unsigned long long> getCounts();
+
+	/**
+	 * Resets all counters to zero.
+	 */
+	static void reset();
+};
+
+AUD_NAMESPACE_END
@@ -0,0 +1,88 @@
+/*******************************************************************************
+ * Copyright 2009-2016 Jörg Müller
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ ******************************************************************************/
+
+#pragma once
+
+/**
+ * @file DenormalGuard.h
+ * @ingroup util
+ * The DenormalGuard class.
+ */
+
+#include "Audaspace.h"
+
+AUD_NAMESPACE_BEGIN
+
+/**
+ * This class sets the floating point unit of the current thread to flush
+ * denormal numbers to zero for its lifetime and restores the previous state
+ * when it is destroyed.
+ *
+ * Denormal numbers occur for example in the decaying tails of IIR filters and
+ * convolutions and slow down arithmetic drastically on many processors. All
+ * processing threads owned by the library use this guard. On platforms where
+ * the floating point mode cannot be changed the guard does nothing.
+ */
+class AUD_API DenormalGuard
+{
+private:
+	/**
+	 * The floating point state before the guard was created.
+	 */
+	unsigned long long m_state;
+
+	/**
+	 * Whether the floating point state has been changed by the guard.
+	 */
+	bool m_active;
+
+	// delete copy constructor and operator=
+	DenormalGuard(const DenormalGuard&) = delete;
+	DenormalGuard& operator=(const DenormalGuard&) = delete;
+
+public:
+	/**
+	 * Enables flushing denormals to zero in the current thread if the
+	 * denormal-safe mode is enabled.
+	 */
+	DenormalGuard();
+
+	/**
+	 * Restores the previous floating point state of the current thread.
+	 */
+	~DenormalGuard();
+
+	/**
+	 * Enables or disables the denormal-safe mode for guards created
+	 * afterwards. It is enabled by default.
+	 * \param enabled Whether denormals should be flushed to zero.
+	 */
+	static void setEnabled(bool enabled);
+
+	/**
+	 * Returns whether the denormal-safe mode is enabled.
+	 * \return Whether denormals are flushed to zero by guards.
+	 */
+	static bool isEnabled();
+
+	/**
+	 * Returns whether flushing denormals to zero is supported on this platform.
+	 * \return Whether the guard is able to change the floating point state.
+	 */
+	static bool isSupported();
+};
+
+AUD_NAMESPACE_END
@@ -0,0 +1,125 @@
+/*******************************************************************************
+ * Copyright 2009-2016 Jörg Müller
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ ******************************************************************************/
+
+#pragma once
+
+/**
+ * @file LoadProgress.h
+ * @ingroup util
+ * The LoadProgress class.
+ */
+
+#include "Audaspace.h"
+
+#include <atomic>
+
+AUD_NAMESPACE_BEGIN
+
+/**
+ * This class tracks the progress of loading a sound into memory and allows
+ * to cancel it, for example from a loading screen.
+ *
+ * The loader reports its progress while any other thread may query it or
+ * request cancellation at any time.
+ */
+class AUD_API LoadProgress
+{
+private:
+	/**
+	 * The amount of samples loaded.
+	 */
+	std::atomic<int> m_loaded;
+
+	/**
+	 * The amount of samples to load, 0 if unknown.
+	 */
+	std::atomic<int> m_total;
+
+	/**
+	 * Whether loading has finished.
+	 */
+	std::atomic<bool> m_finished;
+
+	/**
+	 * Whether loading should be cancelled.
+	 */
+	std::atomic<bool> m_cancelled;
+
+	// delete copy constructor and operator=
+	LoadProgress(const LoadProgress&) = delete;
+	LoadProgress& operator=(const LoadProgress&) = delete;
+
+public:
+	/**
+	 * Creates a new progress object.
+	 */
+	LoadProgress();
+
+	/**
+	 * Returns the progress of loading.
+	 * \return The progress between 0 and 1, 0 while the length is unknown.
+	 */
+	float getProgress() const;
+
+	/**
+	 * Returns the amount of samples loaded so far.
+	 * \return The amount of samples.
+	 */
+	int getLoaded() const;
+
+	/**
+	 * Returns the amount of samples to load.
+	 * \return The amount of samples, 0 if unknown.
+	 */
+	int getTotal() const;
+
+	/**
+	 * Returns whether loading has finished, successfully or not.
+	 * \return Whether loading has finished.
+	 */
+	bool isFinished() const;
+
+	/**
+	 * Requests loading to be cancelled.
+	 * The loader stops as soon as possible and throws a StateException.
+	 */
+	void cancel();
+
+	/**
+	 * Returns whether loading has been cancelled.
+	 * \return Whether cancel has been called.
+	 */
+	bool isCancelled() const;
+
+	/**
+	 * Sets the amount of samples to load, called by the loader.
+	 * \param total The amount of samples, 0 if unknown.
+	 */
+	void setTotal(int total);
+
+	/**
+	 * Reports loaded samples, called by the loader.
+	 * \param length The amount of samples loaded since the last report.
+	 */
+	void advance(int length);
+
+	/**
+	 * Marks loading as finished, called by the loader.
+	 */
+	void finish();
+};
+
+AUD_NAMESPACE_END
@@ -0,0 +1,194 @@
+/*******************************************************************************
+ * Copyright 2009-2016 Jörg Müller
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ ******************************************************************************/
+
+#pragma once
+
+/**
+ * @file LoadRequest.h
+ * @ingroup util
+ * The LoadRequest class.
+ */
+
+#include "ISound.h"
+
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <string>
+
+AUD_NAMESPACE_BEGIN
+
+class LoadProgress;
+
+/// Status of an asynchronous load.
+enum LoadStatus
+{
+	LOAD_STATUS_QUEUED = 0,	/// Waiting for a loader thread.
+	LOAD_STATUS_LOADING,	/// Being loaded.
+	LOAD_STATUS_DONE,		/// Loaded successfully.
+	LOAD_STATUS_FAILED,		/// Loading failed.
+	LOAD_STATUS_CANCELLED	/// Loading has been cancelled.
+};
+
+/// Priority of an asynchronous load, higher priorities are loaded first.
+enum LoadPriority
+{
+	LOAD_PRIORITY_LOW = 0,	/// Load when nothing else is waiting.
+	LOAD_PRIORITY_NORMAL,	/// Default priority.
+	LOAD_PRIORITY_HIGH		/// Load before everything else.
+};
+
+/**
+ * This class represents a sound that is loaded asynchronously by the
+ * AsyncLoader. It can be polled, waited for like a future or report to a
+ * callback when loading has finished.
+ */
+class AUD_API LoadRequest
+{
+	friend class AsyncLoader;
+
+public:
+	/**
+	 * The callback that is called on the loader thread when loading finished,
+	 * before threads waiting for the request resume.
+	 * \param request The request that finished.
+	 */
+	typedef std::function<void(LoadRequest& request)> callback_t;
+
+private:
+	/**
+	 * The progress of the load, also used for cancellation.
+	 */
+	std::shared_ptr<LoadProgress> m_progress;
+
+	/**
+	 * The priority of the load.
+	 */
+	LoadPriority m_priority;
+
+	/**
+	 * The status of the load.
+	 */
+	LoadStatus m_status;
+
+	/**
+	 * The loaded sound.
+	 */
+	std::shared_ptr<ISound> m_sound;
+
+	/**
+	 * The error message if loading failed.
+	 */
+	std::string m_error;
+
+	/**
+	 * The callback to call when loading finished.
+	 */
+	callback_t m_callback;
+
+	/**
+	 * Mutex for the status and result.
+	 */
+	mutable std::mutex m_mutex;
+
+	/**
+	 * Signals that loading finished.
+	 */
+	std::condition_variable m_condition;
+
+	/**
+	 * Marks the request as being loaded.
+	 * \return false if the request has been cancelled before.
+	 */
+	AUD_LOCAL bool start();
+
+	/**
+	 * Finishes the request and calls the callback.
+	 * \param status The final status.
+	 * \param sound The loaded sound if successful.
+	 * \param error The error message if not successful.
+	 */
+	AUD_LOCAL void finish(LoadStatus status, std::shared_ptr<ISound> sound, const std::string& error);
+
+	// delete copy constructor and operator=
+	LoadRequest(const LoadRequest&) = delete;
+	LoadRequest& operator=(const LoadRequest&) = delete;
+
+public:
+	/**
+	 * Creates a new queued request.
+	 * \param priority The priority of the load.
+	 * \param callback The callback to call when loading finished, may be empty.
+	 */
+	LoadRequest(LoadPriority priority, callback_t callback = nullptr);
+
+	/**
+	 * Returns the priority of the load.
+	 * \return The priority.
+	 */
+	LoadPriority getPriority() const;
+
+	/**
+	 * Returns the status of the load.
+	 * \return The status.
+	 */
+	LoadStatus getStatus() const;
+
+	/**
+	 * Returns whether loading has finished, successfully or not.
+	 * \return Whether loading has finished.
+	 */
+	bool isFinished() const;
+
+	/**
+	 * Returns the progress of the load.
+	 * \return The progress object of the load.
+	 */
+	std::shared_ptr<LoadProgress> getProgress() const;
+
+	/**
+	 * Returns the loaded sound.
+	 * \return The sound or nullptr if loading hasn't finished successfully.
+	 */
+	std::shared_ptr<ISound> getSound() const;
+
+	/**
+	 * Returns the reason why loading failed.
+	 * \return The error message, empty unless the status is LOAD_STATUS_FAILED.
+	 */
+	std::string getError() const;
+
+	/**
+	 * Cancels the load.
+	 * Queued requests are dropped, running ones stop as soon as possible.
+	 */
+	void cancel();
+
+	/**
+	 * Waits until loading has finished.
+	 * \return The loaded sound or nullptr if loading failed or was cancelled.
+	 */
+	std::shared_ptr<ISound> wait();
+
+	/**
+	 * Waits until loading has finished or a timeout expires.
+	 * \param timeout The maximum time to wait in seconds.
+	 * \return Whether loading has finished.
+	 */
+	bool wait(float timeout);
+};
+
+AUD_NAMESPACE_END
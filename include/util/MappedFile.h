@@ -0,0 +1,85 @@
+/*******************************************************************************
+ * Copyright 2009-2016 Jörg Müller
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ ******************************************************************************/
+
+#pragma once
+
+/**
+ * @file MappedFile.h
+ * @ingroup util
+ * The MappedFile class.
+ */
+
+#include "Audaspace.h"
+
+#include <string>
+#include <cstddef>
+
+AUD_NAMESPACE_BEGIN
+
+/**
+ * This class maps a file read-only into memory.
+ * The operating system pages the file contents in on demand, so opening even
+ * huge files is cheap and random access doesn't need any copying.
+ */
+class AUD_API MappedFile
+{
+private:
+	/**
+	 * The start of the mapped file contents.
+	 */
+	const data_t* m_data;
+
+	/**
+	 * The size of the mapping in bytes.
+	 */
+	size_t m_size;
+
+	/**
+	 * The platform specific mapping handle.
+	 */
+	void* m_mapping;
+
+	// delete copy constructor and operator=
+	MappedFile(const MappedFile&) = delete;
+	MappedFile& operator=(const MappedFile&) = delete;
+
+public:
+	/**
+	 * Maps a file into memory.
+	 * \param filename The path of the file to map.
+	 * \exception FileException Thrown if the file cannot be opened or mapped.
+	 */
+	MappedFile(std::string filename);
+
+	/**
+	 * Unmaps the file.
+	 */
+	~MappedFile();
+
+	/**
+	 * Returns the mapped file contents.
+	 * \return A pointer to the start of the file in memory.
+	 */
+	const data_t* getData() const;
+
+	/**
+	 * Returns the size of the mapped file.
+	 * \return The size in bytes.
+	 */
+	size_t getSize() const;
+};
+
+AUD_NAMESPACE_END
@@ -0,0 +1,138 @@
+/*******************************************************************************
+ * Copyright 2009-2016 Jörg Müller
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ ******************************************************************************/
+
+#pragma once
+
+/**
+ * @file PageCache.h
+ * @ingroup util
+ * The PageCache class.
+ */
+
+#include "respec/Specification.h"
+
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <string>
+
+AUD_NAMESPACE_BEGIN
+
+class Buffer;
+
+/**
+ * This class is a global cache of decoded sample pages, shared by all
+ * PageCacheReaders. Pages are identified by a source key and their index and
+ * are decoded only once, even if several readers request the same page at
+ * the same time. When the memory budget is exceeded, the least recently used
+ * pages are evicted.
+ *
+ * The cache is disabled by default; File sounds only read through it once a
+ * budget has been set.
+ */
+class AUD_API PageCache
+{
+public:
+	/// The length of a page in samples.
+	static const int PAGE_LENGTH = 16384;
+
+	/// A page of decoded samples.
+	struct Page
+	{
+		/// The interleaved float samples.
+		std::shared_ptr<Buffer> buffer;
+
+		/// The amount of valid samples in the page.
+		int length;
+
+		/// Whether the source ends within this page.
+		bool last;
+	};
+
+	/**
+	 * Function filling a page.
+	 * \param page The page to fill.
+	 * \return Whether the page could be decoded.
+	 */
+	typedef std::function<bool(Page& page)> loader_f;
+
+private:
+	// static only
+	PageCache() = delete;
+
+public:
+	/**
+	 * Sets the memory budget of the cache.
+	 * \param bytes The maximum size of all cached pages in bytes, 0 disables
+	 *        the cache and frees all pages.
+	 */
+	static void setBudget(size_t bytes);
+
+	/**
+	 * Returns the memory budget of the cache.
+	 * \return The maximum size of all cached pages in bytes.
+	 */
+	static size_t getBudget();
+
+	/**
+	 * Returns the memory currently used by cached pages.
+	 * \return The size of all cached pages in bytes.
+	 */
+	static size_t getMemoryUsage();
+
+	/**
+	 * Removes all pages and source information from the cache.
+	 */
+	static void clear();
+
+	/**
+	 * Returns a page, decoding it if it's not cached.
+	 * If another thread is already decoding the page, this waits for it.
+	 * \param source The key of the source.
+	 * \param index The index of the page.
+	 * \param loader The function decoding the page if it isn't cached.
+	 * \return The page or nullptr if it couldn't be decoded.
+	 */
+	static std::shared_ptr<const Page> getPage(const std::string& source, int index, const loader_f& loader);
+
+	/**
+	 * Stores a page that has been decoded on the way to another one.
+	 * Nothing happens if the page is already cached or being decoded.
+	 * \param source The key of the source.
+	 * \param index The index of the page.
+	 * \param page The decoded page.
+	 */
+	static void addPage(const std::string& source, int index, std::shared_ptr<const Page> page);
+
+	/**
+	 * Looks up the stored specification and length of a source.
+	 * \param source The key of the source.
+	 * \param[out] specs The specification of the source.
+	 * \param[out] length The length of the source in samples.
+	 * \return Whether information about the source is stored.
+	 */
+	static bool getInfo(const std::string& source, Specs& specs, int& length);
+
+	/**
+	 * Stores the specification and length of a source.
+	 * \param source The key of the source.
+	 * \param specs The specification of the source.
+	 * \param length The length of the source in samples.
+	 */
+	static void setInfo(const std::string& source, Specs specs, int length);
+};
+
+AUD_NAMESPACE_END
@@ -0,0 +1,130 @@
+/*******************************************************************************
+ * Copyright 2009-2016 Jörg Müller
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ ******************************************************************************/
+
+#pragma once
+
+/**
+ * @file PageCacheReader.h
+ * @ingroup util
+ * The PageCacheReader class.
+ */
+
+#include "IReader.h"
+#include "util/PageCache.h"
+
+#include <string>
+#include <memory>
+
+AUD_NAMESPACE_BEGIN
+
+/**
+ * This reader reads a sound file through the global PageCache.
+ * It is merely a cursor over the shared decoded pages. Missing pages are
+ * decoded by a single decoding reader per file that is shared by all page
+ * cache readers of the file. It advances sequentially and also caches the
+ * pages it passes on the way, so that the file is decoded once and only
+ * seeked for jumps. Decoders that don't seek sample accurately are never
+ * seeked, they decode forward or restart from the beginning instead.
+ */
+class AUD_API PageCacheReader : public IReader
+{
+private:
+	/// The decoder shared by all readers of a file.
+	struct Decoder;
+
+	/**
+	 * The path of the file.
+	 */
+	std::string m_filename;
+
+	/**
+	 * The cache key of the file, identifying its contents.
+	 */
+	std::string m_source;
+
+	/**
+	 * The decoder of the file.
+	 */
+	std::shared_ptr<Decoder> m_decoder;
+
+	/**
+	 * The current position in samples.
+	 */
+	int m_position;
+
+	/**
+	 * The length of the file in samples.
+	 */
+	int m_length;
+
+	/**
+	 * The specification of the audio data.
+	 */
+	Specs m_specs;
+
+	/**
+	 * The page currently read.
+	 */
+	std::shared_ptr<const PageCache::Page> m_page;
+
+	/**
+	 * The index of the page currently read.
+	 */
+	int m_page_index;
+
+	/**
+	 * Returns the decoder of a file, shared with other readers of the file.
+	 * \param source The cache key of the file.
+	 * \return The decoder.
+	 */
+	AUD_LOCAL static std::shared_ptr<Decoder> getDecoder(const std::string& source);
+
+	/**
+	 * Decodes a page with the shared decoder.
+	 * \param index The index of the page.
+	 * \param page The page to fill.
+	 * \return Whether the page could be decoded.
+	 */
+	AUD_LOCAL bool loadPage(int index, PageCache::Page& page);
+
+	/**
+	 * Decodes the next page of the shared decoder, which has to be locked.
+	 * \param page The page to fill.
+	 */
+	AUD_LOCAL void decodePage(PageCache::Page& page);
+
+	// delete copy constructor and operator=
+	PageCacheReader(const PageCacheReader&) = delete;
+	PageCacheReader& operator=(const PageCacheReader&) = delete;
+
+public:
+	/**
+	 * Creates a new page cache reader.
+	 * \param filename The path of the file to read.
+	 * \exception Exception Thrown if the file cannot be read or isn't
+	 *            seekable and thus can't be read page by page.
+	 */
+	PageCacheReader(std::string filename);
+
+	virtual bool isSeekable() const;
+	virtual void seek(int position);
+	virtual int getLength() const;
+	virtual int getPosition() const;
+	virtual Specs getSpecs() const;
+	virtual void read(int& length, bool& eos, sample_t* buffer);
+};
+
+AUD_NAMESPACE_END
@@ -0,0 +1,112 @@
+/*******************************************************************************
+ * Copyright 2009-2016 Jörg Müller
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ ******************************************************************************/
+
+#pragma once
+
+/**
+ * @file RingBuffer.h
+ * @ingroup util
+ * The RingBuffer class.
+ */
+
+#include "util/Buffer.h"
+
+#include <atomic>
+
+AUD_NAMESPACE_BEGIN
+
+/**
+ * This class is a lock-free single producer, single consumer ring buffer of
+ * samples. One thread may write while another one reads without any locking,
+ * which makes it suitable to pass audio data to real-time threads.
+ */
+class AUD_API RingBuffer
+{
+private:
+	/// The sample memory, one sample larger than the capacity.
+	Buffer m_buffer;
+
+	/// The size of the sample memory in samples.
+	int m_size;
+
+	/// The read position in samples.
+	std::atomic<int> m_read;
+
+	/// The write position in samples.
+	std::atomic<int> m_write;
+
+	// delete copy constructor and operator=
+	RingBuffer(const RingBuffer&) = delete;
+	RingBuffer& operator=(const RingBuffer&) = delete;
+
+public:
+	/**
+	 * Creates a new ring buffer.
+	 * \param size The capacity of the ring buffer in samples.
+	 */
+	RingBuffer(int size = 0);
+
+	/**
+	 * Returns the capacity of the ring buffer.
+	 * \return The capacity in samples.
+	 */
+	int getSize() const;
+
+	/**
+	 * Changes the capacity of the ring buffer and empties it.
+	 * \param size The new capacity in samples.
+	 * \warning Neither the reading nor the writing thread may access the
+	 *          buffer during this call.
+	 */
+	void resize(int size);
+
+	/**
+	 * Empties the ring buffer.
+	 * \warning Neither the reading nor the writing thread may access the
+	 *          buffer during this call.
+	 */
+	void reset();
+
+	/**
+	 * Returns how many samples can be read.
+	 * \return The amount of samples available for reading.
+	 */
+	int getReadSpace() const;
+
+	/**
+	 * Returns how many samples can be written.
+	 * \return The amount of samples that fit into the buffer.
+	 */
+	int getWriteSpace() const;
+
+	/**
+	 * Reads samples from the ring buffer.
+	 * \param buffer The buffer to read to.
+	 * \param length The maximum amount of samples to read.
+	 * \return The amount of samples actually read.
+	 */
+	int read(sample_t* buffer, int length);
+
+	/**
+	 * Writes samples into the ring buffer.
+	 * \param buffer The buffer to write from.
+	 * \param length The maximum amount of samples to write.
+	 * \return The amount of samples actually written.
+	 */
+	int write(const sample_t* buffer, int length);
+};
+
+AUD_NAMESPACE_END
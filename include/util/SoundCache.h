@@ -0,0 +1,120 @@
+/*******************************************************************************
+ * Copyright 2009-2016 Jörg Müller
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ ******************************************************************************/
+
+#pragma once
+
+/**
+ * @file SoundCache.h
+ * @ingroup util
+ * The SoundCache class.
+ */
+
+#include "Audaspace.h"
+
+#include <cstddef>
+#include <memory>
+
+AUD_NAMESPACE_BEGIN
+
+class BlockBuffer;
+
+/**
+ * This class keeps track of the memory used by all StreamBuffers.
+ * The cached buffers are owned by the cache. If a budget is set and the
+ * buffers exceed it, the least recently played buffers are evicted and their
+ * StreamBuffers fall back to streaming from their source sound.
+ * Buffers that cannot be rebuilt, because they were created from raw data,
+ * are accounted for but never evicted.
+ */
+class AUD_API SoundCache
+{
+private:
+	// static only
+	SoundCache() = delete;
+
+public:
+	/**
+	 * Sets the memory budget for cached sounds.
+	 * \param bytes The maximum size of all cached buffers in bytes or 0 for
+	 *        no limit, which is the default.
+	 */
+	static void setBudget(size_t bytes);
+
+	/**
+	 * Returns the memory budget for cached sounds.
+	 * \return The maximum size of all cached buffers in bytes, 0 if unlimited.
+	 */
+	static size_t getBudget();
+
+	/**
+	 * Returns the memory used by cached buffers.
+	 * \return The size of all cached buffers in bytes.
+	 */
+	static size_t getMemoryUsage();
+
+	/**
+	 * Returns how often a cached buffer was found.
+	 * \return The amount of cache hits.
+	 */
+	static unsigned long long getHits();
+
+	/**
+	 * Returns how often a buffer was requested after it had been evicted.
+	 * \return The amount of cache misses.
+	 */
+	static unsigned long long getMisses();
+
+	/**
+	 * Returns how many buffers have been evicted.
+	 * \return The amount of evictions.
+	 */
+	static unsigned long long getEvictions();
+
+	/**
+	 * Resets the hit, miss and eviction counters.
+	 */
+	static void resetStatistics();
+
+	/**
+	 * Adds a buffer to the cache and evicts others if it exceeds the budget.
+	 * \param buffer The buffer to add.
+	 * \param evictable Whether the buffer may be evicted.
+	 * \return The identifier of the cache entry.
+	 */
+	static unsigned int add(std::shared_ptr<BlockBuffer> buffer, bool evictable);
+
+	/**
+	 * Puts a buffer back into an entry after it had been evicted.
+	 * \param id The identifier of the cache entry.
+	 * \param buffer The rebuilt buffer.
+	 */
+	static void restore(unsigned int id, std::shared_ptr<BlockBuffer> buffer);
+
+	/**
+	 * Returns the buffer of an entry and marks it as recently used.
+	 * \param id The identifier of the cache entry.
+	 * \return The buffer or nullptr if it has been evicted.
+	 */
+	static std::shared_ptr<BlockBuffer> get(unsigned int id);
+
+	/**
+	 * Removes an entry from the cache.
+	 * \param id The identifier of the cache entry.
+	 */
+	static void remove(unsigned int id);
+};
+
+AUD_NAMESPACE_END
@@ -24,40 +24,103 @@
 
 #include "ISound.h"
 #include "respec/Specification.h"
+#include "util/BlockBuffer.h"
 
 AUD_NAMESPACE_BEGIN
 
 class Buffer;
+class LoadProgress;
+class ThreadPool;
 
 /**
  * This sound creates a buffer out of a reader. This way normally streamed
  * sound sources can be loaded into memory for buffered playback.
+ * To save memory the samples can be stored as integers or losslessly
+ * compressed instead of as floats, see BlockBuffer.
+ *
+ * If a thread pool is given and the source has a known length and sample
+ * accurate seeking, see IReader::isSeekAccurate, it is split into ranges that
+ * are decoded in parallel by their own readers. Other sources are decoded
+ * serially, so the result always equals serial decoding.
+ *
+ * The buffer is managed by the SoundCache. If it gets evicted to stay within
+ * the cache's memory budget, readers stream from the source sound again until
+ * the buffer is requested via getBuffer.
  */
 class AUD_API StreamBuffer : public ISound
 {
 private:
 	/**
-	 * The buffer that holds the audio data.
+	 * The sound that is buffered, nullptr if created from a buffer.
 	 */
-	std::shared_ptr<Buffer> m_buffer;
+	std::shared_ptr<ISound> m_sound;
+
+	/**
+	 * The SoundCache entry that holds the audio data.
+	 */
+	unsigned int m_id;
 
 	/**
 	 * The specification of the samples.
 	 */
 	Specs m_specs;
 
+	/**
+	 * The storage format of the samples.
+	 */
+	StorageFormat m_format;
+
+	/**
+	 * The thread pool to decode with, nullptr to decode on the calling thread.
+	 */
+	std::shared_ptr<ThreadPool> m_pool;
+
 	// delete copy constructor and operator=
 	StreamBuffer(const StreamBuffer&) = delete;
 	StreamBuffer& operator=(const StreamBuffer&) = delete;
 
+	/**
+	 * Reads the source sound into a new buffer.
+	 * \param[out] specs The specification of the audio data.
+	 * \param progress The progress to report to, may be nullptr.
+	 * \return The buffer holding the audio data.
+	 * \exception StateException Thrown if loading has been cancelled.
+	 */
+	AUD_LOCAL std::shared_ptr<BlockBuffer> decode(Specs& specs, std::shared_ptr<LoadProgress> progress);
+
+	/**
+	 * Reads the source sound in parallel ranges on the thread pool.
+	 * \param reader A reader of the source at position 0.
+	 * \param progress The progress to report to, may be nullptr.
+	 * \return The buffer holding the audio data or nullptr if the ranges
+	 *         didn't match the length reported by the reader.
+	 */
+	AUD_LOCAL std::shared_ptr<BlockBuffer> decodeParallel(std::shared_ptr<IReader> reader, std::shared_ptr<LoadProgress> progress);
+
 public:
 	/**
 	 * Creates the sound and reads the reader created by the sound supplied
 	 * to the buffer.
 	 * \param sound The sound that creates the reader for buffering.
+	 * \param format The format the samples are stored in.
+	 * \exception Exception Thrown if the reader cannot be created.
+	 */
+	StreamBuffer(std::shared_ptr<ISound> sound, StorageFormat format = STORAGE_FLOAT32);
+
+	/**
+	 * Creates the sound and reads the sound supplied to the buffer using a
+	 * thread pool.
+	 * \param sound The sound that creates the readers for buffering.
+	 * \param threadPool The thread pool to decode ranges of the sound with.
+	 *        The calling thread takes part in decoding, so this may also be
+	 *        called from a task of the same pool.
+	 * \param format The format the samples are stored in.
+	 * \param progress The progress to report to and that can be used to cancel
+	 *        loading from another thread, may be nullptr.
 	 * \exception Exception Thrown if the reader cannot be created.
+	 * \exception StateException Thrown if loading has been cancelled.
 	 */
-	StreamBuffer(std::shared_ptr<ISound> sound);
+	StreamBuffer(std::shared_ptr<ISound> sound, std::shared_ptr<ThreadPool> threadPool, StorageFormat format = STORAGE_FLOAT32, std::shared_ptr<LoadProgress> progress = nullptr);
 
 	/**
 	 * Creates the sound from an preexisting buffer.
@@ -67,9 +130,17 @@ public:
 	 */
 	StreamBuffer(std::shared_ptr<Buffer> buffer, Specs specs);
 
+	/**
+	 * Destroys the sound and releases the buffer from the cache.
+	 */
+	virtual ~StreamBuffer();
+
 	/**
 	 * Returns the buffer to be streamed.
-	 * @return The buffer to stream.
+	 * If the buffer has been evicted from the cache, it is read again.
+	 * @return The buffer to stream, as float samples.
+	 * \note Unless the samples are stored as floats, this returns a decoded
+	 *       copy.
 	 */
 	std::shared_ptr<Buffer> getBuffer();
 
@@ -79,6 +150,12 @@ public:
 	 */
 	Specs getSpecs();
 
+	/**
+	 * Returns the storage format of the samples.
+	 * @return The storage format.
+	 */
+	StorageFormat getFormat();
+
 	virtual std::shared_ptr<IReader> createReader();
 };
 
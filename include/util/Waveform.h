@@ -0,0 +1,151 @@
+/*******************************************************************************
+ * Copyright 2009-2016 Jörg Müller
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ ******************************************************************************/
+
+#pragma once
+
+/**
+ * @file Waveform.h
+ * @ingroup util
+ * The Waveform class.
+ */
+
+#include "ISound.h"
+#include "respec/Specification.h"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+AUD_NAMESPACE_BEGIN
+
+class LoadProgress;
+
+/**
+ * This class stores the peaks of a sound for drawing its waveform.
+ *
+ * The mono downmix of the sound is summarized in buckets of minimum, maximum
+ * and power, and every further level of the pyramid combines two buckets of
+ * the level below. Any zoom level can then be drawn by combining at most a
+ * few buckets per pixel.
+ */
+class AUD_API Waveform
+{
+private:
+	/// The summary of a bucket of samples.
+	struct Peak
+	{
+		/// The minimum sample.
+		float min;
+
+		/// The maximum sample.
+		float max;
+
+		/// The sum of the squared samples.
+		float power;
+	};
+
+	/**
+	 * The sample rate of the sound.
+	 */
+	SampleRate m_rate;
+
+	/**
+	 * The length of the sound in samples.
+	 */
+	long long m_length;
+
+	/**
+	 * The levels of the pyramid, level n has buckets of the base size times 2^n samples.
+	 */
+	std::vector<std::vector<Peak> > m_levels;
+
+	/**
+	 * Creates an empty waveform.
+	 */
+	AUD_LOCAL Waveform();
+
+	// delete copy constructor and operator=
+	Waveform(const Waveform&) = delete;
+	Waveform& operator=(const Waveform&) = delete;
+
+public:
+	/**
+	 * Computes the waveform of a sound by decoding it completely.
+	 * \param sound The sound to analyze.
+	 * \param progress The progress to report to and check for cancellation,
+	 *        may be nullptr.
+	 * \return The waveform.
+	 * \exception Exception Thrown if the sound cannot be read or computing
+	 *            has been cancelled.
+	 */
+	static std::shared_ptr<Waveform> compute(std::shared_ptr<ISound> sound, std::shared_ptr<LoadProgress> progress = nullptr);
+
+	/**
+	 * Loads a waveform that has been saved before.
+	 * \param filename The file to load from.
+	 * \param stamp The stamp that has been saved with the waveform.
+	 * \return The waveform or nullptr if the file doesn't exist, is invalid
+	 *         or has a different stamp.
+	 */
+	static std::shared_ptr<Waveform> load(std::string filename, unsigned long long stamp);
+
+	/**
+	 * Saves the waveform to a file in native byte order.
+	 * \param filename The file to save to.
+	 * \param stamp A value identifying the version of the source, for example
+	 *        derived from its size and modification time.
+	 * \return Whether saving succeeded.
+	 */
+	bool save(std::string filename, unsigned long long stamp) const;
+
+	/**
+	 * Returns the sample rate of the sound.
+	 * \return The sample rate.
+	 */
+	SampleRate getRate() const;
+
+	/**
+	 * Returns the length of the sound.
+	 * \return The length in samples.
+	 */
+	long long getLength() const;
+
+	/**
+	 * Returns the largest absolute sample value of the whole sound.
+	 * \return The peak value.
+	 */
+	float getPeak() const;
+
+	/**
+	 * Returns the memory used by the peaks.
+	 * \return The size of all levels in bytes.
+	 */
+	size_t getSize() const;
+
+	/**
+	 * Reads the peaks for drawing at a specific zoom level.
+	 * \param buffer The buffer to write minimum, maximum and RMS of every
+	 *        pixel to. Must have a size of 3*4*length.
+	 * \param length The number of pixels to read.
+	 * \param start The time of the first pixel in seconds.
+	 * \param pixels_per_second How many pixels a second of the sound spans.
+	 * \return How many pixels have been read, less than length at the end of
+	 *         the sound.
+	 */
+	int read(float* buffer, int length, double start, double pixels_per_second) const;
+};
+
+AUD_NAMESPACE_END
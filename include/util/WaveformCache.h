@@ -0,0 +1,110 @@
+/*******************************************************************************
+ * Copyright 2009-2016 Jörg Müller
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ ******************************************************************************/
+
+#pragma once
+
+/**
+ * @file WaveformCache.h
+ * @ingroup util
+ * The WaveformCache class.
+ */
+
+#include "util/Waveform.h"
+
+#include <future>
+#include <string>
+
+AUD_NAMESPACE_BEGIN
+
+/**
+ * This class computes the waveforms of sound files in the background and
+ * keeps them for later requests.
+ *
+ * Waveforms are computed on the shared decode thread pool, so several files
+ * are analyzed in parallel. Every waveform is also saved to a sidecar file,
+ * which is used instead of decoding the sound again as long as the size and
+ * modification time of the sound file didn't change.
+ *
+ * When the waveforms kept in memory exceed the budget, the least recently
+ * requested ones are forgotten. Waveforms that failed to compute are not
+ * kept, so the next request tries again.
+ */
+class AUD_API WaveformCache
+{
+private:
+	// static only
+	WaveformCache() = delete;
+
+public:
+	/**
+	 * Returns the waveform of a sound file, computing it if necessary.
+	 * \param filename The path of the sound file.
+	 * \return A future of the waveform, which throws an Exception if the file
+	 *         cannot be read.
+	 */
+	static std::shared_future<std::shared_ptr<Waveform> > get(std::string filename);
+
+	/**
+	 * Sets the directory the sidecar files are stored in.
+	 * \param directory The directory or an empty string to store the sidecar
+	 *        files next to the sound files, which is the default.
+	 */
+	static void setDirectory(std::string directory);
+
+	/**
+	 * Returns the directory the sidecar files are stored in.
+	 * \return The directory, empty if they are stored next to the sound files.
+	 */
+	static std::string getDirectory();
+
+	/**
+	 * Enables or disables saving and loading sidecar files.
+	 * \param persistent Whether sidecar files are used, the default is true.
+	 */
+	static void setPersistent(bool persistent);
+
+	/**
+	 * Returns whether sidecar files are used.
+	 * \return Whether sidecar files are used.
+	 */
+	static bool isPersistent();
+
+	/**
+	 * Sets the memory budget for waveforms kept in memory.
+	 * \param bytes The maximum size of all waveforms in bytes or 0 for no
+	 *        limit, the default is 64 MiB.
+	 */
+	static void setBudget(size_t bytes);
+
+	/**
+	 * Returns the memory budget for waveforms kept in memory.
+	 * \return The maximum size of all waveforms in bytes, 0 if unlimited.
+	 */
+	static size_t getBudget();
+
+	/**
+	 * Returns the memory currently used by waveforms kept in memory.
+	 * \return The size of all computed waveforms in bytes.
+	 */
+	static size_t getMemoryUsage();
+
+	/**
+	 * Forgets all waveforms kept in memory, sidecar files stay.
+	 */
+	static void clear();
+};
+
+AUD_NAMESPACE_END
@@ -19,6 +19,8 @@
 #include "FFMPEGWriter.h"
 #include "file/FileManager.h"
 
+#include <cstring>
+
 AUD_NAMESPACE_BEGIN
 
 FFMPEG::FFMPEG()
@@ -43,6 +45,36 @@ std::shared_ptr<IReader> FFMPEG::createReader(std::shared_ptr<Buffer> buffer)
 	return std::shared_ptr<IReader>(new FFMPEGReader(buffer));
 }
 
+ProbeResult FFMPEG::probe(const unsigned char* header, int size, const std::string& extension)
+{
+	static const char* magics[] = {"ID3", "OggS", "fLaC", "RIFF", "RF64", "FORM", "caff", "wvpk", "MAC ", "#!AMR", "\x1A\x45\xDF\xA3", "\x30\x26\xB2\x75", nullptr};
+	static const char* extensions[] = {"aac", "ac3", "aif", "aiff", "flac", "m4a", "mka", "mkv", "mov", "mp2", "mp3", "mp4", "oga", "ogg", "opus", "wav", "webm", "wma", nullptr};
+
+	for(int i = 0; magics[i]; i++)
+	{
+		int length = std::strlen(magics[i]);
+
+		if(size >= length && !std::memcmp(header, magics[i], length))
+			return PROBE_SUPPORTED;
+	}
+
+	// MPEG audio frames and ADTS start with a sync word, MP4 with an ftyp box
+	if(size >= 2 && header[0] == 0xFF && (header[1] & 0xE0) == 0xE0)
+		return PROBE_SUPPORTED;
+
+	if(size >= 8 && !std::memcmp(header + 4, "ftyp", 4))
+		return PROBE_SUPPORTED;
+
+	for(int i = 0; extensions[i]; i++)
+	{
+		if(extension == extensions[i])
+			return PROBE_SUPPORTED;
+	}
+
+	// ffmpeg has its own probing for everything else
+	return PROBE_UNKNOWN;
+}
+
 std::shared_ptr<IWriter> FFMPEG::createWriter(std::string filename, DeviceSpecs specs, Container format, Codec codec, unsigned int bitrate)
 {
 	return std::shared_ptr<IWriter>(new FFMPEGWriter(filename, specs, format, codec, bitrate));
@@ -15,17 +15,41 @@
  ******************************************************************************/
 
 #include "FFMPEGReader.h"
+#include "file/FileManager.h"
 #include "Exception.h"
 
 #include <algorithm>
+#include <chrono>
 
 extern "C" {
 #include <libavcodec/avcodec.h>
 #include <libavformat/avio.h>
 }
 
+/// Packets decoded and discarded before the target packet when seeking with the index.
+#define AUD_FFMPEG_SEEK_PREROLL 1
+
+/// Maximum time in milliseconds the decoding thread sleeps before checking for free ring buffer space.
+#define AUD_FFMPEG_DECODE_WAKEUP 10
+
 AUD_NAMESPACE_BEGIN
 
+static inline bool packet_before(const AVPacket& packet, const FFMPEGSeekIndex::Entry& entry)
+{
+	if(packet.pts != AV_NOPTS_VALUE && entry.pts != AV_NOPTS_VALUE)
+		return packet.pts < entry.pts;
+
+	return packet.pos >= 0 && entry.pos >= 0 && packet.pos < entry.pos;
+}
+
+static inline bool packet_at(const AVPacket& packet, const FFMPEGSeekIndex::Entry& entry)
+{
+	if(packet.pts != AV_NOPTS_VALUE && entry.pts != AV_NOPTS_VALUE)
+		return packet.pts == entry.pts;
+
+	return packet.pos >= 0 && packet.pos == entry.pos;
+}
+
 int FFMPEGReader::decode(AVPacket& packet, Buffer& buffer)
 {
 	AVFrame* frame = nullptr;
@@ -92,6 +116,10 @@ void FFMPEGReader::init()
 {
 	m_position = 0;
 	m_pkgbuf_left = 0;
+	m_readahead = 0;
+	m_read_position = 0;
+	m_decode_eos = false;
+	m_stop = false;
 
 	if(avformat_find_stream_info(m_formatCtx, nullptr) < 0)
 		AUD_THROW(FileException, "File couldn't be read, ffmpeg couldn't find the stream info.");
@@ -152,6 +180,69 @@ void FFMPEGReader::init()
 	}
 
 	m_specs.rate = (SampleRate) m_codecCtx->sample_rate;
+
+	setReadAhead(FileManager::getReadAhead());
+}
+
+void FFMPEGReader::startDecoding()
+{
+	int block = std::min(m_readahead, AUD_DEFAULT_BUFFER_SIZE);
+
+	m_ring.resize(m_readahead * m_specs.channels);
+	m_decodebuf.assureSize(block * AUD_SAMPLE_SIZE(m_specs));
+	m_decode_eos = false;
+	m_stop = false;
+
+	m_thread = std::thread(&FFMPEGReader::decodeThread, this);
+}
+
+void FFMPEGReader::stopDecoding()
+{
+	if(!m_thread.joinable())
+		return;
+
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_stop = true;
+	}
+
+	m_condition.notify_all();
+	m_thread.join();
+}
+
+void FFMPEGReader::decodeThread()
+{
+	int channels = m_specs.channels;
+	int block = std::min(m_readahead, AUD_DEFAULT_BUFFER_SIZE);
+
+	for(;;)
+	{
+		{
+			std::unique_lock<std::mutex> lock(m_mutex);
+
+			// the reader doesn't lock when it frees space, so don't rely on being notified
+			while(!m_stop && (m_decode_eos || m_ring.getWriteSpace() < block * channels))
+				m_condition.wait_for(lock, std::chrono::milliseconds(AUD_FFMPEG_DECODE_WAKEUP));
+
+			if(m_stop)
+				return;
+		}
+
+		std::lock_guard<std::mutex> decode_lock(m_decode_mutex);
+
+		int length = block;
+		bool eos;
+
+		readDirect(length, eos, m_decodebuf.getBuffer());
+		m_ring.write(m_decodebuf.getBuffer(), length * channels);
+
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			m_decode_eos = eos;
+		}
+
+		m_condition.notify_all();
+	}
 }
 
 FFMPEGReader::FFMPEGReader(std::string filename) :
@@ -173,6 +264,8 @@ FFMPEGReader::FFMPEGReader(std::string filename) :
 		avformat_close_input(&m_formatCtx);
 		throw;
 	}
+
+	m_index = FFMPEGSeekIndex::get(filename, m_stream, m_specs.rate);
 }
 
 FFMPEGReader::FFMPEGReader(std::shared_ptr<Buffer> buffer) :
@@ -212,6 +305,7 @@ FFMPEGReader::FFMPEGReader(std::shared_ptr<Buffer> buffer) :
 
 FFMPEGReader::~FFMPEGReader()
 {
+	stopDecoding();
 	avcodec_close(m_codecCtx);
 	avformat_close_input(&m_formatCtx);
 }
@@ -255,10 +349,86 @@ bool FFMPEGReader::isSeekable() const
 	return true;
 }
 
-void FFMPEGReader::seek(int position)
+bool FFMPEGReader::isSeekAccurate() const
+{
+	// without index seeking depends on the demuxer and may be off
+	return m_index && m_index->isComplete();
+}
+
+bool FFMPEGReader::seekIndexed(int position)
+{
+	FFMPEGSeekIndex::Entry start;
+	FFMPEGSeekIndex::Entry target;
+
+	if(!m_index->find(position, AUD_FFMPEG_SEEK_PREROLL, start, target))
+		return false;
+
+	int result;
+
+	if(start.pts != AV_NOPTS_VALUE)
+		result = av_seek_frame(m_formatCtx, m_stream, start.pts, AVSEEK_FLAG_BACKWARD);
+	else if(start.pos >= 0)
+		result = av_seek_frame(m_formatCtx, m_stream, start.pos, AVSEEK_FLAG_BYTE);
+	else
+		return false;
+
+	if(result < 0)
+		return false;
+
+	avcodec_flush_buffers(m_codecCtx);
+	m_pkgbuf_left = 0;
+
+	AVPacket packet;
+	bool found = false;
+	bool passed = false;
+
+	while(!found && !passed && av_read_frame(m_formatCtx, &packet) >= 0)
+	{
+		if(packet.stream_index == m_stream && !packet_before(packet, start))
+		{
+			// the pre-roll packets only prime the decoder, their output is dropped
+			int size = decode(packet, m_pkgbuf);
+
+			if(!packet_before(packet, target))
+			{
+				// if the demuxer skipped the target packet the position is unknown
+				if(packet_at(packet, target))
+				{
+					m_pkgbuf_left = size;
+					m_position = target.sample;
+					found = true;
+				}
+				else
+					passed = true;
+			}
+		}
+		av_free_packet(&packet);
+	}
+
+	if(!found)
+		return false;
+
+	// read until we're at the right position
+	int length = AUD_DEFAULT_BUFFER_SIZE;
+	Buffer buffer(length * AUD_SAMPLE_SIZE(m_specs));
+	bool eos = false;
+	for(int len = position - m_position; len > 0 && !eos; len -= AUD_DEFAULT_BUFFER_SIZE)
+	{
+		if(len < AUD_DEFAULT_BUFFER_SIZE)
+			length = len;
+		readDirect(length, eos, buffer.getBuffer());
+	}
+
+	return true;
+}
+
+void FFMPEGReader::seekDirect(int position)
 {
 	if(position >= 0)
 	{
+		if(m_index && seekIndexed(position))
+			return;
+
 		uint64_t st_time = m_formatCtx->start_time;
 		uint64_t seek_pos = ((uint64_t)position) * ((uint64_t)AV_TIME_BASE) / ((uint64_t)m_specs.rate);
 
@@ -307,7 +477,7 @@ void FFMPEGReader::seek(int position)
 							{
 								if(len < AUD_DEFAULT_BUFFER_SIZE)
 									length = len;
-								read(length, eos, buffer.getBuffer());
+								readDirect(length, eos, buffer.getBuffer());
 							}
 						}
 					}
@@ -323,16 +493,42 @@ void FFMPEGReader::seek(int position)
 	}
 }
 
+void FFMPEGReader::seek(int position)
+{
+	if(!m_readahead)
+	{
+		seekDirect(position);
+		return;
+	}
+
+	if(position < 0)
+		return;
+
+	std::lock_guard<std::mutex> decode_lock(m_decode_mutex);
+
+	// the decoding thread is blocked and we are the only reader, so flushing is safe
+	m_ring.reset();
+	seekDirect(position);
+	m_read_position = m_position;
+
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_decode_eos = false;
+	}
+
+	m_condition.notify_all();
+}
+
 int FFMPEGReader::getLength() const
 {
 	// return approximated remaning size
 	return (int)((m_formatCtx->duration * m_codecCtx->sample_rate)
-				 / AV_TIME_BASE)-m_position;
+				 / AV_TIME_BASE)-getPosition();
 }
 
 int FFMPEGReader::getPosition() const
 {
-	return m_position;
+	return m_readahead ? m_read_position : m_position;
 }
 
 Specs FFMPEGReader::getSpecs() const
@@ -340,7 +536,7 @@ Specs FFMPEGReader::getSpecs() const
 	return m_specs.specs;
 }
 
-void FFMPEGReader::read(int& length, bool& eos, sample_t* buffer)
+void FFMPEGReader::readDirect(int& length, bool& eos, sample_t* buffer)
 {
 	// read packages and decode them
 	AVPacket packet;
@@ -394,4 +590,63 @@ void FFMPEGReader::read(int& length, bool& eos, sample_t* buffer)
 	m_position += length;
 }
 
+void FFMPEGReader::read(int& length, bool& eos, sample_t* buffer)
+{
+	if(!m_readahead)
+	{
+		readDirect(length, eos, buffer);
+		return;
+	}
+
+	int channels = m_specs.channels;
+	int done = m_ring.read(buffer, length * channels) / channels;
+
+	if(done < length)
+	{
+		// the decoding thread fell behind, wait for it
+		std::unique_lock<std::mutex> lock(m_mutex);
+
+		for(;;)
+		{
+			done += m_ring.read(buffer + done * channels, (length - done) * channels) / channels;
+
+			if(done == length || (m_decode_eos && !m_ring.getReadSpace()))
+				break;
+
+			m_condition.notify_all();
+			m_condition.wait(lock);
+		}
+	}
+
+	m_condition.notify_all();
+
+	eos = done < length;
+	length = done;
+
+	m_read_position += length;
+}
+
+void FFMPEGReader::setReadAhead(int length)
+{
+	if(length < 0)
+		length = 0;
+
+	stopDecoding();
+
+	// samples already decoded but not read yet are dropped
+	if(m_readahead && m_ring.getReadSpace())
+		seekDirect(m_read_position);
+
+	m_readahead = length;
+	m_read_position = m_position;
+
+	if(m_readahead)
+		startDecoding();
+}
+
+int FFMPEGReader::getReadAhead() const
+{
+	return m_readahead;
+}
+
 AUD_NAMESPACE_END
@@ -28,10 +28,15 @@
 
 #include "respec/ConverterFunctions.h"
 #include "IReader.h"
+#include "FFMPEGSeekIndex.h"
 #include "util/Buffer.h"
+#include "util/RingBuffer.h"
 
 #include <string>
 #include <memory>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
 
 struct AVCodecContext;
 extern "C" {
@@ -42,7 +47,17 @@ AUD_NAMESPACE_BEGIN
 
 /**
  * This class reads a sound file via ffmpeg.
- * \warning Seeking may not be accurate! Moreover the position is updated after
+ *
+ * Optionally the reader decodes asynchronously: a background thread then
+ * decodes up to the read-ahead window in advance into a lock-free ring buffer
+ * and read only copies the samples out, so that slow disks or expensive codec
+ * frames don't stall the thread pulling the reader. Seeking flushes the ring
+ * buffer and restarts decoding at the new position.
+ *
+ * If seek indexing is enabled in the FileManager, readers of files share a
+ * FFMPEGSeekIndex, which makes seeking sample accurate and cheap once the
+ * packets around the target are indexed.
+ * \warning Seeking may not be accurate if the file isn't indexed yet! Moreover the position is updated after
  *          a buffer reading call. So calling getPosition right after seek
  *          normally results in a wrong value.
  */
@@ -114,6 +129,62 @@ private:
 	 */
 	bool m_tointerleave;
 
+	/**
+	 * The packet index for sample accurate seeking, shared between readers.
+	 */
+	std::shared_ptr<FFMPEGSeekIndex> m_index;
+
+	/**
+	 * The read-ahead window in samples, 0 for synchronous decoding.
+	 */
+	int m_readahead;
+
+	/**
+	 * The position of the reader when decoding asynchronously.
+	 */
+	int m_read_position;
+
+	/**
+	 * The ring buffer holding samples decoded in advance.
+	 */
+	RingBuffer m_ring;
+
+	/**
+	 * The buffer the decoding thread decodes into.
+	 */
+	Buffer m_decodebuf;
+
+	/**
+	 * The decoding thread.
+	 */
+	std::thread m_thread;
+
+	/**
+	 * Mutex for the decoding thread state and the condition.
+	 */
+	std::mutex m_mutex;
+
+	/**
+	 * Mutex held while the decoder is in use, so that seeking can exclude
+	 * the decoding thread.
+	 */
+	std::mutex m_decode_mutex;
+
+	/**
+	 * Condition to wake up the decoding thread or a reader waiting for data.
+	 */
+	std::condition_variable m_condition;
+
+	/**
+	 * Whether the decoding thread has reached the end of the stream.
+	 */
+	bool m_decode_eos;
+
+	/**
+	 * Whether the decoding thread should stop.
+	 */
+	bool m_stop;
+
 	/**
 	 * Decodes a packet into the given buffer.
 	 * \param packet The AVPacket to decode.
@@ -127,6 +198,44 @@ private:
 	 */
 	AUD_LOCAL void init();
 
+	/**
+	 * Decodes samples synchronously, see IReader::read.
+	 * \param[in,out] length The count of samples that should be read.
+	 * \param[out] eos End of stream, whether the end is reached or not.
+	 * \param[in] buffer The pointer to the buffer to read into.
+	 */
+	AUD_LOCAL void readDirect(int& length, bool& eos, sample_t* buffer);
+
+	/**
+	 * Seeks the decoder synchronously, see IReader::seek.
+	 * \param position The new position in the stream.
+	 */
+	AUD_LOCAL void seekDirect(int position);
+
+	/**
+	 * Seeks sample accurately using the seek index.
+	 * \param position The new position in the stream.
+	 * \return Whether seeking succeeded, false if the index doesn't cover
+	 *         the position yet or the demuxer didn't land on the indexed
+	 *         packet.
+	 */
+	AUD_LOCAL bool seekIndexed(int position);
+
+	/**
+	 * Starts the decoding thread.
+	 */
+	AUD_LOCAL void startDecoding();
+
+	/**
+	 * Stops the decoding thread.
+	 */
+	AUD_LOCAL void stopDecoding();
+
+	/**
+	 * The decoding thread function.
+	 */
+	AUD_LOCAL void decodeThread();
+
 	// delete copy constructor and operator=
 	FFMPEGReader(const FFMPEGReader&) = delete;
 	FFMPEGReader& operator=(const FFMPEGReader&) = delete;
@@ -173,12 +282,26 @@ public:
 	 */
 	static int64_t seek_packet(void* opaque, int64_t offset, int whence);
 
+	/**
+	 * Sets the read-ahead window of the reader.
+	 * \param length The amount of samples to decode in advance on a
+	 *        background thread or 0 to decode synchronously while reading.
+	 */
+	void setReadAhead(int length);
+
+	/**
+	 * Returns the read-ahead window of the reader.
+	 * \return The amount of samples decoded in advance, 0 if synchronous.
+	 */
+	int getReadAhead() const;
+
 	virtual bool isSeekable() const;
 	virtual void seek(int position);
 	virtual int getLength() const;
 	virtual int getPosition() const;
 	virtual Specs getSpecs() const;
 	virtual void read(int& length, bool& eos, sample_t* buffer);
+	virtual bool isSeekAccurate() const;
 };
 
 AUD_NAMESPACE_END
@@ -0,0 +1,270 @@
+/*******************************************************************************
+ * Copyright 2009-2016 Jörg Müller
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ ******************************************************************************/
+
+#include "FFMPEGSeekIndex.h"
+#include "file/FileManager.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <functional>
+#include <map>
+#include <sys/stat.h>
+
+extern "C" {
+#include <libavcodec/avcodec.h>
+#include <libavformat/avformat.h>
+}
+
+/// Magic bytes at the start of a persistent index file.
+#define AUD_SEEK_INDEX_MAGIC "AUDSIDX1"
+
+AUD_NAMESPACE_BEGIN
+
+static std::mutex& registry_mutex()
+{
+	static std::mutex mutex;
+	return mutex;
+}
+
+/// The identity of an index file, to detect when the indexed file changed.
+struct FileIdentity
+{
+	uint64_t size;
+	int64_t mtime;
+	int32_t stream;
+	double rate;
+};
+
+static bool get_identity(const std::string& filename, int stream, double rate, FileIdentity& identity)
+{
+	struct stat info;
+
+	if(stat(filename.c_str(), &info) != 0)
+		return false;
+
+	std::memset(&identity, 0, sizeof(identity));
+	identity.size = uint64_t(info.st_size);
+	identity.mtime = int64_t(info.st_mtime);
+	identity.stream = stream;
+	identity.rate = rate;
+
+	return true;
+}
+
+FFMPEGSeekIndex::FFMPEGSeekIndex(std::string filename, int stream, double rate) :
+	m_filename(filename), m_stream(stream), m_rate(rate), m_complete(false), m_stop(false)
+{
+	std::string directory = FileManager::getSeekIndexDirectory();
+
+	if(!directory.empty())
+	{
+		char name[32];
+		std::snprintf(name, sizeof(name), "%016llx", (unsigned long long)std::hash<std::string>()(filename + ":" + std::to_string(stream)));
+		m_cache_path = directory + "/" + name + ".audidx";
+	}
+
+	if(load())
+		m_complete = true;
+	else
+		m_thread = std::thread(&FFMPEGSeekIndex::build, this);
+}
+
+FFMPEGSeekIndex::~FFMPEGSeekIndex()
+{
+	m_stop = true;
+
+	if(m_thread.joinable())
+		m_thread.join();
+}
+
+void FFMPEGSeekIndex::build()
+{
+	AVFormatContext* formatCtx = nullptr;
+
+	if(avformat_open_input(&formatCtx, m_filename.c_str(), nullptr, nullptr) != 0)
+		return;
+
+	if(avformat_find_stream_info(formatCtx, nullptr) < 0 || m_stream >= int(formatCtx->nb_streams))
+	{
+		avformat_close_input(&formatCtx);
+		return;
+	}
+
+	// positions are calculated the same way the reader does it
+	double pts_time_base = av_q2d(formatCtx->streams[m_stream]->time_base);
+	int64_t st_time = formatCtx->start_time;
+	int64_t pts_st_time = ((st_time != AV_NOPTS_VALUE) ? st_time : 0) / pts_time_base / AV_TIME_BASE;
+
+	int64_t next = 0;
+	AVPacket packet;
+
+	while(!m_stop && av_read_frame(formatCtx, &packet) >= 0)
+	{
+		if(packet.stream_index == m_stream)
+		{
+			Entry entry;
+			entry.pts = packet.pts;
+			entry.pos = packet.pos;
+
+			if(packet.pts != AV_NOPTS_VALUE)
+				entry.sample = int64_t(std::floor((packet.pts - pts_st_time) * pts_time_base * m_rate + 0.5));
+			else
+				entry.sample = next;
+
+			next = entry.sample;
+
+			if(packet.duration > 0)
+				next += int64_t(std::floor(packet.duration * pts_time_base * m_rate + 0.5));
+
+			std::lock_guard<std::mutex> lock(m_mutex);
+
+			// packets that don't advance the position can't be seeked to
+			if(m_entries.empty() || entry.sample > m_entries.back().sample)
+				m_entries.push_back(entry);
+		}
+
+		av_free_packet(&packet);
+	}
+
+	bool complete = !m_stop;
+
+	avformat_close_input(&formatCtx);
+
+	if(complete)
+	{
+		m_complete = true;
+		save();
+	}
+}
+
+bool FFMPEGSeekIndex::load()
+{
+	FileIdentity identity, stored;
+
+	if(m_cache_path.empty() || !get_identity(m_filename, m_stream, m_rate, identity))
+		return false;
+
+	std::FILE* file = std::fopen(m_cache_path.c_str(), "rb");
+
+	if(!file)
+		return false;
+
+	char magic[8];
+	uint64_t count = 0;
+	bool valid = std::fread(magic, sizeof(magic), 1, file) == 1 && !std::memcmp(magic, AUD_SEEK_INDEX_MAGIC, sizeof(magic)) &&
+				 std::fread(&stored, sizeof(stored), 1, file) == 1 && !std::memcmp(&stored, &identity, sizeof(identity)) &&
+				 std::fread(&count, sizeof(count), 1, file) == 1;
+
+	if(valid)
+	{
+		std::vector<Entry> entries(count);
+
+		if(count && std::fread(&entries[0], sizeof(Entry), count, file) != count)
+			valid = false;
+		else
+			m_entries.swap(entries);
+	}
+
+	std::fclose(file);
+
+	return valid;
+}
+
+void FFMPEGSeekIndex::save()
+{
+	FileIdentity identity;
+
+	if(m_cache_path.empty() || !get_identity(m_filename, m_stream, m_rate, identity))
+		return;
+
+	// write to a temporary file first, so that concurrent loads never see a partial index
+	std::string temp = m_cache_path + ".tmp";
+	std::FILE* file = std::fopen(temp.c_str(), "wb");
+
+	if(!file)
+		return;
+
+	uint64_t count = m_entries.size();
+	bool valid = std::fwrite(AUD_SEEK_INDEX_MAGIC, 8, 1, file) == 1 &&
+				 std::fwrite(&identity, sizeof(identity), 1, file) == 1 &&
+				 std::fwrite(&count, sizeof(count), 1, file) == 1 &&
+				 (!count || std::fwrite(&m_entries[0], sizeof(Entry), count, file) == count);
+
+	std::fclose(file);
+
+	if(!valid || std::rename(temp.c_str(), m_cache_path.c_str()) != 0)
+		std::remove(temp.c_str());
+}
+
+std::shared_ptr<FFMPEGSeekIndex> FFMPEGSeekIndex::get(std::string filename, int stream, double rate)
+{
+	if(!FileManager::isSeekIndexing())
+		return nullptr;
+
+	static std::map<std::pair<std::string, int>, std::weak_ptr<FFMPEGSeekIndex>> indices;
+
+	std::lock_guard<std::mutex> lock(registry_mutex());
+
+	auto key = std::make_pair(filename, stream);
+	std::shared_ptr<FFMPEGSeekIndex> index = indices[key].lock();
+
+	if(!index || index->m_rate != rate)
+	{
+		index = std::shared_ptr<FFMPEGSeekIndex>(new FFMPEGSeekIndex(filename, stream, rate));
+		indices[key] = index;
+	}
+
+	// forget indices that aren't used anymore
+	for(auto it = indices.begin(); it != indices.end();)
+	{
+		if(it->second.expired())
+			it = indices.erase(it);
+		else
+			++it;
+	}
+
+	return index;
+}
+
+bool FFMPEGSeekIndex::find(int64_t position, int preroll, Entry& start, Entry& target)
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+
+	auto it = std::upper_bound(m_entries.begin(), m_entries.end(), position, [](int64_t position, const Entry& entry) { return position < entry.sample; });
+
+	if(it == m_entries.begin())
+		return false;
+
+	// the packet containing the position might not be indexed yet
+	if(it == m_entries.end() && !m_complete)
+		return false;
+
+	size_t index = (it - m_entries.begin()) - 1;
+
+	target = m_entries[index];
+	start = m_entries[index >= size_t(preroll) ? index - preroll : 0];
+
+	return true;
+}
+
+bool FFMPEGSeekIndex::isComplete() const
+{
+	return m_complete;
+}
+
+AUD_NAMESPACE_END
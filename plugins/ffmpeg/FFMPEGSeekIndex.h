@@ -0,0 +1,177 @@
+/*******************************************************************************
+ * Copyright 2009-2016 Jörg Müller
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ ******************************************************************************/
+
+#pragma once
+
+#ifdef FFMPEG_PLUGIN
+#define AUD_BUILD_PLUGIN
+#endif
+
+/**
+ * @file FFMPEGSeekIndex.h
+ * @ingroup plugin
+ * The FFMPEGSeekIndex class.
+ */
+
+#include "Audaspace.h"
+
+#include <string>
+#include <memory>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <stdint.h>
+
+AUD_NAMESPACE_BEGIN
+
+/**
+ * This class maps sample positions of an audio stream to the packets that
+ * contain them, so that the FFMPEGReader can seek sample accurately by
+ * jumping directly to the right packet instead of decoding forward from a
+ * keyframe.
+ *
+ * The index is built by demuxing the file without decoding on a background
+ * thread. It is shared between all readers of the same file and can
+ * optionally be stored in a cache directory so that it only has to be built
+ * once per file. Indexing and the directory are configured in the
+ * FileManager and disabled by default.
+ */
+class AUD_PLUGIN_API FFMPEGSeekIndex
+{
+public:
+	/// An index entry describing one packet.
+	struct Entry
+	{
+		/// The sample position of the first sample in the packet.
+		int64_t sample;
+
+		/// The presentation time stamp of the packet in stream time base.
+		int64_t pts;
+
+		/// The byte position of the packet in the file.
+		int64_t pos;
+	};
+
+private:
+	/**
+	 * The indexed file.
+	 */
+	std::string m_filename;
+
+	/**
+	 * The indexed stream.
+	 */
+	int m_stream;
+
+	/**
+	 * The sample rate of the stream.
+	 */
+	double m_rate;
+
+	/**
+	 * The path of the persistent index file, empty if persistence is disabled.
+	 */
+	std::string m_cache_path;
+
+	/**
+	 * The packet entries sorted by sample position.
+	 */
+	std::vector<Entry> m_entries;
+
+	/**
+	 * Whether the whole file has been indexed.
+	 */
+	std::atomic<bool> m_complete;
+
+	/**
+	 * Whether the indexing thread should stop.
+	 */
+	std::atomic<bool> m_stop;
+
+	/**
+	 * Mutex for the entries.
+	 */
+	std::mutex m_mutex;
+
+	/**
+	 * The indexing thread.
+	 */
+	std::thread m_thread;
+
+	/**
+	 * The indexing thread function.
+	 */
+	AUD_LOCAL void build();
+
+	/**
+	 * Loads the index from the cache directory.
+	 * \return Whether a valid index has been loaded.
+	 */
+	AUD_LOCAL bool load();
+
+	/**
+	 * Stores the index in the cache directory.
+	 */
+	AUD_LOCAL void save();
+
+	/**
+	 * Creates a new index and starts building it if it can't be loaded.
+	 * \param filename The path of the file to index.
+	 * \param stream The audio stream to index.
+	 * \param rate The sample rate of the stream.
+	 */
+	AUD_LOCAL FFMPEGSeekIndex(std::string filename, int stream, double rate);
+
+	// delete copy constructor and operator=
+	FFMPEGSeekIndex(const FFMPEGSeekIndex&) = delete;
+	FFMPEGSeekIndex& operator=(const FFMPEGSeekIndex&) = delete;
+
+public:
+	/**
+	 * Stops indexing and destroys the index.
+	 */
+	~FFMPEGSeekIndex();
+
+	/**
+	 * Returns the index for a stream of a file, shared with other readers of
+	 * the same file.
+	 * \param filename The path of the file.
+	 * \param stream The audio stream in the file.
+	 * \param rate The sample rate of the stream.
+	 * \return The index or nullptr if seek indexing is disabled.
+	 */
+	static std::shared_ptr<FFMPEGSeekIndex> get(std::string filename, int stream, double rate);
+
+	/**
+	 * Looks up the packets needed to seek to a sample position.
+	 * \param position The sample position to seek to.
+	 * \param preroll The amount of packets to decode and discard before the
+	 *        target packet to prime the decoder.
+	 * \param[out] start The first packet to decode.
+	 * \param[out] target The packet containing the position.
+	 * \return Whether the position is covered by the index yet.
+	 */
+	bool find(int64_t position, int preroll, Entry& start, Entry& target);
+
+	/**
+	 * Returns whether the whole file has been indexed.
+	 * \return Whether indexing is complete.
+	 */
+	bool isComplete() const;
+};
+
+AUD_NAMESPACE_END
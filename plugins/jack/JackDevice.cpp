@@ -17,6 +17,7 @@
 #include "JackDevice.h"
 #include "devices/DeviceManager.h"
 #include "devices/IDeviceFactory.h"
+#include "util/DenormalGuard.h"
 #include "Exception.h"
 #include "IReader.h"
 
@@ -36,6 +37,8 @@ void JackDevice::updateRingBuffers()
 	jack_transport_state_t state;
 	jack_position_t position;
 
+	DenormalGuard guard;
+
 	std::unique_lock<std::mutex> lock(m_mixingLock);
 
 	while(m_valid)
@@ -19,6 +19,8 @@
 #include "SndFileWriter.h"
 #include "file/FileManager.h"
 
+#include <cstring>
+
 AUD_NAMESPACE_BEGIN
 
 SndFile::SndFile()
@@ -42,6 +44,23 @@ std::shared_ptr<IReader> SndFile::createReader(std::shared_ptr<Buffer> buffer)
 	return std::shared_ptr<IReader>(new SndFileReader(buffer));
 }
 
+ProbeResult SndFile::probe(const unsigned char* header, int size, const std::string& extension)
+{
+	static const char* magics[] = {"RIFF", "RF64", "FORM", "fLaC", "OggS", "caff", ".snd", "wvpk", nullptr};
+
+	if(size >= 4)
+	{
+		for(int i = 0; magics[i]; i++)
+		{
+			if(!std::memcmp(header, magics[i], 4))
+				return PROBE_SUPPORTED;
+		}
+	}
+
+	// libsndfile also reads formats without a signature
+	return PROBE_UNKNOWN;
+}
+
 std::shared_ptr<IWriter> SndFile::createWriter(std::string filename, DeviceSpecs specs, Container format, Codec codec, unsigned int bitrate)
 {
 	return std::shared_ptr<IWriter>(new SndFileWriter(filename, specs, format, codec, bitrate));
@@ -54,6 +54,7 @@ public:
 
 	virtual std::shared_ptr<IReader> createReader(std::string filename);
 	virtual std::shared_ptr<IReader> createReader(std::shared_ptr<Buffer> buffer);
+	virtual ProbeResult probe(const unsigned char* header, int size, const std::string& extension);
 	virtual std::shared_ptr<IWriter> createWriter(std::string filename, DeviceSpecs specs, Container format, Codec codec, unsigned int bitrate);
 };
 
@@ -18,6 +18,7 @@
 #include "devices/DeviceManager.h"
 #include "devices/IDeviceFactory.h"
 #include "respec/ConverterReader.h"
+#include "util/DenormalGuard.h"
 #include "Exception.h"
 #include "ISound.h"
 
@@ -848,6 +849,8 @@ void OpenALDevice::updateStreams()
 
 	auto sleepDuration = std::chrono::milliseconds(20);
 
+	DenormalGuard guard;
+
 	for(;;)
 	{
 		lock();
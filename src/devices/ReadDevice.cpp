@@ -22,7 +22,7 @@
 AUD_NAMESPACE_BEGIN
 
 ReadDevice::ReadDevice(DeviceSpecs specs) :
-	m_playing(false)
+	m_playing(false), m_silent(true)
 {
 	m_specs = specs;
 
@@ -30,7 +30,7 @@ ReadDevice::ReadDevice(DeviceSpecs specs) :
 }
 
 ReadDevice::ReadDevice(Specs specs) :
-	m_playing(false)
+	m_playing(false), m_silent(true)
 {
 	m_specs.specs = specs;
 	m_specs.format = FORMAT_FLOAT32;
@@ -46,15 +46,23 @@ ReadDevice::~ReadDevice()
 bool ReadDevice::read(data_t* buffer, int length)
 {
 	if(m_playing)
-		mix(buffer, length);
+		m_silent = mix(buffer, length);
 	else
+	{
 		if(m_specs.format == FORMAT_U8)
 			std::memset(buffer, 0x80, length * AUD_DEVICE_SAMPLE_SIZE(m_specs));
 		else
 			std::memset(buffer, 0, length * AUD_DEVICE_SAMPLE_SIZE(m_specs));
+		m_silent = true;
+	}
 	return m_playing;
 }
 
+bool ReadDevice::isSilent() const
+{
+	return m_silent;
+}
+
 void ReadDevice::changeSpecs(Specs specs)
 {
 	if(!AUD_COMPARE_SPECS(specs, m_specs.specs))
@@ -20,6 +20,7 @@
 #include "respec/JOSResampleReader.h"
 #include "respec/LinearResampleReader.h"
 #include "respec/Mixer.h"
+#include "util/DenormalGuard.h"
 #include "Exception.h"
 #include "ISound.h"
 
@@ -78,7 +79,7 @@ bool SoftwareDevice::SoftwareHandle::pause(bool keep)
 }
 
 SoftwareDevice::SoftwareHandle::SoftwareHandle(SoftwareDevice* device, std::shared_ptr<IReader> reader, std::shared_ptr<PitchReader> pitch, std::shared_ptr<ResampleReader> resampler, std::shared_ptr<ChannelMapperReader> mapper, bool keep) :
-	m_reader(reader), m_pitch(pitch), m_resampler(resampler), m_mapper(mapper), m_keep(keep), m_user_pitch(1.0f), m_user_volume(1.0f), m_user_pan(0.0f), m_volume(1.0f), m_loopcount(0),
+	m_reader(reader), m_pitch(pitch), m_resampler(resampler), m_mapper(mapper), m_keep(keep), m_user_pitch(1.0f), m_user_volume(1.0f), m_user_pan(0.0f), m_volume(1.0f), m_envelope(nullptr), m_loopcount(0),
 	m_relative(true), m_volume_max(1.0f), m_volume_min(0), m_distance_max(std::numeric_limits<float>::max()),
 	m_distance_reference(1.0f), m_attenuation(1.0f), m_cone_angle_outer(M_PI), m_cone_angle_inner(M_PI), m_cone_volume_outer(0),
 	m_flags(RENDER_CONE), m_stop(nullptr), m_stop_data(nullptr), m_status(STATUS_PLAYING), m_device(device)
@@ -355,7 +356,8 @@ bool SoftwareDevice::SoftwareHandle::seek(float position)
 	if(!m_status)
 		return false;
 
-	m_reader->seek((int)(position * m_reader->getSpecs().rate));
+	// rounding keeps seeks to whole sample positions exact despite float errors
+	m_reader->seek(int(std::round(position * m_reader->getSpecs().rate)));
 
 	if(m_status == STATUS_STOPPED)
 		m_status = STATUS_PAUSED;
@@ -715,12 +717,24 @@ void SoftwareDevice::destroy()
 		m_pausedSounds.front()->stop();
 }
 
-void SoftwareDevice::mix(data_t* buffer, int length)
+void SoftwareDevice::mixSound(SoftwareHandle* sound, sample_t* buffer, int start, int length)
 {
+	if(sound->m_envelope)
+		m_mixer->mix(buffer, start, length, sound->m_volume, sound->m_envelope + start);
+	else
+		m_mixer->mix(buffer, start, length, sound->m_volume);
+}
+
+bool SoftwareDevice::mix(data_t* buffer, int length)
+{
+	DenormalGuard guard;
+
 	m_buffer.assureSize(length * AUD_SAMPLE_SIZE(m_specs));
 
 	std::lock_guard<std::recursive_mutex> lock(m_mutex);
 
+	bool silent = true;
+
 	{
 		std::shared_ptr<SoftwareDevice::SoftwareHandle> sound;
 		int len;
@@ -749,7 +763,11 @@ void SoftwareDevice::mix(data_t* buffer, int length)
 				// in case of looping
 				while(pos + len < length && sound->m_loopcount && eos)
 				{
-					m_mixer->mix(buf, pos, len, sound->m_volume);
+					if(!sound->m_reader->isSilent())
+					{
+						mixSound(sound.get(), buf, pos, len);
+						silent = false;
+					}
 
 					pos += len;
 
@@ -772,7 +790,14 @@ void SoftwareDevice::mix(data_t* buffer, int length)
 				std::cerr << "Caught exception while reading sound data during playback with software mixing: " << e.getMessage() << std::endl;
 			}
 
-			m_mixer->mix(buf, pos, len, sound->m_volume);
+			// silent blocks don't need to be mixed
+			if(len > 0 && !sound->m_reader->isSilent())
+			{
+				mixSound(sound.get(), buf, pos, len);
+				silent = false;
+			}
+
+			sound->m_envelope = nullptr;
 
 			// in case the end of the sound is reached
 			if(eos && !sound->m_loopcount)
@@ -800,6 +825,8 @@ void SoftwareDevice::mix(data_t* buffer, int length)
 		pauseSounds.clear();
 		stopSounds.clear();
 	}
+
+	return silent;
 }
 
 void SoftwareDevice::setPanning(IHandle* handle, float pan)
@@ -808,6 +835,12 @@ void SoftwareDevice::setPanning(IHandle* handle, float pan)
 	h->m_user_pan = pan;
 }
 
+void SoftwareDevice::setVolumeEnvelope(IHandle* handle, const float* envelope)
+{
+	SoftwareDevice::SoftwareHandle* h = dynamic_cast<SoftwareDevice::SoftwareHandle*>(handle);
+	h->m_envelope = envelope;
+}
+
 void SoftwareDevice::setQuality(bool quality)
 {
 	m_quality = quality;
@@ -17,6 +17,8 @@
 #include "file/File.h"
 #include "file/FileManager.h"
 #include "util/Buffer.h"
+#include "util/PageCache.h"
+#include "util/PageCacheReader.h"
 #include "Exception.h"
 
 #include <cstring>
@@ -34,12 +36,26 @@ File::File(const data_t* buffer, int size) :
 	std::memcpy(m_buffer->getBuffer(), buffer, size);
 }
 
+File::File(std::shared_ptr<Buffer> buffer) :
+	m_buffer(buffer)
+{
+}
+
 std::shared_ptr<IReader> File::createReader()
 {
 	if(m_buffer.get())
 		return FileManager::createReader(m_buffer);
-	else
-		return FileManager::createReader(m_filename);
+
+	if(PageCache::getBudget())
+	{
+		try
+		{
+			return std::shared_ptr<IReader>(new PageCacheReader(m_filename));
+		}
+		catch(Exception&) {}
+	}
+
+	return FileManager::createReader(m_filename);
 }
 
 AUD_NAMESPACE_END
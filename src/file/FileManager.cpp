@@ -17,10 +17,102 @@
 #include "file/FileManager.h"
 #include "file/IFileInput.h"
 #include "file/IFileOutput.h"
+#include "util/Buffer.h"
 #include "Exception.h"
 
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <cstdio>
+#include <mutex>
+#include <unordered_map>
+#include <sys/stat.h>
+
+// the amount of bytes read from the start of a file to recognize its format
+#define PROBE_HEADER_SIZE 64
+#define DEFAULT_PROBE_CACHE_SIZE 256
+
 AUD_NAMESPACE_BEGIN
 
+/// The file input remembered for a file.
+struct ProbeCacheEntry
+{
+	/// The file input that opened the file.
+	std::shared_ptr<IFileInput> input;
+
+	/// The size of the file when it was opened.
+	long long size;
+
+	/// The modification time of the file when it was opened.
+	long long mtime;
+
+	/// The last time the entry was used, for LRU eviction.
+	unsigned long long last_use;
+};
+
+/// The global state of the probe cache.
+struct ProbeCacheState
+{
+	/// The remembered file inputs by path.
+	std::unordered_map<std::string, ProbeCacheEntry> entries;
+
+	/// The maximum number of entries.
+	unsigned int size;
+
+	/// Incremented with every use of the cache.
+	unsigned long long clock;
+
+	/// Mutex for the cache.
+	std::mutex mutex;
+
+	ProbeCacheState() :
+		size(DEFAULT_PROBE_CACHE_SIZE), clock(0)
+	{
+	}
+};
+
+static std::atomic<int> read_ahead(0);
+static std::atomic<bool> seek_indexing(false);
+
+static std::mutex& seek_index_mutex()
+{
+	static std::mutex mutex;
+	return mutex;
+}
+
+static std::string& seek_index_directory()
+{
+	static std::string directory;
+	return directory;
+}
+
+static ProbeCacheState& probeCacheState()
+{
+	static ProbeCacheState state;
+	return state;
+}
+
+static std::string file_extension(const std::string& filename)
+{
+	std::string::size_type dot = filename.find_last_of('.');
+	std::string::size_type separator = filename.find_last_of("/\\");
+
+	if(dot == std::string::npos || (separator != std::string::npos && dot < separator))
+		return "";
+
+	std::string extension = filename.substr(dot + 1);
+	std::transform(extension.begin(), extension.end(), extension.begin(), [](unsigned char c) { return char(std::tolower(c)); });
+
+	return extension;
+}
+
+// inputs and outputs are registered while reading, for example by plugin stubs
+static std::mutex& registry_mutex()
+{
+	static std::mutex mutex;
+	return mutex;
+}
+
 std::list<std::shared_ptr<IFileInput>>& FileManager::inputs()
 {
 	static std::list<std::shared_ptr<IFileInput>> inputs;
@@ -33,33 +125,200 @@ std::list<std::shared_ptr<IFileOutput>>& FileManager::outputs()
 	return outputs;
 }
 
+std::list<std::shared_ptr<IFileInput>> FileManager::getInputs()
+{
+	std::lock_guard<std::mutex> lock(registry_mutex());
+
+	return inputs();
+}
+
+std::list<std::shared_ptr<IFileOutput>> FileManager::getOutputs()
+{
+	std::lock_guard<std::mutex> lock(registry_mutex());
+
+	return outputs();
+}
+
 void FileManager::registerInput(std::shared_ptr<IFileInput> input)
 {
+	std::lock_guard<std::mutex> lock(registry_mutex());
+
 	inputs().push_back(input);
 }
 
 void FileManager::registerOutput(std::shared_ptr<aud::IFileOutput> output)
 {
+	std::lock_guard<std::mutex> lock(registry_mutex());
+
 	outputs().push_back(output);
 }
 
+void FileManager::unregisterInput(std::shared_ptr<IFileInput> input)
+{
+	{
+		std::lock_guard<std::mutex> lock(registry_mutex());
+
+		inputs().remove(input);
+	}
+
+	ProbeCacheState& state = probeCacheState();
+
+	std::lock_guard<std::mutex> lock(state.mutex);
+
+	for(auto it = state.entries.begin(); it != state.entries.end();)
+	{
+		if(it->second.input == input)
+			it = state.entries.erase(it);
+		else
+			it++;
+	}
+}
+
+void FileManager::unregisterOutput(std::shared_ptr<IFileOutput> output)
+{
+	std::lock_guard<std::mutex> lock(registry_mutex());
+
+	outputs().remove(output);
+}
+
+std::list<std::shared_ptr<IFileInput>> FileManager::probe(const unsigned char* header, int size, const std::string& extension)
+{
+	std::list<std::shared_ptr<IFileInput>> supported;
+	std::list<std::shared_ptr<IFileInput>> unknown;
+
+	for(std::shared_ptr<IFileInput> input : getInputs())
+	{
+		switch(input->probe(header, size, extension))
+		{
+		case PROBE_SUPPORTED:
+			supported.push_back(input);
+			break;
+		case PROBE_UNKNOWN:
+			unknown.push_back(input);
+			break;
+		default:
+			break;
+		}
+	}
+
+	supported.splice(supported.end(), unknown);
+
+	return supported;
+}
+
 std::shared_ptr<IReader> FileManager::createReader(std::string filename)
 {
-	for(std::shared_ptr<IFileInput> input : inputs())
+	ProbeCacheState& state = probeCacheState();
+	struct stat info;
+
+	// not a local file, for example a URL, so try all inputs
+	if(stat(filename.c_str(), &info) != 0)
+	{
+		for(std::shared_ptr<IFileInput> input : getInputs())
+		{
+			try
+			{
+				return input->createReader(filename);
+			}
+			catch(Exception&) {}
+		}
+
+		AUD_THROW(FileException, "The file couldn't be read with any installed file reader.");
+	}
+
+	std::shared_ptr<IFileInput> cached;
+
+	{
+		std::lock_guard<std::mutex> lock(state.mutex);
+
+		auto it = state.entries.find(filename);
+
+		if(it != state.entries.end())
+		{
+			if(it->second.size == (long long)info.st_size && it->second.mtime == (long long)info.st_mtime)
+			{
+				it->second.last_use = ++state.clock;
+				cached = it->second.input;
+			}
+			else
+				state.entries.erase(it);
+		}
+	}
+
+	if(cached)
 	{
 		try
 		{
-			return input->createReader(filename);
+			return cached->createReader(filename);
 		}
 		catch(Exception&) {}
 	}
 
+	unsigned char header[PROBE_HEADER_SIZE];
+	int size = 0;
+
+	std::FILE* file = std::fopen(filename.c_str(), "rb");
+
+	if(file)
+	{
+		size = std::fread(header, 1, PROBE_HEADER_SIZE, file);
+		std::fclose(file);
+	}
+
+	for(std::shared_ptr<IFileInput> input : probe(header, size, file_extension(filename)))
+	{
+		if(input == cached)
+			continue;
+
+		std::shared_ptr<IReader> reader;
+
+		try
+		{
+			reader = input->createReader(filename);
+		}
+		catch(Exception&)
+		{
+			continue;
+		}
+
+		std::list<std::shared_ptr<IFileInput>> registered = getInputs();
+
+		std::lock_guard<std::mutex> lock(state.mutex);
+
+		// inputs can unregister while opening, like plugin stubs do
+		if(state.size && std::find(registered.begin(), registered.end(), input) != registered.end())
+		{
+			if(state.entries.find(filename) == state.entries.end() && state.entries.size() >= state.size)
+			{
+				auto oldest = state.entries.begin();
+
+				for(auto it = state.entries.begin(); it != state.entries.end(); it++)
+				{
+					if(it->second.last_use < oldest->second.last_use)
+						oldest = it;
+				}
+
+				state.entries.erase(oldest);
+			}
+
+			ProbeCacheEntry& entry = state.entries[filename];
+			entry.input = input;
+			entry.size = info.st_size;
+			entry.mtime = info.st_mtime;
+			entry.last_use = ++state.clock;
+		}
+
+		return reader;
+	}
+
 	AUD_THROW(FileException, "The file couldn't be read with any installed file reader.");
 }
 
 std::shared_ptr<IReader> FileManager::createReader(std::shared_ptr<Buffer> buffer)
 {
-	for(std::shared_ptr<IFileInput> input : inputs())
+	const unsigned char* header = reinterpret_cast<const unsigned char*>(buffer->getBuffer());
+
+	for(std::shared_ptr<IFileInput> input : probe(header, std::min(buffer->getSize(), PROBE_HEADER_SIZE), ""))
 	{
 		try
 		{
@@ -73,7 +332,7 @@ std::shared_ptr<IReader> FileManager::createReader(std::shared_ptr<Buffer> buffe
 
 std::shared_ptr<IWriter> FileManager::createWriter(std::string filename, DeviceSpecs specs, Container format, Codec codec, unsigned int bitrate)
 {
-	for(std::shared_ptr<IFileOutput> output : outputs())
+	for(std::shared_ptr<IFileOutput> output : getOutputs())
 	{
 		try
 		{
@@ -85,4 +344,66 @@ std::shared_ptr<IWriter> FileManager::createWriter(std::string filename, DeviceS
 	AUD_THROW(FileException, "The file couldn't be written with any installed writer.");
 }
 
+void FileManager::setProbeCacheSize(unsigned int size)
+{
+	ProbeCacheState& state = probeCacheState();
+
+	std::lock_guard<std::mutex> lock(state.mutex);
+
+	state.size = size;
+
+	if(state.entries.size() > size)
+		state.entries.clear();
+}
+
+unsigned int FileManager::getProbeCacheSize()
+{
+	ProbeCacheState& state = probeCacheState();
+
+	std::lock_guard<std::mutex> lock(state.mutex);
+
+	return state.size;
+}
+
+void FileManager::clearProbeCache()
+{
+	ProbeCacheState& state = probeCacheState();
+
+	std::lock_guard<std::mutex> lock(state.mutex);
+
+	state.entries.clear();
+}
+
+void FileManager::setReadAhead(int length)
+{
+	read_ahead = std::max(length, 0);
+}
+
+int FileManager::getReadAhead()
+{
+	return read_ahead;
+}
+
+void FileManager::setSeekIndexing(bool enabled)
+{
+	seek_indexing = enabled;
+}
+
+bool FileManager::isSeekIndexing()
+{
+	return seek_indexing;
+}
+
+void FileManager::setSeekIndexDirectory(std::string directory)
+{
+	std::lock_guard<std::mutex> lock(seek_index_mutex());
+	seek_index_directory() = directory;
+}
+
+std::string FileManager::getSeekIndexDirectory()
+{
+	std::lock_guard<std::mutex> lock(seek_index_mutex());
+	return seek_index_directory();
+}
+
 AUD_NAMESPACE_END
@@ -17,79 +17,255 @@
 #include "file/FileWriter.h"
 #include "file/FileManager.h"
 #include "util/Buffer.h"
+#include "util/DenormalGuard.h"
+#include "util/RingBuffer.h"
+#include "util/ThreadPool.h"
 #include "IReader.h"
 #include "Exception.h"
 
+#include <algorithm>
+#include <condition_variable>
+#include <exception>
+#include <future>
+#include <mutex>
+#include <thread>
+
+#if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+#define AUD_WRITER_SSE
+#include <xmmintrin.h>
+#endif
+
+// the number of buffers rendering can run ahead of encoding
+#define PIPELINE_BUFFERS 3
+
 AUD_NAMESPACE_BEGIN
 
+/// Clamps count samples of buffer to [-1, 1].
+static inline void clamp_samples(sample_t* buffer, int count)
+{
+	int i = 0;
+
+#ifdef AUD_WRITER_SSE
+	__m128 low = _mm_set1_ps(-1.0f);
+	__m128 high = _mm_set1_ps(1.0f);
+
+	for(; i + 4 <= count; i += 4)
+		_mm_storeu_ps(buffer + i, _mm_min_ps(_mm_max_ps(_mm_loadu_ps(buffer + i), low), high));
+#endif
+
+	for(; i < count; i++)
+	{
+		// clamping!
+		if(buffer[i] > 1)
+			buffer[i] = 1;
+		else if(buffer[i] < -1)
+			buffer[i] = -1;
+	}
+}
+
+/// Splits length interleaved frames into one plane of stride samples per channel.
+static void deinterleave(const sample_t* source, sample_t* target, int length, int channels, int stride)
+{
+	int i = 0;
+
+#ifdef AUD_WRITER_SSE
+	if(channels == 2)
+	{
+		for(; i + 4 <= length; i += 4)
+		{
+			__m128 a = _mm_loadu_ps(source + i * 2);
+			__m128 b = _mm_loadu_ps(source + i * 2 + 4);
+			_mm_storeu_ps(target + i, _mm_shuffle_ps(a, b, _MM_SHUFFLE(2, 0, 2, 0)));
+			_mm_storeu_ps(target + stride + i, _mm_shuffle_ps(a, b, _MM_SHUFFLE(3, 1, 3, 1)));
+		}
+	}
+	else if(channels % 4 == 0)
+	{
+		for(; i + 4 <= length; i += 4)
+		{
+			for(int channel = 0; channel < channels; channel += 4)
+			{
+				const sample_t* s = source + i * channels + channel;
+				__m128 r0 = _mm_loadu_ps(s);
+				__m128 r1 = _mm_loadu_ps(s + channels);
+				__m128 r2 = _mm_loadu_ps(s + channels * 2);
+				__m128 r3 = _mm_loadu_ps(s + channels * 3);
+				_MM_TRANSPOSE4_PS(r0, r1, r2, r3);
+				_mm_storeu_ps(target + channel * stride + i, r0);
+				_mm_storeu_ps(target + (channel + 1) * stride + i, r1);
+				_mm_storeu_ps(target + (channel + 2) * stride + i, r2);
+				_mm_storeu_ps(target + (channel + 3) * stride + i, r3);
+			}
+		}
+	}
+#endif
+
+	for(int channel = 0; channel < channels; channel++)
+		for(int j = i; j < length; j++)
+			target[channel * stride + j] = source[j * channels + channel];
+}
+
 std::shared_ptr<IWriter> FileWriter::createWriter(std::string filename,DeviceSpecs specs, Container format, Codec codec, unsigned int bitrate)
 {
 	return FileManager::createWriter(filename, specs, format, codec, bitrate);
 }
 
-void FileWriter::writeReader(std::shared_ptr<IReader> reader, std::shared_ptr<IWriter> writer, unsigned int length, unsigned int buffersize)
+void FileWriter::pipeline(std::shared_ptr<IReader> reader, int channels, unsigned int length, unsigned int buffersize, std::function<void(sample_t* buffer, int length)> encode)
 {
-	Buffer buffer(buffersize * AUD_SAMPLE_SIZE(writer->getSpecs()));
+	DenormalGuard guard;
+
+	RingBuffer ring(PIPELINE_BUFFERS * buffersize * channels);
+	std::mutex mutex;
+	std::condition_variable condition;
+	bool finished = false;
+	bool failed = false;
+	std::exception_ptr render_error;
+	std::exception_ptr encode_error;
+
+	std::thread encoder([&]() {
+		Buffer buffer(buffersize * channels * sizeof(sample_t));
+		sample_t* buf = buffer.getBuffer();
+
+		try
+		{
+			for(;;)
+			{
+				{
+					std::unique_lock<std::mutex> lock(mutex);
+					condition.wait(lock, [&]{ return finished || ring.getReadSpace() >= int(buffersize * channels); });
+				}
+
+				int len = ring.read(buf, buffersize * channels) / channels;
+
+				{
+					std::lock_guard<std::mutex> lock(mutex);
+					condition.notify_all();
+				}
+
+				if(!len)
+					break;
+
+				encode(buf, len);
+			}
+		}
+		catch(...)
+		{
+			encode_error = std::current_exception();
+
+			std::lock_guard<std::mutex> lock(mutex);
+			failed = true;
+			condition.notify_all();
+		}
+	});
+
+	Buffer buffer(buffersize * channels * sizeof(sample_t));
 	sample_t* buf = buffer.getBuffer();
 
 	int len;
 	bool eos = false;
-	int channels = writer->getSpecs().channels;
 
-	for(unsigned int pos = 0; ((pos < length) || (length <= 0)) && !eos; pos += len)
+	try
 	{
-		len = buffersize;
-		if((len > length - pos) && (length > 0))
-			len = length - pos;
-		reader->read(len, eos, buf);
-
-		for(int i = 0; i < len * channels; i++)
+		for(unsigned int pos = 0; ((pos < length) || (length <= 0)) && !eos; pos += len)
 		{
-			// clamping!
-			if(buf[i] > 1)
-				buf[i] = 1;
-			else if(buf[i] < -1)
-				buf[i] = -1;
+			len = buffersize;
+			if((len > length - pos) && (length > 0))
+				len = length - pos;
+			reader->read(len, eos, buf);
+
+			clamp_samples(buf, len * channels);
+
+			std::unique_lock<std::mutex> lock(mutex);
+			condition.wait(lock, [&]{ return failed || ring.getWriteSpace() >= len * channels; });
+
+			if(failed)
+				break;
+
+			ring.write(buf, len * channels);
+			condition.notify_all();
 		}
+	}
+	catch(...)
+	{
+		render_error = std::current_exception();
+	}
 
-		writer->write(len, buf);
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		finished = true;
+		condition.notify_all();
 	}
+
+	encoder.join();
+
+	if(render_error)
+		std::rethrow_exception(render_error);
+
+	if(encode_error)
+		std::rethrow_exception(encode_error);
+}
+
+void FileWriter::writeReader(std::shared_ptr<IReader> reader, std::shared_ptr<IWriter> writer, unsigned int length, unsigned int buffersize)
+{
+	pipeline(reader, writer->getSpecs().channels, length, buffersize, [writer](sample_t* buffer, int length) {
+		writer->write(length, buffer);
+	});
 }
 
 void FileWriter::writeReader(std::shared_ptr<IReader> reader, std::vector<std::shared_ptr<IWriter> >& writers, unsigned int length, unsigned int buffersize)
 {
-	Buffer buffer(buffersize * AUD_SAMPLE_SIZE(reader->getSpecs()));
-	Buffer buffer2(buffersize * sizeof(sample_t));
-	sample_t* buf = buffer.getBuffer();
+	int channels = reader->getSpecs().channels;
+
+	Buffer buffer2(buffersize * channels * sizeof(sample_t));
 	sample_t* buf2 = buffer2.getBuffer();
 
-	int len;
-	bool eos = false;
-	int channels = reader->getSpecs().channels;
+	// the encoding thread writes the first channel itself
+	std::unique_ptr<ThreadPool> pool;
+	unsigned int threads = std::min<unsigned int>(channels - 1, std::thread::hardware_concurrency());
 
-	for(unsigned int pos = 0; ((pos < length) || (length <= 0)) && !eos; pos += len)
-	{
-		len = buffersize;
-		if((len > length - pos) && (length > 0))
-			len = length - pos;
-		reader->read(len, eos, buf);
+	if(threads > 0)
+		pool = std::unique_ptr<ThreadPool>(new ThreadPool(threads));
+
+	pipeline(reader, channels, length, buffersize, [&](sample_t* buf, int len) {
+		deinterleave(buf, buf2, len, channels, buffersize);
 
-		for(int channel = 0; channel < channels; channel++)
+		if(!pool)
 		{
-			for(int i = 0; i < len; i++)
-			{
-				// clamping!
-				if(buf[i * channels + channel] > 1)
-					buf2[i] = 1;
-				else if(buf[i * channels + channel] < -1)
-					buf2[i] = -1;
-				else
-					buf2[i] = buf[i * channels + channel];
-			}
+			for(int channel = 0; channel < channels; channel++)
+				writers[channel]->write(len, buf2 + channel * buffersize);
+			return;
+		}
+
+		std::vector<std::future<void>> futures;
+
+		for(int channel = 1; channel < channels; channel++)
+		{
+			futures.push_back(pool->enqueue([&writers, buf2, len, channel, buffersize]() {
+				writers[channel]->write(len, buf2 + channel * buffersize);
+			}));
+		}
+
+		std::exception_ptr error;
 
-			writers[channel]->write(len, buf2);
+		try
+		{
+			writers[0]->write(len, buf2);
 		}
-	}
+		catch(...)
+		{
+			error = std::current_exception();
+		}
+
+		// every channel has to finish this block before buf2 is reused
+		for(auto& future : futures)
+			future.wait();
+
+		for(auto& future : futures)
+			future.get();
+
+		if(error)
+			std::rethrow_exception(error);
+	});
 }
 
 AUD_NAMESPACE_END
@@ -0,0 +1,70 @@
+/*******************************************************************************
+ * Copyright 2009-2016 Jörg Müller
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ ******************************************************************************/
+
+#include "file/PCMFile.h"
+#include "file/PCMFileReader.h"
+#include "file/PCMFileWriter.h"
+#include "file/FileManager.h"
+#include "Exception.h"
+
+#include <cstring>
+
+AUD_NAMESPACE_BEGIN
+
+PCMFile::PCMFile()
+{
+}
+
+void PCMFile::registerPlugin()
+{
+	std::shared_ptr<PCMFile> plugin = std::shared_ptr<PCMFile>(new PCMFile);
+	FileManager::registerInput(plugin);
+	FileManager::registerOutput(plugin);
+}
+
+std::shared_ptr<IReader> PCMFile::createReader(std::string filename)
+{
+	return std::shared_ptr<IReader>(new PCMFileReader(filename));
+}
+
+std::shared_ptr<IReader> PCMFile::createReader(std::shared_ptr<Buffer> buffer)
+{
+	return std::shared_ptr<IReader>(new PCMFileReader(buffer));
+}
+
+ProbeResult PCMFile::probe(const unsigned char* header, int size, const std::string& /*extension*/)
+{
+	if(size < 12)
+		return PROBE_UNSUPPORTED;
+
+	if((!std::memcmp(header, "RIFF", 4) || !std::memcmp(header, "RF64", 4)) && !std::memcmp(header + 8, "WAVE", 4))
+		return PROBE_SUPPORTED;
+
+	if(!std::memcmp(header, "FORM", 4) && (!std::memcmp(header + 8, "AIFF", 4) || !std::memcmp(header + 8, "AIFC", 4)))
+		return PROBE_SUPPORTED;
+
+	return PROBE_UNSUPPORTED;
+}
+
+std::shared_ptr<IWriter> PCMFile::createWriter(std::string filename, DeviceSpecs specs, Container format, Codec codec, unsigned int /*bitrate*/)
+{
+	if(format != CONTAINER_WAV || codec != CODEC_PCM)
+		AUD_THROW(FileException, "Only PCM WAV files can be written natively.");
+
+	return std::shared_ptr<IWriter>(new PCMFileWriter(filename, specs));
+}
+
+AUD_NAMESPACE_END
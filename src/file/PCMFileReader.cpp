@@ -0,0 +1,390 @@
+/*******************************************************************************
+ * Copyright 2009-2016 Jörg Müller
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ ******************************************************************************/
+
+#include "file/PCMFileReader.h"
+#include "util/Buffer.h"
+#include "util/MappedFile.h"
+#include "Exception.h"
+
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <stdint.h>
+
+#define S8_FLT		127.0f
+#define S16_FLT		32767.0f
+#define S32_FLT		2147483647.0f
+
+AUD_NAMESPACE_BEGIN
+
+static inline uint16_t read_le16(const data_t* data)
+{
+	return uint16_t(data[0] | data[1] << 8);
+}
+
+static inline uint32_t read_le32(const data_t* data)
+{
+	return uint32_t(data[0]) | uint32_t(data[1]) << 8 | uint32_t(data[2]) << 16 | uint32_t(data[3]) << 24;
+}
+
+static inline uint64_t read_le64(const data_t* data)
+{
+	return uint64_t(read_le32(data)) | uint64_t(read_le32(data + 4)) << 32;
+}
+
+static inline uint16_t read_be16(const data_t* data)
+{
+	return uint16_t(data[0] << 8 | data[1]);
+}
+
+static inline uint32_t read_be32(const data_t* data)
+{
+	return uint32_t(data[0]) << 24 | uint32_t(data[1]) << 16 | uint32_t(data[2]) << 8 | uint32_t(data[3]);
+}
+
+static inline double read_extended(const data_t* data)
+{
+	int exponent = (data[0] & 0x7F) << 8 | data[1];
+	uint64_t mantissa = uint64_t(read_be32(data + 2)) << 32 | read_be32(data + 6);
+
+	if(exponent == 0 && mantissa == 0)
+		return 0;
+
+	double value = std::ldexp(double(mantissa), exponent - 16383 - 63);
+
+	return (data[0] & 0x80) ? -value : value;
+}
+
+template <class T>
+static inline T read_swapped(const data_t* source)
+{
+	T value;
+	data_t* target = reinterpret_cast<data_t*>(&value);
+
+	for(unsigned int i = 0; i < sizeof(T); i++)
+		target[i] = source[sizeof(T) - 1 - i];
+
+	return value;
+}
+
+static void convert_s8_float(data_t* target, data_t* source, int length)
+{
+	int8_t* s = (int8_t*) source;
+	float* t = (float*) target;
+	for(int i = 0; i < length; i++)
+		t[i] = s[i] / S8_FLT;
+}
+
+static void convert_s16_swapped_float(data_t* target, data_t* source, int length)
+{
+	float* t = (float*) target;
+	for(int i = 0; i < length; i++)
+		t[i] = read_swapped<int16_t>(source + i * 2) / S16_FLT;
+}
+
+static void convert_s32_swapped_float(data_t* target, data_t* source, int length)
+{
+	float* t = (float*) target;
+	for(int i = 0; i < length; i++)
+		t[i] = read_swapped<int32_t>(source + i * 4) / S32_FLT;
+}
+
+static void convert_float_swapped_float(data_t* target, data_t* source, int length)
+{
+	float* t = (float*) target;
+	for(int i = 0; i < length; i++)
+		t[i] = read_swapped<float>(source + i * 4);
+}
+
+static void convert_double_swapped_float(data_t* target, data_t* source, int length)
+{
+	float* t = (float*) target;
+	for(int i = 0; i < length; i++)
+		t[i] = float(read_swapped<double>(source + i * 8));
+}
+
+/**
+ * Selects the conversion function for the stored sample format.
+ * \param bits The bits per sample as stored in the file.
+ * \param is_float Whether the samples are floating point.
+ * \param big_endian Whether the samples are stored big endian.
+ * \param is_unsigned Whether 8 bit samples are unsigned.
+ * \return The conversion function or nullptr if the format is unsupported.
+ */
+static convert_f select_converter(int bits, bool is_float, bool big_endian, bool is_unsigned)
+{
+#ifdef __BIG_ENDIAN__
+	bool swapped = !big_endian;
+#else
+	bool swapped = big_endian;
+#endif
+
+	if(is_float)
+	{
+		switch(bits)
+		{
+		case 32:
+			return swapped ? convert_float_swapped_float : convert_copy<float>;
+		case 64:
+			return swapped ? convert_double_swapped_float : convert_double_float;
+		}
+
+		return nullptr;
+	}
+
+	switch(bits)
+	{
+	case 8:
+		return is_unsigned ? convert_u8_float : convert_s8_float;
+	case 16:
+		return swapped ? convert_s16_swapped_float : convert_s16_float;
+	case 24:
+		return big_endian ? convert_s24_float_be : convert_s24_float_le;
+	case 32:
+		return swapped ? convert_s32_swapped_float : convert_s32_float;
+	}
+
+	return nullptr;
+}
+
+void PCMFileReader::parse(const data_t* data, size_t size)
+{
+	if(size < 12)
+		AUD_THROW(FileException, "The file is too small to be a PCM file.");
+
+	bool aiff = false;
+	bool rf64 = false;
+
+	if(!std::memcmp(data, "RIFF", 4) && !std::memcmp(data + 8, "WAVE", 4))
+		rf64 = false;
+	else if(!std::memcmp(data, "RF64", 4) && !std::memcmp(data + 8, "WAVE", 4))
+		rf64 = true;
+	else if(!std::memcmp(data, "FORM", 4) && (!std::memcmp(data + 8, "AIFF", 4) || !std::memcmp(data + 8, "AIFC", 4)))
+		aiff = true;
+	else
+		AUD_THROW(FileException, "The file is no WAV, RF64 or AIFF file.");
+
+	bool aifc = aiff && !std::memcmp(data + 8, "AIFC", 4);
+
+	int channels = 0;
+	double rate = 0;
+	int bits = 0;
+	bool is_float = false;
+	bool big_endian = aiff;
+	bool have_format = false;
+	uint64_t frames = std::numeric_limits<uint64_t>::max();
+	uint64_t ds64_data_size = 0;
+	size_t data_offset = 0;
+	uint64_t data_size = 0;
+	bool have_data = false;
+
+	size_t position = 12;
+
+	while(position + 8 <= size && !(have_format && have_data))
+	{
+		const data_t* chunk = data + position;
+		uint64_t chunk_size = aiff ? read_be32(chunk + 4) : read_le32(chunk + 4);
+		const data_t* body = chunk + 8;
+		size_t available = size - position - 8;
+
+		if(!aiff && !std::memcmp(chunk, "ds64", 4) && available >= 16)
+			ds64_data_size = read_le64(body + 8);
+		else if(!aiff && !std::memcmp(chunk, "fmt ", 4) && chunk_size >= 16 && available >= 16)
+		{
+			int tag = read_le16(body);
+
+			if(tag == 0xFFFE)
+			{
+				if(chunk_size < 40 || available < 40)
+					AUD_THROW(FileException, "The WAV file has an invalid extensible format chunk.");
+
+				tag = read_le16(body + 24);
+			}
+
+			if(tag == 1)
+				is_float = false;
+			else if(tag == 3)
+				is_float = true;
+			else
+				AUD_THROW(FileException, "The WAV file doesn't contain PCM data.");
+
+			channels = read_le16(body + 2);
+			rate = read_le32(body + 4);
+			bits = read_le16(body + 14);
+
+			if(read_le16(body + 12) != channels * ((bits + 7) / 8))
+				AUD_THROW(FileException, "The WAV file has an unsupported block alignment.");
+
+			have_format = true;
+		}
+		else if(aiff && !std::memcmp(chunk, "COMM", 4) && chunk_size >= 18 && available >= 18)
+		{
+			channels = read_be16(body);
+			frames = read_be32(body + 2);
+			bits = read_be16(body + 6);
+			rate = read_extended(body + 8);
+
+			if(aifc)
+			{
+				if(chunk_size < 22 || available < 22)
+					AUD_THROW(FileException, "The AIFC file has an invalid common chunk.");
+
+				const data_t* compression = body + 18;
+
+				if(!std::memcmp(compression, "NONE", 4) || !std::memcmp(compression, "twos", 4))
+					big_endian = true;
+				else if(!std::memcmp(compression, "sowt", 4))
+					big_endian = false;
+				else if(!std::memcmp(compression, "fl32", 4) || !std::memcmp(compression, "FL32", 4))
+				{
+					is_float = true;
+					bits = 32;
+				}
+				else if(!std::memcmp(compression, "fl64", 4) || !std::memcmp(compression, "FL64", 4))
+				{
+					is_float = true;
+					bits = 64;
+				}
+				else
+					AUD_THROW(FileException, "The AIFC file is compressed.");
+			}
+
+			have_format = true;
+		}
+		else if(!aiff && !std::memcmp(chunk, "data", 4))
+		{
+			data_offset = position + 8;
+			data_size = (rf64 && chunk_size == 0xFFFFFFFF) ? ds64_data_size : chunk_size;
+			have_data = true;
+		}
+		else if(aiff && !std::memcmp(chunk, "SSND", 4) && chunk_size >= 8 && available >= 8)
+		{
+			uint64_t offset = read_be32(body);
+			data_offset = position + 16 + offset;
+			data_size = chunk_size - 8 > offset ? chunk_size - 8 - offset : 0;
+			have_data = true;
+		}
+
+		// chunks are padded to an even size
+		uint64_t next = uint64_t(position) + 8 + chunk_size + (chunk_size & 1);
+
+		if(next >= size)
+			break;
+
+		position = size_t(next);
+	}
+
+	if(!have_format || !have_data)
+		AUD_THROW(FileException, "The PCM file is missing its format or data chunk.");
+
+	if(channels <= CHANNELS_INVALID || channels > CHANNELS_SURROUND71)
+		AUD_THROW(FileException, "The PCM file has an unsupported channel count.");
+
+	if(rate <= 0)
+		AUD_THROW(FileException, "The PCM file has an invalid sample rate.");
+
+	m_convert = select_converter(bits, is_float, big_endian, !aiff);
+
+	if(!m_convert)
+		AUD_THROW(FileException, "The PCM file has an unsupported sample format.");
+
+	m_specs.channels = Channels(channels);
+	m_specs.rate = SampleRate(rate);
+	m_frame_size = channels * ((bits + 7) / 8);
+
+	// truncated files are read as far as they go
+	if(data_offset > size)
+		data_offset = size;
+	if(data_size > size - data_offset)
+		data_size = size - data_offset;
+
+	uint64_t length = data_size / m_frame_size;
+
+	if(length > frames)
+		length = frames;
+	if(length > uint64_t(std::numeric_limits<int>::max()))
+		length = std::numeric_limits<int>::max();
+
+	m_data = data + data_offset;
+	m_length = int(length);
+}
+
+PCMFileReader::PCMFileReader(std::string filename) :
+	m_position(0),
+	m_file(new MappedFile(filename))
+{
+	parse(m_file->getData(), m_file->getSize());
+}
+
+PCMFileReader::PCMFileReader(std::shared_ptr<Buffer> buffer) :
+	m_position(0),
+	m_membuffer(buffer)
+{
+	parse(reinterpret_cast<const data_t*>(buffer->getBuffer()), buffer->getSize());
+}
+
+bool PCMFileReader::isSeekable() const
+{
+	return true;
+}
+
+bool PCMFileReader::isSeekAccurate() const
+{
+	return true;
+}
+
+void PCMFileReader::seek(int position)
+{
+	if(position < 0)
+		position = 0;
+	if(position > m_length)
+		position = m_length;
+
+	m_position = position;
+}
+
+int PCMFileReader::getLength() const
+{
+	return m_length;
+}
+
+int PCMFileReader::getPosition() const
+{
+	return m_position;
+}
+
+Specs PCMFileReader::getSpecs() const
+{
+	return m_specs;
+}
+
+void PCMFileReader::read(int& length, bool& eos, sample_t* buffer)
+{
+	eos = false;
+
+	if(length >= m_length - m_position)
+	{
+		length = m_length - m_position;
+		eos = true;
+	}
+
+	// the converters don't write to the source, so reading from the read-only mapping is fine
+	m_convert(reinterpret_cast<data_t*>(buffer), const_cast<data_t*>(m_data + size_t(m_position) * m_frame_size), length * m_specs.channels);
+
+	m_position += length;
+}
+
+AUD_NAMESPACE_END
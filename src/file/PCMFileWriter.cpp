@@ -0,0 +1,178 @@
+/*******************************************************************************
+ * Copyright 2009-2016 Jörg Müller
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ ******************************************************************************/
+
+#include "file/PCMFileWriter.h"
+#include "Exception.h"
+
+#include <cstring>
+#include <stdint.h>
+#include <utility>
+
+/// The size of the WAV header written, including the ds64 placeholder.
+#define AUD_PCM_HEADER_SIZE 80
+
+AUD_NAMESPACE_BEGIN
+
+static inline void write_le16(data_t* target, uint16_t value)
+{
+	target[0] = value & 0xFF;
+	target[1] = value >> 8 & 0xFF;
+}
+
+static inline void write_le32(data_t* target, uint32_t value)
+{
+	write_le16(target, value & 0xFFFF);
+	write_le16(target + 2, value >> 16 & 0xFFFF);
+}
+
+static inline void write_le64(data_t* target, uint64_t value)
+{
+	write_le32(target, value & 0xFFFFFFFF);
+	write_le32(target + 4, value >> 32 & 0xFFFFFFFF);
+}
+
+#ifdef __BIG_ENDIAN__
+static void swap_samples(data_t* data, int length, int size)
+{
+	for(int i = 0; i < length; i++, data += size)
+		for(int j = 0; j < size / 2; j++)
+			std::swap(data[j], data[size - 1 - j]);
+}
+#endif
+
+PCMFileWriter::PCMFileWriter(std::string filename, DeviceSpecs specs) :
+	m_position(0), m_specs(specs), m_file(nullptr)
+{
+	switch(specs.format)
+	{
+	case FORMAT_U8:
+		m_convert = convert_float_u8;
+		break;
+	case FORMAT_S16:
+		m_convert = convert_float_s16;
+		break;
+	case FORMAT_S24:
+		m_convert = convert_float_s24_le;
+		break;
+	case FORMAT_S32:
+		m_convert = convert_float_s32;
+		break;
+	case FORMAT_FLOAT32:
+		m_convert = convert_copy<float>;
+		break;
+	case FORMAT_FLOAT64:
+		m_convert = convert_float_double;
+		break;
+	default:
+		AUD_THROW(FileException, "This format couldn't be written as PCM WAV file.");
+	}
+
+	if(specs.channels <= CHANNELS_INVALID || specs.channels > CHANNELS_SURROUND71 || specs.rate <= RATE_INVALID)
+		AUD_THROW(FileException, "Invalid specification for a PCM WAV file.");
+
+	m_file = std::fopen(filename.c_str(), "wb");
+
+	if(!m_file)
+		AUD_THROW(FileException, "The file couldn't be opened for writing.");
+
+	writeHeader();
+}
+
+PCMFileWriter::~PCMFileWriter()
+{
+	unsigned long long data_size = (unsigned long long)m_position * AUD_DEVICE_SAMPLE_SIZE(m_specs);
+
+	// chunks are padded to an even size
+	if(data_size & 1)
+		std::fputc(0, m_file);
+
+	writeHeader();
+
+	std::fclose(m_file);
+}
+
+void PCMFileWriter::writeHeader()
+{
+	uint64_t data_size = uint64_t(m_position) * AUD_DEVICE_SAMPLE_SIZE(m_specs);
+	uint64_t riff_size = AUD_PCM_HEADER_SIZE - 8 + data_size + (data_size & 1);
+	bool rf64 = riff_size > 0xFFFFFFFF;
+	int sample_size = AUD_FORMAT_SIZE(m_specs.format);
+
+	data_t header[AUD_PCM_HEADER_SIZE];
+	std::memset(header, 0, sizeof(header));
+
+	std::memcpy(header, rf64 ? "RF64" : "RIFF", 4);
+	write_le32(header + 4, rf64 ? 0xFFFFFFFF : uint32_t(riff_size));
+	std::memcpy(header + 8, "WAVE", 4);
+
+	// the ds64 chunk is reserved as JUNK until it is needed
+	std::memcpy(header + 12, rf64 ? "ds64" : "JUNK", 4);
+	write_le32(header + 16, 28);
+
+	if(rf64)
+	{
+		write_le64(header + 20, riff_size);
+		write_le64(header + 28, data_size);
+		write_le64(header + 36, uint64_t(m_position));
+	}
+
+	std::memcpy(header + 48, "fmt ", 4);
+	write_le32(header + 52, 16);
+	write_le16(header + 56, (m_specs.format & 0x20) ? 3 : 1);
+	write_le16(header + 58, m_specs.channels);
+	write_le32(header + 60, uint32_t(m_specs.rate));
+	write_le32(header + 64, uint32_t(m_specs.rate) * m_specs.channels * sample_size);
+	write_le16(header + 68, m_specs.channels * sample_size);
+	write_le16(header + 70, sample_size * 8);
+
+	std::memcpy(header + 72, "data", 4);
+	write_le32(header + 76, rf64 ? 0xFFFFFFFF : uint32_t(data_size));
+
+	std::fseek(m_file, 0, SEEK_SET);
+	std::fwrite(header, 1, sizeof(header), m_file);
+}
+
+int PCMFileWriter::getPosition() const
+{
+	return m_position;
+}
+
+DeviceSpecs PCMFileWriter::getSpecs() const
+{
+	return m_specs;
+}
+
+void PCMFileWriter::write(unsigned int length, sample_t* buffer)
+{
+	int samplesize = AUD_DEVICE_SAMPLE_SIZE(m_specs);
+
+	m_buffer.assureSize(length * samplesize);
+
+	data_t* data = reinterpret_cast<data_t*>(m_buffer.getBuffer());
+
+	m_convert(data, reinterpret_cast<data_t*>(buffer), length * m_specs.channels);
+
+#ifdef __BIG_ENDIAN__
+	if(m_specs.format != FORMAT_S24)
+		swap_samples(data, length * m_specs.channels, AUD_FORMAT_SIZE(m_specs.format));
+#endif
+
+	length = std::fwrite(data, samplesize, length, m_file);
+
+	m_position += length;
+}
+
+AUD_NAMESPACE_END
@@ -15,6 +15,7 @@
  ******************************************************************************/
 
 #include "fx/ADSRReader.h"
+#include "util/DenormalCounter.h"
 
 AUD_NAMESPACE_BEGIN
 
@@ -102,9 +103,12 @@ void ADSRReader::read(int & length, bool &eos, sample_t* buffer)
 			break;
 		case ADSR_STATE_INVALID:
 			length = i;
+			DenormalCounter::check("ADSRReader", buffer, length * specs.channels);
 			return;
 		}
 	}
+
+	DenormalCounter::check("ADSRReader", buffer, length * specs.channels);
 }
 
 void ADSRReader::release()
@@ -15,16 +15,21 @@
  ******************************************************************************/
 
 #include "fx/BaseIIRFilterReader.h"
+#include "util/DenormalCounter.h"
 
+#include <cmath>
 #include <cstring>
 
+/// Sample magnitude below which the filter state is considered to be silent.
+#define AUD_IIR_SILENCE_THRESHOLD 1e-10f
+
 AUD_NAMESPACE_BEGIN
 
 BaseIIRFilterReader::BaseIIRFilterReader(std::shared_ptr<IReader> reader, int in, int out) :
 	EffectReader(reader),
 	m_specs(reader->getSpecs()),
 	m_xlen(in), m_ylen(out),
-	m_xpos(0), m_ypos(0), m_channel(0)
+	m_xpos(0), m_ypos(0), m_channel(0), m_silent(false)
 {
 	m_x = new sample_t[m_xlen * m_specs.channels];
 	m_y = new sample_t[m_ylen * m_specs.channels];
@@ -105,6 +110,19 @@ void BaseIIRFilterReader::read(int& length, bool& eos, sample_t* buffer)
 
 	m_reader->read(length, eos, buffer);
 
+	// silent input into a decayed state results in silent output
+
+	if(preservesSilence() && m_reader->isSilent() && isStateSilent())
+	{
+		std::memset(m_x, 0, sizeof(sample_t) * m_xlen * m_specs.channels);
+		std::memset(m_y, 0, sizeof(sample_t) * m_ylen * m_specs.channels);
+
+		m_silent = true;
+		return;
+	}
+
+	m_silent = false;
+
 	for(m_channel = 0; m_channel < m_specs.channels; m_channel++)
 	{
 		for(int i = 0; i < length; i++)
@@ -116,10 +134,35 @@ void BaseIIRFilterReader::read(int& length, bool& eos, sample_t* buffer)
 			m_ypos = m_ylen ? (m_ypos + 1) % m_ylen : 0;
 		}
 	}
+
+	DenormalCounter::check("BaseIIRFilterReader", buffer, length * m_specs.channels);
+}
+
+bool BaseIIRFilterReader::isSilent() const
+{
+	return m_silent;
 }
 
 void BaseIIRFilterReader::sampleRateChanged(SampleRate rate)
 {
 }
 
+bool BaseIIRFilterReader::preservesSilence() const
+{
+	return false;
+}
+
+bool BaseIIRFilterReader::isStateSilent() const
+{
+	for(int i = 0; i < m_xlen * m_specs.channels; i++)
+		if(std::fabs(m_x[i]) >= AUD_IIR_SILENCE_THRESHOLD)
+			return false;
+
+	for(int i = 0; i < m_ylen * m_specs.channels; i++)
+		if(std::fabs(m_y[i]) >= AUD_IIR_SILENCE_THRESHOLD)
+			return false;
+
+	return true;
+}
+
 AUD_NAMESPACE_END
@@ -15,6 +15,7 @@
 ******************************************************************************/
 
 #include "fx/ConvolverReader.h"
+#include "util/DenormalCounter.h"
 #include "Exception.h"
 
 #include <cstring>
@@ -148,6 +149,8 @@ void ConvolverReader::loadBuffer()
 
 		joinByChannel(0, len);
 		m_eOutBufLen = len*m_inChannels;
+
+		DenormalCounter::check("ConvolverReader", m_outBuffer, m_eOutBufLen);
 	}
 	else if(!m_eosTail)
 	{
@@ -159,6 +162,8 @@ void ConvolverReader::loadBuffer()
 
 		joinByChannel(0, len);
 		m_eOutBufLen = len*m_inChannels;
+
+		DenormalCounter::check("ConvolverReader", m_outBuffer, m_eOutBufLen);
 	}
 }
 
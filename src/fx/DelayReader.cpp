@@ -23,7 +23,8 @@ AUD_NAMESPACE_BEGIN
 DelayReader::DelayReader(std::shared_ptr<IReader> reader, float delay) :
 	EffectReader(reader),
 	m_delay(int((SampleRate)delay * reader->getSpecs().rate)),
-	m_remdelay(int((SampleRate)delay * reader->getSpecs().rate))
+	m_remdelay(int((SampleRate)delay * reader->getSpecs().rate)),
+	m_silent(false)
 {
 }
 
@@ -71,6 +72,7 @@ void DelayReader::read(int& length, bool& eos, sample_t* buffer)
 			m_reader->read(len, eos, buffer + m_remdelay * specs.channels);
 
 			length = m_remdelay + len;
+			m_silent = m_reader->isSilent();
 
 			m_remdelay = 0;
 		}
@@ -78,10 +80,19 @@ void DelayReader::read(int& length, bool& eos, sample_t* buffer)
 		{
 			std::memset(buffer, 0, length * samplesize);
 			m_remdelay -= length;
+			m_silent = true;
 		}
 	}
 	else
+	{
 		m_reader->read(length, eos, buffer);
+		m_silent = m_reader->isSilent();
+	}
+}
+
+bool DelayReader::isSilent() const
+{
+	return m_silent;
 }
 
 AUD_NAMESPACE_END
@@ -57,4 +57,9 @@ void EffectReader::read(int& length, bool& eos, sample_t* buffer)
 	m_reader->read(length, eos, buffer);
 }
 
+bool EffectReader::isSilent() const
+{
+	return m_reader->isSilent();
+}
+
 AUD_NAMESPACE_END
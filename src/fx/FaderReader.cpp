@@ -15,6 +15,7 @@
  ******************************************************************************/
 
 #include "fx/FaderReader.h"
+#include "util/DenormalCounter.h"
 
 #include <cstring>
 
@@ -24,7 +25,8 @@ FaderReader::FaderReader(std::shared_ptr<IReader> reader, FadeType type, float s
 		EffectReader(reader),
 		m_type(type),
 		m_start(start),
-		m_length(length)
+		m_length(length),
+		m_silent(false)
 {
 }
 
@@ -36,11 +38,14 @@ void FaderReader::read(int& length, bool& eos, sample_t* buffer)
 
 	m_reader->read(length, eos, buffer);
 
+	m_silent = m_reader->isSilent();
+
 	if((position + length) / (float)specs.rate <= m_start)
 	{
 		if(m_type != FADE_OUT)
 		{
 			std::memset(buffer, 0, length * samplesize);
+			m_silent = true;
 		}
 	}
 	else if(position / (float)specs.rate >= m_start+m_length)
@@ -48,9 +53,10 @@ void FaderReader::read(int& length, bool& eos, sample_t* buffer)
 		if(m_type == FADE_OUT)
 		{
 			std::memset(buffer, 0, length * samplesize);
+			m_silent = true;
 		}
 	}
-	else
+	else if(!m_silent)
 	{
 		float volume = 1.0f;
 
@@ -70,7 +76,14 @@ void FaderReader::read(int& length, bool& eos, sample_t* buffer)
 
 			buffer[i] = buffer[i] * volume;
 		}
+
+		DenormalCounter::check("FaderReader", buffer, length * specs.channels);
 	}
 }
 
+bool FaderReader::isSilent() const
+{
+	return m_silent;
+}
+
 AUD_NAMESPACE_END
@@ -50,4 +50,9 @@ void IIRFilterReader::setCoefficients(const std::vector<float>& b, const std::ve
 	m_b = b;
 }
 
+bool IIRFilterReader::preservesSilence() const
+{
+	return true;
+}
+
 AUD_NAMESPACE_END
@@ -136,4 +136,9 @@ void LimiterReader::read(int& length, bool& eos, sample_t* buffer)
 		m_reader->read(length, eos, buffer);
 }
 
+bool LimiterReader::isSeekAccurate() const
+{
+	return m_reader->isSeekAccurate();
+}
+
 AUD_NAMESPACE_END
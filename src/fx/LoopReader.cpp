@@ -21,7 +21,7 @@
 AUD_NAMESPACE_BEGIN
 
 LoopReader::LoopReader(std::shared_ptr<IReader> reader, int loop) :
-		EffectReader(reader), m_count(loop), m_left(loop)
+		EffectReader(reader), m_count(loop), m_left(loop), m_silent(false)
 {
 }
 
@@ -62,6 +62,8 @@ void LoopReader::read(int& length, bool& eos, sample_t* buffer)
 
 	m_reader->read(length, eos, buffer);
 
+	m_silent = m_reader->isSilent();
+
 	if(length < len && eos && m_left)
 	{
 		int pos = length;
@@ -77,6 +79,8 @@ void LoopReader::read(int& length, bool& eos, sample_t* buffer)
 			len = length - pos;
 			m_reader->read(len, eos, buffer + pos * specs.channels);
 
+			m_silent = m_silent && m_reader->isSilent();
+
 			// prevent endless loop
 			if(!len)
 				break;
@@ -88,4 +92,9 @@ void LoopReader::read(int& length, bool& eos, sample_t* buffer)
 	}
 }
 
+bool LoopReader::isSilent() const
+{
+	return m_silent;
+}
+
 AUD_NAMESPACE_END
@@ -61,4 +61,9 @@ void MutableReader::read(int& length, bool& eos, sample_t* buffer)
 	m_reader->read(length, eos, buffer);
 }
 
+bool MutableReader::isSilent() const
+{
+	return m_reader->isSilent();
+}
+
 AUD_NAMESPACE_END
@@ -57,4 +57,9 @@ void VolumeReader::read(int& length, bool& eos, sample_t* buffer)
 		buffer[i] = buffer[i] * m_volumeStorage->getVolume();
 }
 
+bool VolumeReader::isSilent() const
+{
+	return m_reader->isSilent() || m_volumeStorage->getVolume() == 0.0f;
+}
+
 AUD_NAMESPACE_END
\ No newline at end of file
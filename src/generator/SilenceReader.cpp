@@ -60,4 +60,9 @@ void SilenceReader::read(int& length, bool& eos, sample_t* buffer)
 	eos = false;
 }
 
+bool SilenceReader::isSilent() const
+{
+	return true;
+}
+
 AUD_NAMESPACE_END
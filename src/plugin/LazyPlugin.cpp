@@ -0,0 +1,237 @@
+/*******************************************************************************
+ * Copyright 2009-2016 Jörg Müller
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ ******************************************************************************/
+
+
+#include "plugin/LazyPlugin.h"
+#include "plugin/PluginManager.h"
+#include "devices/DeviceManager.h"
+#include "devices/IDeviceFactory.h"
+#include "file/FileManager.h"
+#include "file/IFileInput.h"
+#include "file/IFileOutput.h"
+#include "Exception.h"
+
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+#include <unordered_map>
+#include <vector>
+
+AUD_NAMESPACE_BEGIN
+
+/**
+ * Stub for a file plugin that loads the plugin on first use and then
+ * forwards to the FileManager, where the plugin registered itself.
+ */
+class LazyFile : public IFileInput, public IFileOutput, public std::enable_shared_from_this<LazyFile>
+{
+private:
+	std::shared_ptr<LazyPlugin> m_plugin;
+	std::vector<std::string> m_extensions;
+
+	void load()
+	{
+		std::shared_ptr<LazyFile> self = shared_from_this();
+
+		// the stub is replaced by the plugin itself
+		FileManager::unregisterInput(self);
+		FileManager::unregisterOutput(self);
+
+		if(!m_plugin->load())
+			AUD_THROW(FileException, "The plugin library couldn't be loaded.");
+	}
+
+public:
+	LazyFile(std::shared_ptr<LazyPlugin> plugin, std::vector<std::string> extensions) :
+		m_plugin(plugin), m_extensions(extensions)
+	{
+	}
+
+	virtual std::shared_ptr<IReader> createReader(std::string filename)
+	{
+		load();
+		return FileManager::createReader(filename);
+	}
+
+	virtual std::shared_ptr<IReader> createReader(std::shared_ptr<Buffer> buffer)
+	{
+		load();
+		return FileManager::createReader(buffer);
+	}
+
+	virtual ProbeResult probe(const unsigned char* /*header*/, int /*size*/, const std::string& extension)
+	{
+		if(std::find(m_extensions.begin(), m_extensions.end(), extension) != m_extensions.end())
+			return PROBE_SUPPORTED;
+
+		return PROBE_UNKNOWN;
+	}
+
+	virtual std::shared_ptr<IWriter> createWriter(std::string filename, DeviceSpecs specs, Container format, Codec codec, unsigned int bitrate)
+	{
+		load();
+		return FileManager::createWriter(filename, specs, format, codec, bitrate);
+	}
+};
+
+/**
+ * Stub for a device factory that loads the plugin when the device is opened
+ * and forwards to the factory the plugin registered under the same name.
+ */
+class LazyDeviceFactory : public IDeviceFactory
+{
+private:
+	std::shared_ptr<LazyPlugin> m_plugin;
+	std::string m_device;
+	int m_priority;
+	DeviceSpecs m_specs;
+	int m_buffersize;
+	std::string m_name;
+	bool m_has_specs;
+	bool m_has_buffersize;
+	bool m_has_name;
+
+public:
+	LazyDeviceFactory(std::shared_ptr<LazyPlugin> plugin, std::string device, int priority) :
+		m_plugin(plugin), m_device(device), m_priority(priority), m_buffersize(0),
+		m_has_specs(false), m_has_buffersize(false), m_has_name(false)
+	{
+	}
+
+	virtual std::shared_ptr<IDevice> openDevice()
+	{
+		m_plugin->load();
+
+		std::shared_ptr<IDeviceFactory> factory = DeviceManager::getDeviceFactory(m_device);
+
+		if(!factory || factory.get() == this)
+			AUD_THROW(DeviceException, "The device plugin couldn't be loaded.");
+
+		if(m_has_specs)
+			factory->setSpecs(m_specs);
+		if(m_has_buffersize)
+			factory->setBufferSize(m_buffersize);
+		if(m_has_name)
+			factory->setName(m_name);
+
+		return factory->openDevice();
+	}
+
+	virtual int getPriority()
+	{
+		return m_priority;
+	}
+
+	virtual void setSpecs(DeviceSpecs specs)
+	{
+		m_specs = specs;
+		m_has_specs = true;
+	}
+
+	virtual void setBufferSize(int buffersize)
+	{
+		m_buffersize = buffersize;
+		m_has_buffersize = true;
+	}
+
+	virtual void setName(std::string name)
+	{
+		m_name = name;
+		m_has_name = true;
+	}
+};
+
+std::mutex& LazyPlugin::mutex()
+{
+	static std::mutex mutex;
+	return mutex;
+}
+
+LazyPlugin::LazyPlugin(std::string path) :
+	m_path(path), m_loaded(false), m_valid(false)
+{
+}
+
+bool LazyPlugin::load()
+{
+	std::lock_guard<std::mutex> lock(mutex());
+
+	if(!m_loaded)
+	{
+		m_loaded = true;
+		m_valid = PluginManager::loadPlugin(m_path);
+	}
+
+	return m_valid;
+}
+
+std::string LazyPlugin::getPath() const
+{
+	return m_path;
+}
+
+bool LazyPlugin::loadManifest(const std::string& directory)
+{
+	std::ifstream manifest(directory + "/plugins.manifest");
+
+	if(!manifest)
+		return false;
+
+	std::unordered_map<std::string, std::shared_ptr<LazyPlugin>> plugins;
+	std::string line;
+
+	while(std::getline(manifest, line))
+	{
+		std::istringstream stream(line);
+		std::string type;
+		std::string library;
+
+		if(!(stream >> type >> library) || type[0] == '#')
+			continue;
+
+		std::shared_ptr<LazyPlugin>& plugin = plugins[library];
+
+		if(!plugin)
+			plugin = std::make_shared<LazyPlugin>(directory + "/" + library);
+
+		if(type == "file")
+		{
+			std::vector<std::string> extensions;
+			std::string extension;
+
+			while(stream >> extension)
+				extensions.push_back(extension);
+
+			std::shared_ptr<LazyFile> file = std::make_shared<LazyFile>(plugin, extensions);
+			FileManager::registerInput(file);
+			FileManager::registerOutput(file);
+		}
+		else if(type == "device")
+		{
+			int priority;
+			std::string name;
+
+			if(!(stream >> priority >> std::ws) || !std::getline(stream, name) || name.empty())
+				continue;
+
+			DeviceManager::registerDevice(name, std::make_shared<LazyDeviceFactory>(plugin, name, priority));
+		}
+	}
+
+	return true;
+}
+
+AUD_NAMESPACE_END
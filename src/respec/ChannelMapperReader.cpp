@@ -17,6 +17,7 @@
 #include "respec/ChannelMapperReader.h"
 
 #include <cmath>
+#include <cstring>
 #include <limits>
 
 AUD_NAMESPACE_BEGIN
@@ -202,6 +203,12 @@ void ChannelMapperReader::read(int& length, bool& eos, sample_t* buffer)
 
 	m_reader->read(length, eos, in);
 
+	if(m_reader->isSilent())
+	{
+		std::memset(buffer, 0, length * m_target_channels * sizeof(sample_t));
+		return;
+	}
+
 	sample_t sum;
 
 	for(int i = 0; i < length; i++)
@@ -216,6 +223,11 @@ void ChannelMapperReader::read(int& length, bool& eos, sample_t* buffer)
 	}
 }
 
+bool ChannelMapperReader::isSeekAccurate() const
+{
+	return m_reader->isSeekAccurate();
+}
+
 const Channel ChannelMapperReader::MONO_MAP[] =
 {
 	CHANNEL_FRONT_CENTER
@@ -65,4 +65,15 @@ void ConverterReader::read(int& length, bool& eos, sample_t* buffer)
 	          length * specs.channels);
 }
 
+bool ConverterReader::isSilent() const
+{
+	// unsigned 8 bit silence isn't zero
+	return m_format != FORMAT_U8 && m_reader->isSilent();
+}
+
+bool ConverterReader::isSeekAccurate() const
+{
+	return m_reader->isSeekAccurate();
+}
+
 AUD_NAMESPACE_END
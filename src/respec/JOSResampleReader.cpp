@@ -37,7 +37,9 @@ JOSResampleReader::JOSResampleReader(std::shared_ptr<IReader> reader, SampleRate
 	m_n(0),
 	m_P(0),
 	m_cache_valid(0),
-	m_last_factor(0)
+	m_last_factor(0),
+	m_silent_samples(0),
+	m_silent(false)
 {
 }
 
@@ -47,6 +49,17 @@ void JOSResampleReader::reset()
 	m_n = 0;
 	m_P = 0;
 	m_last_factor = 0;
+	m_silent_samples = 0;
+}
+
+void JOSResampleReader::updateSilence(int length)
+{
+	if(m_reader->isSilent())
+		m_silent_samples += length;
+	else
+		m_silent_samples = 0;
+
+	m_silent = m_silent_samples >= m_cache_valid;
 }
 
 void JOSResampleReader::updateBuffer(int size, double factor, int samplesize)
@@ -310,6 +323,8 @@ void JOSResampleReader::read(int& length, bool& eos, sample_t* buffer)
 		m_reader->read(len, eos, buf + m_cache_valid * m_channels);
 		m_cache_valid += len;
 
+		updateSilence(len);
+
 		length = m_cache_valid - m_n;
 
 		if(length > 0)
@@ -338,6 +353,8 @@ void JOSResampleReader::read(int& length, bool& eos, sample_t* buffer)
 		m_reader->read(len, eos, m_buffer.getBuffer() + m_cache_valid * m_channels);
 		m_cache_valid += len;
 
+		updateSilence(len);
+
 		if(len < should)
 		{
 			if(len == 0 && eos)
@@ -378,6 +395,14 @@ void JOSResampleReader::read(int& length, bool& eos, sample_t* buffer)
 	}
 
 	eos = eos && ((m_n == m_cache_valid) || (length == 0));
+
+	// the output is silent if the whole filter input in the cache is
+	m_silent = m_silent_samples >= m_cache_valid;
+}
+
+bool JOSResampleReader::isSilent() const
+{
+	return m_silent;
 }
 
 AUD_NAMESPACE_END
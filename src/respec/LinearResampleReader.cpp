@@ -25,7 +25,8 @@ LinearResampleReader::LinearResampleReader(std::shared_ptr<IReader> reader, Samp
 	ResampleReader(reader, rate),
 	m_channels(reader->getSpecs().channels),
 	m_cache_pos(0),
-	m_cache_ok(false)
+	m_cache_ok(false),
+	m_silent(false)
 {
 	Specs specs = { rate, m_channels };
 	m_cache.resize(2 * AUD_SAMPLE_SIZE(specs));
@@ -85,6 +86,8 @@ void LinearResampleReader::read(int& length, bool& eos, sample_t* buffer)
 		// can read directly!
 		m_reader->read(length, eos, buffer);
 
+		m_silent = m_reader->isSilent();
+
 		if(length > 0)
 		{
 			std::memcpy(m_cache.getBuffer() + m_channels, buffer + m_channels * (length - 1), samplesize);
@@ -110,6 +113,12 @@ void LinearResampleReader::read(int& length, bool& eos, sample_t* buffer)
 		std::memcpy(buf, m_cache.getBuffer(), 2 * samplesize);
 		m_reader->read(len, eos, buf + 2 * m_channels);
 
+		m_silent = m_reader->isSilent();
+
+		// the cached samples have to be silent as well
+		for(int i = 0; m_silent && i < 2 * m_channels; i++)
+			m_silent = buf[i] == 0;
+
 		if(len < need)
 			length = std::floor((len + 1 - m_cache_pos) * factor);
 	}
@@ -127,6 +136,8 @@ void LinearResampleReader::read(int& length, bool& eos, sample_t* buffer)
 		std::memset(buf, 0, samplesize);
 		m_reader->read(len, eos, buf + m_channels);
 
+		m_silent = m_reader->isSilent();
+
 		if(len == 0)
 		{
 			length = 0;
@@ -171,4 +182,9 @@ void LinearResampleReader::read(int& length, bool& eos, sample_t* buffer)
 	eos &= length < size;
 }
 
+bool LinearResampleReader::isSilent() const
+{
+	return m_silent;
+}
+
 AUD_NAMESPACE_END
@@ -84,6 +84,22 @@ void Mixer::mix(sample_t* buffer, int start, int length, float volume)
 		out[i + start] += buffer[i] * volume;
 }
 
+void Mixer::mix(sample_t* buffer, int start, int length, float volume, const float* envelope)
+{
+	sample_t* out = m_buffer.getBuffer() + start * m_specs.channels;
+	int channels = m_specs.channels;
+
+	length = std::min(m_length, length + start) - start;
+
+	for(int i = 0; i < length; i++)
+	{
+		float gain = volume * envelope[i];
+
+		for(int channel = 0; channel < channels; channel++)
+			out[i * channels + channel] += buffer[i * channels + channel] * gain;
+	}
+}
+
 void Mixer::read(data_t* buffer, float volume)
 {
 	sample_t* out = m_buffer.getBuffer();
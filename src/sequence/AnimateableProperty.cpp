@@ -16,25 +16,35 @@
 
 #include "sequence/AnimateableProperty.h"
 
+#include <algorithm>
 #include <cstring>
 #include <cmath>
 #include <mutex>
 
+#if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+#define AUD_ANIMATION_SSE
+#include <xmmintrin.h>
+#endif
+
 AUD_NAMESPACE_BEGIN
 
 AnimateableProperty::AnimateableProperty(int count) :
-	Buffer(count * sizeof(float)), m_count(count), m_isAnimated(false)
+	Buffer(count * sizeof(float)), m_count(count), m_isAnimated(false), m_changed(false), m_changed_start(0), m_changed_end(0)
 {
 	std::memset(getBuffer(), 0, count * sizeof(float));
+
+	updateSnapshot();
 }
 
 AnimateableProperty::AnimateableProperty(int count, float value) :
-	Buffer(count * sizeof(float)), m_count(count), m_isAnimated(false)
+	Buffer(count * sizeof(float)), m_count(count), m_isAnimated(false), m_changed(false), m_changed_start(0), m_changed_end(0)
 {
 	sample_t* buf = getBuffer();
 
 	for(int i = 0; i < count; i++)
 		buf[i] = value;
+
+	updateSnapshot();
 }
 
 void AnimateableProperty::updateUnknownCache(int start, int end)
@@ -45,6 +55,157 @@ void AnimateableProperty::updateUnknownCache(int start, int end)
 	// as frames are only written when changing, so to support jumps, we need zero order interpolation here.
 	for(int i = start; i <= end; i++)
 		std::memcpy(buf + i * m_count, buf + (start - 1) * m_count, m_count * sizeof(float));
+
+	markChanged(start, end);
+}
+
+void AnimateableProperty::markChanged(int start, int end)
+{
+	if(m_changed)
+	{
+		m_changed_start = std::min(m_changed_start, start);
+		m_changed_end = std::max(m_changed_end, end);
+	}
+	else
+	{
+		m_changed_start = start;
+		m_changed_end = end;
+	}
+
+	m_changed = true;
+
+	if(m_edit_status)
+		(*m_edit_status)++;
+}
+
+void AnimateableProperty::setEditStatus(std::shared_ptr<std::atomic<int> > status)
+{
+	m_edit_status = status;
+}
+
+std::shared_ptr<const AnimateableProperty::Chunk> AnimateableProperty::buildChunk(int index, int last) const
+{
+	std::shared_ptr<Chunk> chunk = std::make_shared<Chunk>();
+
+	const float* buf = getBuffer();
+
+	int first = index * CHUNK_LENGTH;
+	int length = std::min(CHUNK_LENGTH, last + 1 - first);
+
+	chunk->values.assign(buf + first * m_count, buf + (first + length) * m_count);
+	chunk->coefficients.resize(length * m_count * 4);
+
+	float* coefficients = chunk->coefficients.data();
+
+	int end = std::min(first + length, last) * m_count;
+
+	last *= m_count;
+
+	// the cubic of read expanded into polynomial coefficients, the last frame has none
+	for(int pos = first * m_count; pos < end; pos += m_count)
+	{
+		const float* p1 = buf + pos;
+		const float* p0 = pos == 0 ? p1 : p1 - m_count;
+		const float* p2 = p1 + m_count;
+		const float* p3 = pos + m_count == last ? p2 : p2 + m_count;
+
+		for(int i = 0; i < m_count; i++, coefficients += 4)
+		{
+			float m0 = (p2[i] - p0[i]) / 2.0f;
+			float m1 = (p3[i] - p1[i]) / 2.0f;
+
+			coefficients[0] = p0[i];
+			coefficients[1] = m0;
+			coefficients[2] = -3 * p0[i] + 3 * p1[i] - 2 * m0 - m1;
+			coefficients[3] = 2 * p0[i] - 2 * p1[i] + m0 + m1;
+		}
+	}
+
+	return chunk;
+}
+
+void AnimateableProperty::updateSnapshot()
+{
+	std::shared_ptr<const Snapshot> previous = std::atomic_load(&m_snapshot);
+	std::shared_ptr<Snapshot> snapshot = std::make_shared<Snapshot>();
+
+	snapshot->animated = m_isAnimated;
+	snapshot->last = m_isAnimated ? getSize() / (sizeof(float) * m_count) - 1 : 0;
+	snapshot->chunks.resize(snapshot->last / CHUNK_LENGTH + 1);
+
+	int start = 0;
+	int end = snapshot->last;
+
+	if(previous && previous->animated && snapshot->animated)
+	{
+		// the interpolation of a frame uses the frame before and the two after it
+		start = std::max(m_changed_start - 2, 0);
+		end = std::min(m_changed_end + 1, snapshot->last);
+
+		// frames before the previous end were interpolated towards it
+		if(previous->last != snapshot->last)
+		{
+			start = std::min(start, std::max(previous->last - 2, 0));
+			end = snapshot->last;
+		}
+
+		std::size_t shared = std::min(previous->chunks.size(), snapshot->chunks.size());
+		std::copy(previous->chunks.begin(), previous->chunks.begin() + shared, snapshot->chunks.begin());
+	}
+
+	for(int index = start / CHUNK_LENGTH; index <= end / CHUNK_LENGTH; index++)
+		snapshot->chunks[index] = buildChunk(index, snapshot->last);
+
+	std::atomic_store(&m_snapshot, std::shared_ptr<const Snapshot>(snapshot));
+	m_changed = false;
+}
+
+std::shared_ptr<const AnimateableProperty::Snapshot> AnimateableProperty::getSnapshot()
+{
+	// writers only mark the snapshot outdated, so a series of writes is published once
+	if(m_changed)
+	{
+		std::lock_guard<std::recursive_mutex> lock(m_mutex);
+
+		if(m_changed)
+			updateSnapshot();
+	}
+
+	return std::atomic_load(&m_snapshot);
+}
+
+void AnimateableProperty::evaluate(const Snapshot& snapshot, int count, float position, float* out)
+{
+	if(!snapshot.animated)
+	{
+		std::memcpy(out, snapshot.chunks[0]->values.data(), count * sizeof(float));
+		return;
+	}
+
+	position = std::max(position, 0.0f);
+
+	float frame = std::floor(position);
+	float t = position - frame;
+
+	if(position >= snapshot.last)
+	{
+		frame = snapshot.last;
+		t = 0;
+	}
+
+	const Chunk& chunk = *snapshot.chunks[int(frame) / CHUNK_LENGTH];
+	int pos = (int(frame) % CHUNK_LENGTH) * count;
+
+	if(t == 0)
+	{
+		std::memcpy(out, chunk.values.data() + pos, count * sizeof(float));
+		return;
+	}
+
+	const float* coefficients = chunk.coefficients.data() + pos * 4;
+
+	for(int i = 0; i < count; i++, coefficients += 4)
+		out[i] = ((coefficients[3] * t + coefficients[2]) * t + coefficients[1]) * t + coefficients[0];
 }
 
 AnimateableProperty::~AnimateableProperty()
@@ -63,12 +224,16 @@ void AnimateableProperty::write(const float* data)
 	m_isAnimated = false;
 	m_unknown.clear();
 	std::memcpy(getBuffer(), data, m_count * sizeof(float));
+
+	markChanged(0, 0);
 }
 
 void AnimateableProperty::write(const float* data, int position, int count)
 {
 	std::lock_guard<std::recursive_mutex> lock(m_mutex);
 
+	markChanged(position, position + count - 1);
+
 	int pos = getSize() / (sizeof(float) * m_count);
 
 	if(!m_isAnimated)
@@ -154,59 +319,62 @@ void AnimateableProperty::write(const float* data, int position, int count)
 
 void AnimateableProperty::read(float position, float* out)
 {
-	std::lock_guard<std::recursive_mutex> lock(m_mutex);
+	evaluate(*getSnapshot(), m_count, position, out);
+}
 
-	if(!m_isAnimated)
+void AnimateableProperty::read(float position, float step, int count, float* out)
+{
+	std::shared_ptr<const Snapshot> snapshot = getSnapshot();
+
+	if(!snapshot->animated)
 	{
-		std::memcpy(out, getBuffer(), m_count * sizeof(float));
+		for(int i = 0; i < count; i++)
+			std::memcpy(out + i * m_count, snapshot->chunks[0]->values.data(), m_count * sizeof(float));
 		return;
 	}
 
-	int last = getSize() / (sizeof(float) * m_count) - 1;
-	float t = position - std::floor(position);
+	int i = 0;
 
-	if(position >= last)
+#ifdef AUD_ANIMATION_SSE
+	if(m_count == 1)
 	{
-		position = last;
-		t = 0;
-	}
+		__m128 zero = _mm_setzero_ps();
 
-	if(t == 0)
-	{
-		std::memcpy(out, getBuffer() + int(std::floor(position)) * m_count, m_count * sizeof(float));
-	}
-	else
-	{
-		int pos = int(std::floor(position)) * m_count;
-		float t2 = t * t;
-		float t3 = t2 * t;
-		float m0, m1;
-		float* p0;
-		float* p1 = getBuffer() + pos;
-		float* p2;
-		float* p3;
-		last *= m_count;
+		for(; i + 4 <= count; i += 4)
+		{
+			float first = position + i * step;
+			float frame = std::floor(first);
 
-		if(pos == 0)
-			p0 = p1;
-		else
-			p0 = p1 - m_count;
+			// four positions within the same interpolated frame are evaluated together
+			if(first < 0 || frame != std::floor(position + (i + 3) * step) || frame >= snapshot->last)
+			{
+				for(int j = i; j < i + 4; j++)
+					evaluate(*snapshot, 1, position + j * step, out + j);
+				continue;
+			}
 
-		p2 = p1 + m_count;
-		if(pos + m_count == last)
-			p3 = p2;
-		else
-			p3 = p2 + m_count;
+			const Chunk& chunk = *snapshot->chunks[int(frame) / CHUNK_LENGTH];
+			int pos = int(frame) % CHUNK_LENGTH;
+			const float* c = chunk.coefficients.data() + pos * 4;
 
-		for(int i = 0; i < m_count; i++)
-		{
-			m0 = (p2[i] - p0[i]) / 2.0f;
-			m1 = (p3[i] - p1[i]) / 2.0f;
+			__m128 index = _mm_setr_ps(float(i), float(i + 1), float(i + 2), float(i + 3));
+			__m128 t = _mm_sub_ps(_mm_add_ps(_mm_set1_ps(position), _mm_mul_ps(index, _mm_set1_ps(step))), _mm_set1_ps(frame));
 
-			out[i] = (2 * t3 - 3 * t2 + 1) * p0[i] + (-2 * t3 + 3 * t2) * p1[i] +
-					 (t3 - 2 * t2 + t) * m0 + (t3 - t2) * m1;
+			__m128 result = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(c[3]), t), _mm_set1_ps(c[2]));
+			result = _mm_add_ps(_mm_mul_ps(result, t), _mm_set1_ps(c[1]));
+			result = _mm_add_ps(_mm_mul_ps(result, t), _mm_set1_ps(c[0]));
+
+			// exact frames aren't interpolated
+			__m128 exact = _mm_cmpeq_ps(t, zero);
+			result = _mm_or_ps(_mm_and_ps(exact, _mm_set1_ps(chunk.values[pos])), _mm_andnot_ps(exact, result));
+
+			_mm_storeu_ps(out + i, result);
 		}
 	}
+#endif
+
+	for(; i < count; i++)
+		evaluate(*snapshot, m_count, position + i * step, out + i * m_count);
 }
 
 bool AnimateableProperty::isAnimated() const
@@ -21,7 +21,7 @@
 AUD_NAMESPACE_BEGIN
 
 DoubleReader::DoubleReader(std::shared_ptr<IReader> reader1, std::shared_ptr<IReader> reader2) :
-	m_reader1(reader1), m_reader2(reader2), m_finished1(false)
+	m_reader1(reader1), m_reader2(reader2), m_finished1(false), m_silent(false)
 {
 	Specs s1, s2;
 	s1 = reader1->getSpecs();
@@ -78,6 +78,8 @@ void DoubleReader::read(int& length, bool& eos, sample_t* buffer)
 
 		m_reader1->read(len, m_finished1, buffer);
 
+		m_silent = m_reader1->isSilent();
+
 		if(len < length)
 		{
 			Specs specs1, specs2;
@@ -88,6 +90,7 @@ void DoubleReader::read(int& length, bool& eos, sample_t* buffer)
 				int len2 = length - len;
 				m_reader2->read(len2, eos, buffer + specs1.channels * len);
 				length = len + len2;
+				m_silent = m_silent && m_reader2->isSilent();
 			}
 			else
 				length = len;
@@ -96,7 +99,13 @@ void DoubleReader::read(int& length, bool& eos, sample_t* buffer)
 	else
 	{
 		m_reader2->read(length, eos, buffer);
+		m_silent = m_reader2->isSilent();
 	}
 }
 
+bool DoubleReader::isSilent() const
+{
+	return m_silent;
+}
+
 AUD_NAMESPACE_END
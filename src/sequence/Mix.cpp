@@ -0,0 +1,78 @@
+/*******************************************************************************
+ * Copyright 2009-2016 Jörg Müller
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ ******************************************************************************/
+
+#include "sequence/Mix.h"
+#include "sequence/MixReader.h"
+#include "Exception.h"
+
+AUD_NAMESPACE_BEGIN
+
+Mix::Mix(std::vector<std::shared_ptr<ISound>> sounds) :
+	m_sounds(sounds), m_volumes(sounds.size(), 1.0f)
+{
+}
+
+Mix::Mix(std::vector<std::shared_ptr<ISound>> sounds, std::vector<float> volumes) :
+	m_sounds(sounds), m_volumes(volumes)
+{
+	if(m_sounds.size() != m_volumes.size())
+		AUD_THROW(StateException, "The amount of volumes has to match the amount of mixed sounds.");
+}
+
+Mix::Mix(std::shared_ptr<ISound> sound1, std::shared_ptr<ISound> sound2)
+{
+	add(sound1);
+	add(sound2);
+}
+
+void Mix::add(std::shared_ptr<ISound> sound)
+{
+	std::shared_ptr<Mix> mix = std::dynamic_pointer_cast<Mix>(sound);
+
+	if(mix)
+	{
+		m_sounds.insert(m_sounds.end(), mix->m_sounds.begin(), mix->m_sounds.end());
+		m_volumes.insert(m_volumes.end(), mix->m_volumes.begin(), mix->m_volumes.end());
+	}
+	else
+	{
+		m_sounds.push_back(sound);
+		m_volumes.push_back(1.0f);
+	}
+}
+
+const std::vector<std::shared_ptr<ISound>>& Mix::getSounds() const
+{
+	return m_sounds;
+}
+
+const std::vector<float>& Mix::getVolumes() const
+{
+	return m_volumes;
+}
+
+std::shared_ptr<IReader> Mix::createReader()
+{
+	std::vector<std::shared_ptr<IReader>> readers;
+	readers.reserve(m_sounds.size());
+
+	for(auto& sound : m_sounds)
+		readers.push_back(sound->createReader());
+
+	return std::shared_ptr<IReader>(new MixReader(readers, m_volumes));
+}
+
+AUD_NAMESPACE_END
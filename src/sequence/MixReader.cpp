@@ -0,0 +1,181 @@
+/*******************************************************************************
+ * Copyright 2009-2016 Jörg Müller
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ ******************************************************************************/
+
+#include "sequence/MixReader.h"
+#include "Exception.h"
+
+#include <algorithm>
+#include <cstring>
+
+#if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+#define AUD_MIX_SSE
+#include <xmmintrin.h>
+#endif
+
+AUD_NAMESPACE_BEGIN
+
+/// Multiplies count samples of buffer with volume.
+static inline void scaleSamples(sample_t* buffer, int count, float volume)
+{
+	int i = 0;
+
+#ifdef AUD_MIX_SSE
+	__m128 vol = _mm_set1_ps(volume);
+
+	for(; i + 4 <= count; i += 4)
+		_mm_storeu_ps(buffer + i, _mm_mul_ps(_mm_loadu_ps(buffer + i), vol));
+#endif
+
+	for(; i < count; i++)
+		buffer[i] *= volume;
+}
+
+/// Adds count samples of in multiplied with volume to out.
+static inline void accumulateSamples(sample_t* out, const sample_t* in, int count, float volume)
+{
+	int i = 0;
+
+#ifdef AUD_MIX_SSE
+	__m128 vol = _mm_set1_ps(volume);
+
+	for(; i + 4 <= count; i += 4)
+		_mm_storeu_ps(out + i, _mm_add_ps(_mm_loadu_ps(out + i), _mm_mul_ps(_mm_loadu_ps(in + i), vol)));
+#endif
+
+	for(; i < count; i++)
+		out[i] += in[i] * volume;
+}
+
+MixReader::MixReader(std::vector<std::shared_ptr<IReader>> readers, std::vector<float> volumes) :
+	m_readers(readers), m_volumes(volumes), m_silent(false)
+{
+	if(m_readers.empty())
+		AUD_THROW(StateException, "A mix needs at least one reader.");
+
+	if(m_readers.size() != m_volumes.size())
+		AUD_THROW(StateException, "The amount of volumes has to match the amount of mixed readers.");
+}
+
+MixReader::~MixReader()
+{
+}
+
+bool MixReader::isSeekable() const
+{
+	for(auto& reader : m_readers)
+		if(!reader->isSeekable())
+			return false;
+
+	return true;
+}
+
+void MixReader::seek(int position)
+{
+	for(auto& reader : m_readers)
+		reader->seek(position);
+}
+
+int MixReader::getLength() const
+{
+	int length = 0;
+
+	for(auto& reader : m_readers)
+	{
+		int len = reader->getLength();
+
+		if(len < 0)
+			return -1;
+
+		length = std::max(length, len);
+	}
+
+	return length;
+}
+
+int MixReader::getPosition() const
+{
+	int position = 0;
+
+	for(auto& reader : m_readers)
+		position = std::max(position, reader->getPosition());
+
+	return position;
+}
+
+Specs MixReader::getSpecs() const
+{
+	return m_readers[0]->getSpecs();
+}
+
+void MixReader::read(int& length, bool& eos, sample_t* buffer)
+{
+	Specs specs = m_readers[0]->getSpecs();
+
+	for(std::size_t i = 1; i < m_readers.size(); i++)
+	{
+		Specs s = m_readers[i]->getSpecs();
+		if(!AUD_COMPARE_SPECS(specs, s))
+			AUD_THROW(StateException, "Readers with different specifications cannot be mixed.");
+	}
+
+	int samplesize = AUD_SAMPLE_SIZE(specs);
+
+	// the first reader reads directly into the output buffer
+
+	int len = length;
+	m_readers[0]->read(len, eos, buffer);
+
+	m_silent = m_readers[0]->isSilent();
+
+	if(!m_silent && m_volumes[0] != 1.0f)
+		scaleSamples(buffer, len * specs.channels, m_volumes[0]);
+
+	if(len < length)
+		std::memset(buffer + len * specs.channels, 0, (length - len) * samplesize);
+
+	int max_len = len;
+
+	if(m_readers.size() > 1)
+	{
+		m_buffer.assureSize(length * samplesize);
+		sample_t* buf = m_buffer.getBuffer();
+
+		for(std::size_t i = 1; i < m_readers.size(); i++)
+		{
+			len = length;
+			bool reader_eos;
+			m_readers[i]->read(len, reader_eos, buf);
+
+			if(!m_readers[i]->isSilent())
+			{
+				accumulateSamples(buffer, buf, len * specs.channels, m_volumes[i]);
+				m_silent = false;
+			}
+
+			max_len = std::max(max_len, len);
+			eos &= reader_eos;
+		}
+	}
+
+	length = max_len;
+}
+
+bool MixReader::isSilent() const
+{
+	return m_silent;
+}
+
+AUD_NAMESPACE_END
@@ -0,0 +1,111 @@
+/*******************************************************************************
+ * Copyright 2009-2016 Jörg Müller
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ ******************************************************************************/
+
+#include "PrefetchReader.h"
+
+#include <algorithm>
+#include <cstring>
+
+AUD_NAMESPACE_BEGIN
+
+PrefetchReader::PrefetchReader(std::shared_ptr<IReader> reader, int position, int length) :
+	m_reader(reader), m_start(position), m_length(0), m_eos(false), m_position(position)
+{
+	Specs specs = reader->getSpecs();
+	int sample_size = AUD_SAMPLE_SIZE(specs);
+
+	reader->seek(position);
+
+	m_buffer.assureSize(length * sample_size);
+
+	while(m_length < length && !m_eos)
+	{
+		int len = length - m_length;
+		reader->read(len, m_eos, m_buffer.getBuffer() + m_length * specs.channels);
+
+		if(len <= 0 && !m_eos)
+			break;
+
+		m_length += len;
+	}
+
+	m_reader_position = m_start + m_length;
+}
+
+bool PrefetchReader::isSeekable() const
+{
+	return m_reader->isSeekable();
+}
+
+void PrefetchReader::seek(int position)
+{
+	m_position = position;
+}
+
+int PrefetchReader::getLength() const
+{
+	return m_reader->getLength();
+}
+
+int PrefetchReader::getPosition() const
+{
+	return m_position;
+}
+
+Specs PrefetchReader::getSpecs() const
+{
+	return m_reader->getSpecs();
+}
+
+void PrefetchReader::read(int& length, bool& eos, sample_t* buffer)
+{
+	int channels = m_reader->getSpecs().channels;
+	int done = 0;
+
+	eos = false;
+
+	// serve what has been decoded already
+	if(m_position >= m_start && m_position < m_start + m_length)
+	{
+		done = std::min(length, m_start + m_length - m_position);
+		std::memcpy(buffer, m_buffer.getBuffer() + (m_position - m_start) * channels, done * channels * sizeof(sample_t));
+		m_position += done;
+
+		if(m_eos && m_position == m_start + m_length)
+		{
+			length = done;
+			eos = true;
+			return;
+		}
+	}
+
+	if(done < length)
+	{
+		if(m_reader_position != m_position)
+			m_reader->seek(m_position);
+
+		int len = length - done;
+		m_reader->read(len, eos, buffer + done * channels);
+
+		m_position += len;
+		m_reader_position = m_position;
+		done += len;
+	}
+
+	length = done;
+}
+
+AUD_NAMESPACE_END
@@ -0,0 +1,77 @@
+/*******************************************************************************
+ * Copyright 2009-2016 Jörg Müller
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ ******************************************************************************/
+
+#pragma once
+
+#include "IReader.h"
+#include "util/Buffer.h"
+
+#include <memory>
+
+AUD_NAMESPACE_BEGIN
+
+/**
+ * This reader opens, seeks and decodes the beginning of a sound ahead of
+ * playback, so that starting it later doesn't stall the render thread.
+ * Reading continues seamlessly from the original reader after the decoded
+ * samples.
+ */
+class PrefetchReader : public IReader
+{
+private:
+	/// The reader that has been prefetched.
+	std::shared_ptr<IReader> m_reader;
+
+	/// The decoded samples.
+	Buffer m_buffer;
+
+	/// The position of the first decoded sample.
+	int m_start;
+
+	/// The number of decoded samples.
+	int m_length;
+
+	/// Whether the decoded samples end at the end of the reader.
+	bool m_eos;
+
+	/// The current position.
+	int m_position;
+
+	/// The position of the original reader.
+	int m_reader_position;
+
+	// delete copy constructor and operator=
+	PrefetchReader(const PrefetchReader&) = delete;
+	PrefetchReader& operator=(const PrefetchReader&) = delete;
+
+public:
+	/**
+	 * Creates a new prefetch reader, seeking and decoding immediately.
+	 * \param reader The reader to prefetch.
+	 * \param position The position to prefetch from.
+	 * \param length How many samples to decode.
+	 */
+	PrefetchReader(std::shared_ptr<IReader> reader, int position, int length);
+
+	virtual bool isSeekable() const;
+	virtual void seek(int position);
+	virtual int getLength() const;
+	virtual int getPosition() const;
+	virtual Specs getSpecs() const;
+	virtual void read(int& length, bool& eos, sample_t* buffer);
+};
+
+AUD_NAMESPACE_END
@@ -0,0 +1,32 @@
+/*******************************************************************************
+ * Copyright 2009-2016 Jörg Müller
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ ******************************************************************************/
+
+#include "sequence/Scrub.h"
+#include "sequence/ScrubReader.h"
+
+AUD_NAMESPACE_BEGIN
+
+Scrub::Scrub(std::shared_ptr<Sequence> sequence, float range, bool quality) :
+	m_sequence(sequence), m_range(range), m_quality(quality)
+{
+}
+
+std::shared_ptr<IReader> Scrub::createReader()
+{
+	return std::shared_ptr<IReader>(new ScrubReader(m_sequence, m_range, m_quality));
+}
+
+AUD_NAMESPACE_END
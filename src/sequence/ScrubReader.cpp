@@ -0,0 +1,235 @@
+/*******************************************************************************
+ * Copyright 2009-2016 Jörg Müller
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ ******************************************************************************/
+
+#include "sequence/ScrubReader.h"
+#include "sequence/Sequence.h"
+#include "sequence/SequenceData.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+// the size of the cached blocks in samples
+#define SCRUB_BLOCK 4096
+
+AUD_NAMESPACE_BEGIN
+
+ScrubReader::ScrubReader(std::shared_ptr<Sequence> sequence, float range, bool quality) :
+	m_sequence(sequence), m_specs(sequence->getSpecs()), m_position(0), m_current(0), m_generation(0), m_stop(false)
+{
+	m_reader = quality ? sequence->createQualityReader() : sequence->createReader();
+	m_cache_reader = quality ? sequence->createQualityReader() : sequence->createReader();
+
+	m_range = std::max(int(std::ceil(range * m_specs.rate / SCRUB_BLOCK)), 1);
+
+	m_buffer.assureSize(SCRUB_BLOCK * AUD_SAMPLE_SIZE(m_specs));
+
+	m_blocks = std::vector<Block>(2 * m_range + 1);
+
+	for(Block& block : m_blocks)
+	{
+		block.index = -1;
+		block.data.assureSize(SCRUB_BLOCK * AUD_SAMPLE_SIZE(m_specs));
+	}
+
+	m_edit_status = *sequence->m_sequence->m_edit_status;
+
+	m_thread = std::thread(&ScrubReader::run, this);
+}
+
+ScrubReader::~ScrubReader()
+{
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_stop = true;
+	}
+
+	m_condition.notify_all();
+	m_thread.join();
+}
+
+int ScrubReader::findMissingBlock() const
+{
+	int count = m_blocks.size();
+
+	// playback usually continues forward, so the blocks ahead come first
+	for(int index = m_current; index <= m_current + m_range; index++)
+		if(m_blocks[index % count].index != index)
+			return index;
+
+	for(int index = m_current - 1; index >= std::max(m_current - m_range, 0); index--)
+		if(m_blocks[index % count].index != index)
+			return index;
+
+	return -1;
+}
+
+void ScrubReader::renderBlock(IReader& reader, int index, sample_t* buffer)
+{
+	int position = index * SCRUB_BLOCK;
+	int length = SCRUB_BLOCK;
+	bool eos;
+
+	if(reader.getPosition() != position)
+		reader.seek(position);
+
+	reader.read(length, eos, buffer);
+}
+
+void ScrubReader::storeBlock(int index, int generation, const sample_t* buffer)
+{
+	if(generation != m_generation || index < m_current - m_range || index > m_current + m_range)
+		return;
+
+	Block& block = m_blocks[index % m_blocks.size()];
+	std::memcpy(block.data.getBuffer(), buffer, SCRUB_BLOCK * AUD_SAMPLE_SIZE(m_specs));
+	block.index = index;
+}
+
+void ScrubReader::checkSequence()
+{
+	// every edit of the sequence, its entries and their animations is counted here
+	int status = *m_sequence->m_sequence->m_edit_status;
+
+	if(m_edit_status == status)
+		return;
+
+	m_edit_status = status;
+
+	invalidate();
+}
+
+void ScrubReader::setPosition(int position)
+{
+	m_position = position;
+
+	std::lock_guard<std::mutex> lock(m_mutex);
+
+	if(m_current != position / SCRUB_BLOCK)
+	{
+		m_current = position / SCRUB_BLOCK;
+		m_condition.notify_all();
+	}
+}
+
+void ScrubReader::run()
+{
+	Buffer buffer(SCRUB_BLOCK * AUD_SAMPLE_SIZE(m_specs));
+
+	std::unique_lock<std::mutex> lock(m_mutex);
+
+	while(!m_stop)
+	{
+		int index = findMissingBlock();
+
+		if(index < 0)
+		{
+			m_condition.wait(lock);
+			continue;
+		}
+
+		int generation = m_generation;
+
+		lock.unlock();
+		renderBlock(*m_cache_reader, index, buffer.getBuffer());
+		lock.lock();
+
+		storeBlock(index, generation, buffer.getBuffer());
+	}
+}
+
+void ScrubReader::invalidate()
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+
+	m_generation++;
+
+	for(Block& block : m_blocks)
+		block.index = -1;
+
+	m_condition.notify_all();
+}
+
+bool ScrubReader::isSeekable() const
+{
+	return true;
+}
+
+void ScrubReader::seek(int position)
+{
+	if(position < 0)
+		return;
+
+	setPosition(position);
+}
+
+int ScrubReader::getLength() const
+{
+	return -1;
+}
+
+int ScrubReader::getPosition() const
+{
+	return m_position;
+}
+
+Specs ScrubReader::getSpecs() const
+{
+	return m_specs;
+}
+
+void ScrubReader::read(int& length, bool& eos, sample_t* buffer)
+{
+	checkSequence();
+
+	int channels = m_specs.channels;
+	int pos = 0;
+
+	while(pos < length)
+	{
+		int index = m_position / SCRUB_BLOCK;
+		int offset = m_position % SCRUB_BLOCK;
+		int len = std::min(length - pos, SCRUB_BLOCK - offset);
+
+		std::unique_lock<std::mutex> lock(m_mutex);
+
+		const Block& block = m_blocks[index % m_blocks.size()];
+
+		if(block.index == index)
+			std::memcpy(buffer + pos * channels, block.data.getBuffer() + offset * channels, len * channels * sizeof(sample_t));
+		else
+		{
+			// not cached yet, so render it here
+			int generation = m_generation;
+
+			lock.unlock();
+			renderBlock(*m_reader, index, m_buffer.getBuffer());
+			lock.lock();
+
+			std::memcpy(buffer + pos * channels, m_buffer.getBuffer() + offset * channels, len * channels * sizeof(sample_t));
+			storeBlock(index, generation, m_buffer.getBuffer());
+		}
+
+		lock.unlock();
+
+		pos += len;
+		setPosition(m_position + len);
+	}
+
+	eos = false;
+}
+
+AUD_NAMESPACE_END
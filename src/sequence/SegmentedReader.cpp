@@ -0,0 +1,170 @@
+/*******************************************************************************
+ * Copyright 2009-2016 Jörg Müller
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ ******************************************************************************/
+
+#include "sequence/SegmentedReader.h"
+#include "sequence/Sequence.h"
+#include "util/Buffer.h"
+#include "util/ThreadPool.h"
+
+#include <algorithm>
+#include <cstring>
+
+// segments are rendered in chunks aligned to multiples of this many samples, so that
+// the animation updates happen at the same positions regardless of the segmentation
+#define SEGMENT_CHUNK 1024
+
+// the number of segments queued per thread of the pool
+#define SEGMENTS_PER_THREAD 2
+
+AUD_NAMESPACE_BEGIN
+
+static std::shared_ptr<Buffer> render_segment(std::shared_ptr<Sequence> sequence, int start, int length, int preroll, std::shared_ptr<std::atomic<bool> > cancelled)
+{
+	std::shared_ptr<IReader> reader = sequence->createQualityReader();
+	int channels = reader->getSpecs().channels;
+
+	std::shared_ptr<Buffer> buffer = std::make_shared<Buffer>(length * channels * sizeof(sample_t));
+	Buffer chunk(SEGMENT_CHUNK * channels * sizeof(sample_t));
+	sample_t* buf = chunk.getBuffer();
+
+	int begin = std::max(start - preroll, 0);
+	begin -= begin % SEGMENT_CHUNK;
+	int end = start + length;
+	bool eos = false;
+	int len;
+
+	reader->seek(begin);
+
+	for(int pos = begin; pos < end; pos += len)
+	{
+		if(*cancelled)
+			return nullptr;
+
+		len = std::min(SEGMENT_CHUNK - pos % SEGMENT_CHUNK, end - pos);
+		reader->read(len, eos, buf);
+
+		// everything before the start is pre-roll
+		int offset = std::max(start - pos, 0);
+
+		if(offset < len)
+			std::memcpy(buffer->getBuffer() + (pos + offset - start) * channels, buf + offset * channels, (len - offset) * channels * sizeof(sample_t));
+	}
+
+	return buffer;
+}
+
+SegmentedReader::SegmentedReader(std::shared_ptr<Sequence> sequence, std::shared_ptr<ThreadPool> pool, float segment, float preroll) :
+	m_sequence(sequence), m_pool(pool), m_specs(sequence->getSpecs()), m_position(0), m_next(0), m_cancelled(std::make_shared<std::atomic<bool> >(false))
+{
+	m_segment_length = std::max(int(segment * m_specs.rate), 1);
+	m_preroll = std::max(int(preroll * m_specs.rate), 0);
+}
+
+SegmentedReader::~SegmentedReader()
+{
+	cancelSegments();
+}
+
+void SegmentedReader::queueSegments()
+{
+	unsigned int count = std::max(m_pool->getNumOfThreads(), 1u) * SEGMENTS_PER_THREAD;
+
+	while(m_segments.size() < count)
+	{
+		Segment segment;
+		segment.start = m_next;
+		segment.buffer = m_pool->enqueue(render_segment, m_sequence, m_next, m_segment_length, m_preroll, m_cancelled).share();
+		m_segments.push_back(segment);
+
+		m_next += m_segment_length;
+	}
+}
+
+void SegmentedReader::cancelSegments()
+{
+	*m_cancelled = true;
+	m_cancelled = std::make_shared<std::atomic<bool> >(false);
+	m_segments.clear();
+}
+
+bool SegmentedReader::isSeekable() const
+{
+	return true;
+}
+
+void SegmentedReader::seek(int position)
+{
+	if(position < 0)
+		return;
+
+	m_position = position;
+
+	// keep the segments if the position stays inside them
+	if(!m_segments.empty() && position >= m_segments.front().start && position < m_next)
+	{
+		while(position >= m_segments.front().start + m_segment_length)
+			m_segments.pop_front();
+
+		return;
+	}
+
+	cancelSegments();
+	m_next = position;
+}
+
+int SegmentedReader::getLength() const
+{
+	return -1;
+}
+
+int SegmentedReader::getPosition() const
+{
+	return m_position;
+}
+
+Specs SegmentedReader::getSpecs() const
+{
+	return m_specs;
+}
+
+void SegmentedReader::read(int& length, bool& eos, sample_t* buffer)
+{
+	int channels = m_specs.channels;
+	int pos = 0;
+
+	while(pos < length)
+	{
+		queueSegments();
+
+		Segment& segment = m_segments.front();
+		int offset = m_position - segment.start;
+		int len = std::min(length - pos, m_segment_length - offset);
+
+		std::shared_ptr<Buffer> data = segment.buffer.get();
+
+		std::memcpy(buffer + pos * channels, data->getBuffer() + offset * channels, len * channels * sizeof(sample_t));
+
+		pos += len;
+		m_position += len;
+
+		if(m_position >= segment.start + m_segment_length)
+			m_segments.pop_front();
+	}
+
+	eos = false;
+}
+
+AUD_NAMESPACE_END
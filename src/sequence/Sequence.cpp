@@ -85,6 +85,16 @@ void Sequence::setDistanceModel(DistanceModel model)
 	m_sequence->setDistanceModel(model);
 }
 
+float Sequence::getLookAhead() const
+{
+	return m_sequence->getLookAhead();
+}
+
+void Sequence::setLookAhead(float time)
+{
+	m_sequence->setLookAhead(time);
+}
+
 AnimateableProperty* Sequence::getAnimProperty(AnimateablePropertyType type)
 {
 	return m_sequence->getAnimProperty(type);
@@ -18,24 +18,34 @@
 #include "sequence/SequenceReader.h"
 #include "sequence/SequenceEntry.h"
 
+#include <algorithm>
 #include <mutex>
 
+// readers that missed more changes than this resynchronize all entries
+#define MAX_ENTRY_CHANGES 1024
+
 AUD_NAMESPACE_BEGIN
 
 SequenceData::SequenceData(Specs specs, float fps, bool muted) :
 	m_specs(specs),
 	m_status(0),
 	m_entry_status(0),
+	m_edit_status(std::make_shared<std::atomic<int> >(0)),
 	m_id(0),
 	m_muted(muted),
 	m_fps(fps),
 	m_speed_of_sound(343.3f),
 	m_doppler_factor(1),
 	m_distance_model(DISTANCE_MODEL_INVERSE_CLAMPED),
+	m_look_ahead(2.0f),
 	m_volume(1, 1.0f),
 	m_location(3),
 	m_orientation(4)
 {
+	m_volume.setEditStatus(m_edit_status);
+	m_location.setEditStatus(m_edit_status);
+	m_orientation.setEditStatus(m_edit_status);
+
 	Quaternion q;
 	m_orientation.write(q.get());
 	float f = 1;
@@ -68,7 +78,7 @@ void SequenceData::setSpecs(Specs specs)
 	std::lock_guard<std::recursive_mutex> lock(m_mutex);
 
 	m_specs = specs;
-	m_status++;
+	changeStatus();
 }
 
 float SequenceData::getFPS() const
@@ -81,6 +91,8 @@ void SequenceData::setFPS(float fps)
 	std::lock_guard<std::recursive_mutex> lock(m_mutex);
 
 	m_fps = fps;
+
+	changeStatus();
 }
 
 void SequenceData::mute(bool muted)
@@ -88,6 +100,8 @@ void SequenceData::mute(bool muted)
 	std::lock_guard<std::recursive_mutex> lock(m_mutex);
 
 	m_muted = muted;
+
+	changeStatus();
 }
 
 bool SequenceData::isMuted() const
@@ -105,7 +119,7 @@ void SequenceData::setSpeedOfSound(float speed)
 	std::lock_guard<std::recursive_mutex> lock(m_mutex);
 
 	m_speed_of_sound = speed;
-	m_status++;
+	changeStatus();
 }
 
 float SequenceData::getDopplerFactor() const
@@ -118,7 +132,7 @@ void SequenceData::setDopplerFactor(float factor)
 	std::lock_guard<std::recursive_mutex> lock(m_mutex);
 
 	m_doppler_factor = factor;
-	m_status++;
+	changeStatus();
 }
 
 DistanceModel SequenceData::getDistanceModel() const
@@ -131,7 +145,19 @@ void SequenceData::setDistanceModel(DistanceModel model)
 	std::lock_guard<std::recursive_mutex> lock(m_mutex);
 
 	m_distance_model = model;
-	m_status++;
+	changeStatus();
+}
+
+float SequenceData::getLookAhead() const
+{
+	return m_look_ahead;
+}
+
+void SequenceData::setLookAhead(float time)
+{
+	std::lock_guard<std::recursive_mutex> lock(m_mutex);
+
+	m_look_ahead = std::max(time, 0.0f);
 }
 
 AnimateableProperty* SequenceData::getAnimProperty(AnimateablePropertyType type)
@@ -154,9 +180,11 @@ std::shared_ptr<SequenceEntry> SequenceData::add(std::shared_ptr<ISound> sound,
 	std::lock_guard<std::recursive_mutex> lock(m_mutex);
 
 	std::shared_ptr<SequenceEntry> entry = std::shared_ptr<SequenceEntry>(new SequenceEntry(sound, begin, end, skip, m_id++));
+	entry->m_sequence = shared_from_this();
+	entry->setEditStatus(m_edit_status);
 
 	m_entries.push_back(entry);
-	m_entry_status++;
+	addEntryChange(ENTRY_ADDED, entry->getID());
 
 	return entry;
 }
@@ -165,8 +193,44 @@ void SequenceData::remove(std::shared_ptr<SequenceEntry> entry)
 {
 	std::lock_guard<std::recursive_mutex> lock(m_mutex);
 
-	m_entries.remove(entry);
+	int id = entry->getID();
+
+	if(id < 0 || id >= int(m_entries.size()) || m_entries[id] != entry)
+		return;
+
+	m_entries[id] = nullptr;
+	addEntryChange(ENTRY_REMOVED, id);
+}
+
+void SequenceData::addEntryChange(EntryChangeType type, int id)
+{
+	EntryChange change;
+	change.type = type;
+	change.id = id;
+
+	m_entry_changes.push_back(change);
+
+	if(m_entry_changes.size() > MAX_ENTRY_CHANGES)
+		m_entry_changes.pop_front();
+
 	m_entry_status++;
+	(*m_edit_status)++;
+}
+
+void SequenceData::changeStatus()
+{
+	m_status++;
+	(*m_edit_status)++;
+}
+
+void SequenceData::entryMoved(SequenceEntry* entry)
+{
+	std::lock_guard<std::recursive_mutex> lock(m_mutex);
+
+	int id = entry->getID();
+
+	if(id < int(m_entries.size()) && m_entries[id].get() == entry)
+		addEntryChange(ENTRY_MOVED, id);
 }
 
 AUD_NAMESPACE_END
@@ -15,19 +15,61 @@
  ******************************************************************************/
 
 #include "sequence/SequenceEntry.h"
+#include "sequence/SequenceData.h"
 #include "sequence/SequenceReader.h"
+#include "fx/Limiter.h"
+#include "respec/JOSResample.h"
+#include "util/AsyncLoader.h"
+#include "util/StreamBuffer.h"
 
+#include <algorithm>
+#include <cmath>
 #include <limits>
+#include <map>
 #include <mutex>
+#include <tuple>
+
+// how much longer than played the sound is pre-rendered, so that the resampling filters don't run out of input
+#define FREEZE_MARGIN 0.1f
 
 AUD_NAMESPACE_BEGIN
 
+/// A pre-rendered sound kept for other entries freezing the same sound.
+struct FreezeCacheEntry
+{
+	/// The sound that has been rendered, to detect reused addresses.
+	std::weak_ptr<ISound> sound;
+
+	/// The rendered sound.
+	std::weak_ptr<ISound> frozen;
+};
+
+/// The global state of the freeze cache.
+struct FreezeCacheState
+{
+	/// The rendered sounds by the address of their sound, sample rate and rendered range.
+	std::map<std::tuple<const ISound*, int, float, float>, FreezeCacheEntry> entries;
+
+	/// Mutex for the cache.
+	std::mutex mutex;
+};
+
+static FreezeCacheState& freezeCacheState()
+{
+	static FreezeCacheState state;
+	return state;
+}
+
 SequenceEntry::SequenceEntry(std::shared_ptr<ISound> sound, float begin, float end, float skip, int id) :
 	m_status(0),
 	m_pos_status(1),
 	m_sound_status(0),
 	m_id(id),
 	m_sound(sound),
+	m_frozen(false),
+	m_freeze_rate(RATE_INVALID),
+	m_freeze_start(0),
+	m_freeze_end(-1),
 	m_begin(begin),
 	m_end(end),
 	m_skip(skip),
@@ -55,6 +97,178 @@ SequenceEntry::SequenceEntry(std::shared_ptr<ISound> sound, float begin, float e
 
 SequenceEntry::~SequenceEntry()
 {
+	stopFreeze();
+}
+
+void SequenceEntry::getPlaybackRange(float& start, float& end)
+{
+	start = m_skip;
+	end = -1;
+
+	if(m_end < 0 || m_begin > m_end)
+		return;
+
+	// a higher pitch plays more of the sound in the same time
+	float pitch = 1.0f;
+	std::shared_ptr<SequenceData> sequence = m_sequence.lock();
+
+	if(sequence && m_pitch.isAnimated())
+	{
+		float value;
+
+		for(int frame = int(std::floor(m_begin * sequence->m_fps)); frame <= int(std::ceil(m_end * sequence->m_fps)); frame++)
+		{
+			m_pitch.read(frame, &value);
+			pitch = std::max(pitch, value);
+		}
+	}
+	else
+	{
+		m_pitch.read(0, &pitch);
+		pitch = std::max(pitch, 1.0f);
+	}
+
+	end = m_skip + (m_end - m_begin) * pitch + FREEZE_MARGIN;
+}
+
+void SequenceEntry::startFreeze()
+{
+	if(!m_sound.get())
+		return;
+
+	std::shared_ptr<SequenceData> sequence = m_sequence.lock();
+	int rate = sequence ? int(sequence->m_specs.rate) : int(RATE_INVALID);
+
+	getPlaybackRange(m_freeze_start, m_freeze_end);
+
+	std::tuple<const ISound*, int, float, float> key(m_sound.get(), rate, m_freeze_start, m_freeze_end);
+
+	m_freeze_rate = rate;
+
+	FreezeCacheState& state = freezeCacheState();
+
+	{
+		std::lock_guard<std::mutex> lock(state.mutex);
+
+		auto it = state.entries.find(key);
+
+		if(it != state.entries.end())
+		{
+			std::shared_ptr<ISound> frozen = it->second.frozen.lock();
+
+			if(frozen && it->second.sound.lock() == m_sound)
+			{
+				m_frozen_sound = frozen;
+				m_sound_status++;
+				return;
+			}
+
+			state.entries.erase(it);
+		}
+	}
+
+	// only the played part is rendered, as sounds like generators or loops might not end
+	std::shared_ptr<ISound> sound = std::make_shared<Limiter>(m_sound, m_freeze_start, m_freeze_end);
+
+	// resampling is rendered as well, the channels are still mapped during playback
+	if(rate != RATE_INVALID)
+	{
+		DeviceSpecs specs;
+		specs.rate = SampleRate(rate);
+		specs.channels = CHANNELS_INVALID;
+		specs.format = FORMAT_INVALID;
+		sound = std::make_shared<JOSResample>(sound, specs);
+	}
+
+	// rendering sequentially keeps the states of effects intact
+	m_freeze_request = AsyncLoader::submit([sound](std::shared_ptr<LoadProgress> progress) -> std::shared_ptr<ISound> {
+		return std::make_shared<StreamBuffer>(sound, nullptr, STORAGE_FLOAT32, progress);
+	}, LOAD_PRIORITY_LOW);
+}
+
+void SequenceEntry::stopFreeze()
+{
+	if(m_freeze_request)
+		m_freeze_request->cancel();
+
+	m_freeze_request = nullptr;
+
+	if(m_frozen_sound)
+	{
+		m_frozen_sound = nullptr;
+		m_sound_status++;
+	}
+}
+
+void SequenceEntry::updateFreeze()
+{
+	std::lock_guard<std::recursive_mutex> lock(m_mutex);
+
+	if(!m_freeze_request || !m_freeze_request->isFinished())
+		return;
+
+	std::shared_ptr<ISound> frozen = m_freeze_request->getSound();
+	m_freeze_request = nullptr;
+
+	// if rendering failed, the entry keeps playing its sound
+	if(!frozen)
+		return;
+
+	m_frozen_sound = frozen;
+	m_sound_status++;
+
+	FreezeCacheEntry entry;
+	entry.sound = m_sound;
+	entry.frozen = frozen;
+
+	FreezeCacheState& state = freezeCacheState();
+
+	std::lock_guard<std::mutex> cache_lock(state.mutex);
+
+	// forget sounds that don't exist anymore
+	for(auto it = state.entries.begin(); it != state.entries.end();)
+	{
+		if(it->second.frozen.expired())
+			it = state.entries.erase(it);
+		else
+			++it;
+	}
+
+	state.entries[std::make_tuple(m_sound.get(), m_freeze_rate, m_freeze_start, m_freeze_end)] = entry;
+}
+
+void SequenceEntry::setEditStatus(std::shared_ptr<std::atomic<int> > status)
+{
+	m_edit_status = status;
+
+	m_volume.setEditStatus(status);
+	m_panning.setEditStatus(status);
+	m_pitch.setEditStatus(status);
+	m_location.setEditStatus(status);
+	m_orientation.setEditStatus(status);
+}
+
+void SequenceEntry::countEdit()
+{
+	if(m_edit_status)
+		(*m_edit_status)++;
+}
+
+void SequenceEntry::changeStatus()
+{
+	m_status++;
+	countEdit();
+}
+
+std::shared_ptr<ISound> SequenceEntry::getPlaybackSound() const
+{
+	return m_frozen_sound ? m_frozen_sound : m_sound;
+}
+
+float SequenceEntry::getPlaybackSkip() const
+{
+	// the pre-rendered sound starts at the skip it has been rendered for
+	return m_frozen_sound ? m_skip - m_freeze_start : m_skip;
 }
 
 void SequenceEntry::lock()
@@ -79,22 +293,73 @@ void SequenceEntry::setSound(std::shared_ptr<ISound> sound)
 
 	if(m_sound.get() != sound.get())
 	{
+		stopFreeze();
+
 		m_sound = sound;
 		m_sound_status++;
+		countEdit();
+
+		if(m_frozen)
+			startFreeze();
 	}
 }
 
-void SequenceEntry::move(float begin, float end, float skip)
+void SequenceEntry::freeze(bool frozen)
+{
+	std::lock_guard<std::recursive_mutex> lock(m_mutex);
+
+	if(m_frozen == frozen)
+		return;
+
+	m_frozen = frozen;
+
+	if(frozen)
+		startFreeze();
+	else
+		stopFreeze();
+}
+
+bool SequenceEntry::isFrozen()
 {
 	std::lock_guard<std::recursive_mutex> lock(m_mutex);
 
-	if(m_begin != begin || m_skip != skip || m_end != end)
+	return m_frozen;
+}
+
+void SequenceEntry::move(float begin, float end, float skip)
+{
+	std::shared_ptr<SequenceData> sequence;
+
 	{
+		std::lock_guard<std::recursive_mutex> lock(m_mutex);
+
+		if(m_begin == begin && m_skip == skip && m_end == end)
+			return;
+
 		m_begin = begin;
 		m_skip = skip;
 		m_end = end;
 		m_pos_status++;
+
+		// the pre-rendered part has to cover the new range
+		if(m_frozen)
+		{
+			float start, stop;
+			getPlaybackRange(start, stop);
+
+			if(start < m_freeze_start || (m_freeze_end >= 0 && (stop < 0 || stop > m_freeze_end)))
+			{
+				stopFreeze();
+				startFreeze();
+			}
+		}
+
+		sequence = m_sequence.lock();
 	}
+
+	// the sequence is notified without holding the entry lock, as readers lock the sequence before entries
+	if(sequence)
+		sequence->entryMoved(this);
 }
 
 bool SequenceEntry::isMuted()
@@ -107,6 +372,8 @@ void SequenceEntry::mute(bool mute)
 	std::lock_guard<std::recursive_mutex> lock(m_mutex);
 
 	m_muted = mute;
+
+	changeStatus();
 }
 
 int SequenceEntry::getID() const
@@ -145,7 +412,7 @@ void SequenceEntry::setRelative(bool relative)
 	if(m_relative != relative)
 	{
 		m_relative = relative;
-		m_status++;
+		changeStatus();
 	}
 }
 
@@ -159,7 +426,7 @@ void SequenceEntry::setVolumeMaximum(float volume)
 	std::lock_guard<std::recursive_mutex> lock(m_mutex);
 
 	m_volume_max = volume;
-	m_status++;
+	changeStatus();
 }
 
 float SequenceEntry::getVolumeMinimum()
@@ -172,7 +439,7 @@ void SequenceEntry::setVolumeMinimum(float volume)
 	std::lock_guard<std::recursive_mutex> lock(m_mutex);
 
 	m_volume_min = volume;
-	m_status++;
+	changeStatus();
 }
 
 float SequenceEntry::getDistanceMaximum()
@@ -185,7 +452,7 @@ void SequenceEntry::setDistanceMaximum(float distance)
 	std::lock_guard<std::recursive_mutex> lock(m_mutex);
 
 	m_distance_max = distance;
-	m_status++;
+	changeStatus();
 }
 
 float SequenceEntry::getDistanceReference()
@@ -198,7 +465,7 @@ void SequenceEntry::setDistanceReference(float distance)
 	std::lock_guard<std::recursive_mutex> lock(m_mutex);
 
 	m_distance_reference = distance;
-	m_status++;
+	changeStatus();
 }
 
 float SequenceEntry::getAttenuation()
@@ -211,7 +478,7 @@ void SequenceEntry::setAttenuation(float factor)
 	std::lock_guard<std::recursive_mutex> lock(m_mutex);
 
 	m_attenuation = factor;
-	m_status++;
+	changeStatus();
 }
 
 float SequenceEntry::getConeAngleOuter()
@@ -224,7 +491,7 @@ void SequenceEntry::setConeAngleOuter(float angle)
 	std::lock_guard<std::recursive_mutex> lock(m_mutex);
 
 	m_cone_angle_outer = angle;
-	m_status++;
+	changeStatus();
 }
 
 float SequenceEntry::getConeAngleInner()
@@ -237,7 +504,7 @@ void SequenceEntry::setConeAngleInner(float angle)
 	std::lock_guard<std::recursive_mutex> lock(m_mutex);
 
 	m_cone_angle_inner = angle;
-	m_status++;
+	changeStatus();
 }
 
 float SequenceEntry::getConeVolumeOuter()
@@ -250,7 +517,7 @@ void SequenceEntry::setConeVolumeOuter(float volume)
 	std::lock_guard<std::recursive_mutex> lock(m_mutex);
 
 	m_cone_volume_outer = volume;
-	m_status++;
+	changeStatus();
 }
 
 AUD_NAMESPACE_END
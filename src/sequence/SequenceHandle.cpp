@@ -15,13 +15,20 @@
  ******************************************************************************/
 
 #include "SequenceHandle.h"
+#include "PrefetchReader.h"
+#include "SharedSource.h"
 #include "sequence/SequenceEntry.h"
 #include "devices/ReadDevice.h"
+#include "util/AsyncLoader.h"
+#include "util/ThreadPool.h"
 #include "Exception.h"
 
+#include <chrono>
+#include <cmath>
 #include <mutex>
 
 #define KEEP_TIME 10
+#define PREFETCH_TIME 1
 
 AUD_NAMESPACE_BEGIN
 
@@ -39,9 +46,26 @@ void SequenceHandle::start()
 	// let's try playing
 	if(m_entry->m_sound.get())
 	{
+		std::shared_ptr<IReader> reader;
+
+		// use the prefetched reader if it's ready, otherwise open the sound now
+		if(m_prefetch.valid() && m_prefetch.wait_for(std::chrono::seconds(0)) == std::future_status::ready)
+		{
+			try
+			{
+				reader = m_prefetch.get();
+			}
+			catch(Exception&)
+			{
+			}
+		}
+
+		cancelPrefetch();
+
 		try
 		{
-			m_handle = m_device.play(m_entry->m_sound, true);
+			// entries playing the same sound in step read it only once
+			m_handle = m_device.play(SharedSource::createReader(m_sources, m_entry->getPlaybackSound(), reader), true);
 			m_3dhandle = std::dynamic_pointer_cast<I3DHandle>(m_handle);
 		}
 		catch(Exception&)
@@ -57,6 +81,15 @@ void SequenceHandle::start()
 	m_valid = m_handle.get();
 }
 
+void SequenceHandle::cancelPrefetch()
+{
+	if(m_prefetch_cancelled)
+		*m_prefetch_cancelled = true;
+
+	m_prefetch = std::future<std::shared_ptr<IReader> >();
+	m_prefetch_cancelled = nullptr;
+}
+
 bool SequenceHandle::updatePosition(float position)
 {
 	std::lock_guard<ILockable> lock(*m_entry);
@@ -108,18 +141,20 @@ bool SequenceHandle::updatePosition(float position)
 	return false;
 }
 
-SequenceHandle::SequenceHandle(std::shared_ptr<SequenceEntry> entry, ReadDevice& device) :
+SequenceHandle::SequenceHandle(std::shared_ptr<SequenceEntry> entry, ReadDevice& device, SharedSourceMap& sources) :
 	m_entry(entry),
 	m_valid(true),
 	m_status(0),
 	m_pos_status(0),
 	m_sound_status(0),
-	m_device(device)
+	m_device(device),
+	m_sources(sources)
 {
 }
 
 SequenceHandle::~SequenceHandle()
 {
+	cancelPrefetch();
 	stop();
 }
 
@@ -140,14 +175,62 @@ void SequenceHandle::stop()
 	m_3dhandle = nullptr;
 }
 
-void SequenceHandle::update(float position, float frame, float fps)
+void SequenceHandle::getPlayRange(float& begin, float& end)
+{
+	std::lock_guard<ILockable> lock(*m_entry);
+
+	begin = m_entry->m_begin;
+	end = m_entry->m_end;
+}
+
+void SequenceHandle::getUpdateRange(float& begin, float& end)
+{
+	std::lock_guard<ILockable> lock(*m_entry);
+
+	begin = m_entry->m_begin - KEEP_TIME;
+	end = m_entry->m_end + KEEP_TIME;
+}
+
+void SequenceHandle::prefetch(float position, float window)
 {
+	if(!m_valid || m_handle.get() || m_prefetch.valid())
+		return;
+
+	std::lock_guard<ILockable> lock(*m_entry);
+
+	// entries that already play are started right away anyway
+	if(!m_entry->m_sound.get() || m_entry->m_begin <= position || m_entry->m_begin > position + window)
+		return;
+
+	std::shared_ptr<ISound> sound = m_entry->getPlaybackSound();
+	float skip = m_entry->getPlaybackSkip();
+	std::shared_ptr<std::atomic<bool> > cancelled = std::make_shared<std::atomic<bool> >(false);
+
+	m_prefetch_cancelled = cancelled;
+	m_prefetch = AsyncLoader::getDecodePool()->enqueue([sound, skip, cancelled]() -> std::shared_ptr<IReader> {
+		if(*cancelled)
+			return nullptr;
+
+		std::shared_ptr<IReader> reader = sound->createReader();
+		double rate = reader->getSpecs().rate;
+
+		return std::make_shared<PrefetchReader>(reader, int(std::round(skip * rate)), int(PREFETCH_TIME * rate));
+	});
+}
+
+void SequenceHandle::update(float position, float frame, float fps, int length, float step)
+{
+	m_entry->updateFreeze();
+
 	if(m_sound_status != m_entry->m_sound_status)
 	{
 		// if a new sound has been set, it's possible to get valid again!
 		m_sound_status = m_entry->m_sound_status;
 		m_valid = true;
 
+		// a prefetched reader would play the old sound
+		cancelPrefetch();
+
 		// stop whatever sound has been playing
 		stop();
 
@@ -207,8 +290,21 @@ void SequenceHandle::update(float position, float frame, float fps)
 
 	float value;
 
-	m_entry->m_volume.read(frame, &value);
-	m_handle->setVolume(value);
+	// animated volumes are applied per sample by the envelope
+	if(m_entry->m_volume.isAnimated())
+	{
+		m_envelope.assureSize(length * sizeof(float));
+		m_entry->m_volume.read(frame, step, length, m_envelope.getBuffer());
+		m_handle->setVolume(1.0f);
+		SoftwareDevice::setVolumeEnvelope(m_handle.get(), m_envelope.getBuffer());
+	}
+	else
+	{
+		m_entry->m_volume.read(frame, &value);
+		m_handle->setVolume(value);
+		SoftwareDevice::setVolumeEnvelope(m_handle.get(), nullptr);
+	}
+
 	m_entry->m_pitch.read(frame, &value);
 	m_handle->setPitch(value);
 	m_entry->m_panning.read(frame, &value);
@@ -229,6 +325,11 @@ void SequenceHandle::update(float position, float frame, float fps)
 		m_handle->setVolume(0);
 }
 
+bool SequenceHandle::isBlockAnimated() const
+{
+	return m_entry->m_pitch.isAnimated() || m_entry->m_panning.isAnimated() || m_entry->m_location.isAnimated() || m_entry->m_orientation.isAnimated();
+}
+
 bool SequenceHandle::seek(float position)
 {
 	if(!m_valid)
@@ -243,7 +344,7 @@ bool SequenceHandle::seek(float position)
 	float seekpos = position - m_entry->m_begin;
 	if(seekpos < 0)
 		seekpos = 0;
-	seekpos += m_entry->m_skip;
+	seekpos += m_entry->getPlaybackSkip();
 	m_handle->setPitch(1.0f);
 	m_handle->seek(seekpos);
 
@@ -17,13 +17,18 @@
 #pragma once
 
 #include "Audaspace.h"
+#include "SharedSource.h"
+#include "util/Buffer.h"
 
+#include <atomic>
+#include <future>
 #include <memory>
 
 AUD_NAMESPACE_BEGIN
 
 class ReadDevice;
 class IHandle;
+class IReader;
 class I3DHandle;
 class SequenceEntry;
 
@@ -57,6 +62,18 @@ private:
 	/// The read device this handle is played on.
 	ReadDevice& m_device;
 
+	/// The shared sources of the sequence reader.
+	SharedSourceMap& m_sources;
+
+	/// The volume envelope of the current block.
+	Buffer m_envelope;
+
+	/// The reader being prefetched in the background.
+	std::future<std::shared_ptr<IReader> > m_prefetch;
+
+	/// Tells the prefetch task that its result isn't needed anymore.
+	std::shared_ptr<std::atomic<bool> > m_prefetch_cancelled;
+
 	// delete copy constructor and operator=
 	SequenceHandle(const SequenceHandle&) = delete;
 	SequenceHandle& operator=(const SequenceHandle&) = delete;
@@ -66,6 +83,11 @@ private:
 	 */
 	void start();
 
+	/**
+	 * Drops the prefetched reader, cancelling the prefetch if still running.
+	 */
+	void cancelPrefetch();
+
 	/**
 	 * Updates the handle state depending on position.
 	 * \param position Current playback position in seconds.
@@ -78,8 +100,9 @@ public:
 	 * Creates a new sequenced handle.
 	 * \param entry The entry this handle plays.
 	 * \param device The read device to play on.
+	 * \param sources The shared sources of the sequence reader.
 	 */
-	SequenceHandle(std::shared_ptr<SequenceEntry> entry, ReadDevice& device);
+	SequenceHandle(std::shared_ptr<SequenceEntry> entry, ReadDevice& device, SharedSourceMap& sources);
 
 	/**
 	 * Destroys the handle.
@@ -99,12 +122,41 @@ public:
 	void stop();
 
 	/**
-	 * Updates the handle for playback.
+	 * Retrieves the time range in which the entry plays.
+	 * \param begin The time the entry starts playing.
+	 * \param end The time the entry stops playing.
+	 */
+	void getPlayRange(float& begin, float& end);
+
+	/**
+	 * Retrieves the time range in which the handle has to be updated.
+	 * \param begin The time from which on the handle has to be updated.
+	 * \param end The time after which updates only stop the handle.
+	 */
+	void getUpdateRange(float& begin, float& end);
+
+	/**
+	 * Prefetches the sound in the background if the entry starts soon.
+	 * \param position The current time during playback.
+	 * \param window How far ahead of the position entries are prefetched.
+	 */
+	void prefetch(float position, float window);
+
+	/**
+	 * Updates the handle for playback of the next block.
 	 * \param position The current time during playback.
 	 * \param frame The current frame during playback.
 	 * \param fps The animation frames per second.
+	 * \param length The length of the block in samples.
+	 * \param step The animation frames per sample.
+	 */
+	void update(float position, float frame, float fps, int length, float step);
+
+	/**
+	 * Returns whether properties that are only updated once per block are animated.
+	 * \return Whether the pitch, panning or 3D parameters are animated.
 	 */
-	void update(float position, float frame, float fps);
+	bool isBlockAnimated() const;
 
 	/**
 	 * Seeks the handle to a specific time position.
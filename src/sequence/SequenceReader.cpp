@@ -20,21 +20,281 @@
 #include "SequenceHandle.h"
 
 #include <algorithm>
+#include <cstring>
+#include <limits>
 #include <mutex>
 #include <cmath>
 
 AUD_NAMESPACE_BEGIN
 
 SequenceReader::SequenceReader(std::shared_ptr<SequenceData> sequence, bool quality) :
-	m_position(0), m_device(sequence->m_specs), m_sequence(sequence), m_status(0), m_entry_status(0)
+	m_position(0), m_device(sequence->m_specs), m_sequence(sequence), m_status(0), m_entry_status(-1), m_next_scheduled(0),
+	m_schedule_time(-std::numeric_limits<float>::infinity()), m_schedule_invalid(true), m_silent(false)
 {
 	m_device.setQuality(quality);
+
+	// the overall volume is applied by the reader
+	m_device.setVolume(1.0f);
 }
 
 SequenceReader::~SequenceReader()
 {
 }
 
+bool SequenceReader::isScheduledBefore(int a, int b) const
+{
+	const ScheduledHandle& first = m_handles[a];
+	const ScheduledHandle& second = m_handles[b];
+
+	// handles starting at the same time stay in ID order
+	return first.begin < second.begin || (first.begin == second.begin && a < b);
+}
+
+void SequenceReader::schedule(int id)
+{
+	ScheduledHandle& scheduled = m_handles[id];
+	scheduled.handle->getUpdateRange(scheduled.begin, scheduled.end);
+
+	m_schedule.insert(std::lower_bound(m_schedule.begin(), m_schedule.end(), id, [this](int a, int b) { return isScheduledBefore(a, b); }), id);
+
+	// handles starting after the last update are activated when the playhead gets there
+	if(scheduled.begin <= m_schedule_time)
+	{
+		m_next_scheduled++;
+
+		if(scheduled.end >= m_schedule_time && !scheduled.active)
+		{
+			scheduled.active = true;
+			m_active.push_back(id);
+		}
+	}
+}
+
+void SequenceReader::unschedule(int id)
+{
+	ScheduledHandle& scheduled = m_handles[id];
+
+	auto it = std::lower_bound(m_schedule.begin(), m_schedule.end(), id, [this](int a, int b) { return isScheduledBefore(a, b); });
+
+	if(it != m_schedule.end() && *it == id)
+	{
+		if(std::size_t(it - m_schedule.begin()) < m_next_scheduled)
+			m_next_scheduled--;
+
+		m_schedule.erase(it);
+	}
+
+	if(scheduled.active)
+	{
+		m_active.erase(std::find(m_active.begin(), m_active.end(), id));
+		scheduled.active = false;
+	}
+}
+
+void SequenceReader::addHandle(int id)
+{
+	// the entry might have been removed again already
+	if(id >= int(m_sequence->m_entries.size()) || !m_sequence->m_entries[id])
+		return;
+
+	if(id >= int(m_handles.size()))
+		m_handles.resize(id + 1);
+
+	ScheduledHandle& scheduled = m_handles[id];
+
+	if(scheduled.handle)
+		return;
+
+	try
+	{
+		scheduled.handle = std::shared_ptr<SequenceHandle>(new SequenceHandle(m_sequence->m_entries[id], m_device, m_sources));
+		scheduled.active = false;
+	}
+	catch(Exception&)
+	{
+		return;
+	}
+
+	schedule(id);
+}
+
+void SequenceReader::removeHandle(int id)
+{
+	if(id >= int(m_handles.size()) || !m_handles[id].handle)
+		return;
+
+	unschedule(id);
+
+	m_handles[id].handle->stop();
+	m_handles[id].handle = nullptr;
+}
+
+void SequenceReader::moveHandle(int id)
+{
+	if(id >= int(m_handles.size()) || !m_handles[id].handle)
+		return;
+
+	ScheduledHandle& scheduled = m_handles[id];
+	bool active = scheduled.active;
+
+	unschedule(id);
+	schedule(id);
+
+	// moved away from the playhead
+	if(active && !scheduled.active)
+		scheduled.handle->stop();
+}
+
+void SequenceReader::synchronizeHandles()
+{
+	auto& entries = m_sequence->m_entries;
+
+	if(m_handles.size() < entries.size())
+		m_handles.resize(entries.size());
+
+	for(std::size_t id = 0; id < m_handles.size(); id++)
+	{
+		ScheduledHandle& scheduled = m_handles[id];
+
+		if(id >= entries.size() || !entries[id])
+			removeHandle(id);
+		else if(!scheduled.handle)
+		{
+			try
+			{
+				scheduled.handle = std::shared_ptr<SequenceHandle>(new SequenceHandle(entries[id], m_device, m_sources));
+			}
+			catch(Exception&)
+			{
+			}
+		}
+	}
+
+	m_schedule_invalid = true;
+}
+
+void SequenceReader::buildSchedule(float time)
+{
+	// only active handles can be playing, stop the ones that won't be active anymore
+	for(int id : m_active)
+	{
+		ScheduledHandle& scheduled = m_handles[id];
+		scheduled.active = false;
+
+		if(!scheduled.handle)
+			continue;
+
+		float begin, end;
+		scheduled.handle->getUpdateRange(begin, end);
+
+		if(time < begin || time > end)
+			scheduled.handle->stop();
+	}
+
+	m_schedule.clear();
+	m_active.clear();
+
+	for(std::size_t id = 0; id < m_handles.size(); id++)
+	{
+		ScheduledHandle& scheduled = m_handles[id];
+		scheduled.active = false;
+
+		if(scheduled.handle)
+		{
+			scheduled.handle->getUpdateRange(scheduled.begin, scheduled.end);
+			m_schedule.push_back(id);
+		}
+	}
+
+	std::sort(m_schedule.begin(), m_schedule.end(), [this](int a, int b) { return isScheduledBefore(a, b); });
+
+	m_next_scheduled = 0;
+	m_schedule_time = -std::numeric_limits<float>::infinity();
+	m_schedule_invalid = false;
+}
+
+void SequenceReader::activateHandles(float time)
+{
+	m_schedule_time = time;
+
+	for(; m_next_scheduled < m_schedule.size() && m_handles[m_schedule[m_next_scheduled]].begin <= time; m_next_scheduled++)
+	{
+		ScheduledHandle& scheduled = m_handles[m_schedule[m_next_scheduled]];
+
+		if(scheduled.end >= time && !scheduled.active)
+		{
+			scheduled.active = true;
+			m_active.push_back(m_schedule[m_next_scheduled]);
+		}
+	}
+}
+
+int SequenceReader::getSliceLength(int position, int length) const
+{
+	double rate = m_sequence->m_specs.rate;
+	int end = position + length;
+
+	// splits at the first sample whose time is not before the given one
+	auto split = [&](float time) {
+		double sample = std::floor(double(time) * rate);
+
+		if(float(sample / rate) < time)
+			sample++;
+
+		if(sample > position && sample < end)
+			end = int(sample);
+	};
+
+	for(int id : m_active)
+	{
+		float begin, stop;
+		m_handles[id].handle->getPlayRange(begin, stop);
+		split(begin);
+		split(stop);
+	}
+
+	if(m_next_scheduled < m_schedule.size())
+		split(m_handles[m_schedule[m_next_scheduled]].begin);
+
+	// only volumes are applied per sample, other animations are stepped per frame
+	bool animated = m_sequence->m_location.isAnimated() || m_sequence->m_orientation.isAnimated();
+
+	for(std::size_t i = 0; !animated && i < m_active.size(); i++)
+		animated = m_handles[m_active[i]].handle->isBlockAnimated();
+
+	if(animated)
+	{
+		float fps = m_sequence->m_fps;
+		float frame = float(double(position) / rate) * fps;
+		split((std::floor(frame) + 1) / fps);
+	}
+
+	return end - position;
+}
+
+void SequenceReader::updateHandles(float time, float frame, int length, float step)
+{
+	std::size_t count = 0;
+	float look_ahead = m_sequence->m_look_ahead;
+
+	for(int id : m_active)
+	{
+		ScheduledHandle& scheduled = m_handles[id];
+		scheduled.handle->update(time, frame, m_sequence->m_fps, length, step);
+
+		if(look_ahead > 0)
+			scheduled.handle->prefetch(time, look_ahead);
+
+		// the update after the end stopped the handle, so it can be retired
+		if(scheduled.end >= time)
+			m_active[count++] = id;
+		else
+			scheduled.active = false;
+	}
+
+	m_active.resize(count);
+}
+
 bool SequenceReader::isSeekable() const
 {
 	return true;
@@ -45,11 +305,15 @@ void SequenceReader::seek(int position)
 	if(position < 0)
 		return;
 
+	// the schedule only moves forward
+	if(position < m_position)
+		m_schedule_invalid = true;
+
 	m_position = position;
 
-	for(auto& handle : m_handles)
+	for(int id : m_active)
 	{
-		handle->seek(position / m_sequence->m_specs.rate);
+		m_handles[id].handle->seek(position / m_sequence->m_specs.rate);
 	}
 }
 
@@ -70,7 +334,7 @@ Specs SequenceReader::getSpecs() const
 
 void SequenceReader::read(int& length, bool& eos, sample_t* buffer)
 {
-	std::lock_guard<ILockable> lock(*m_sequence);
+	std::unique_lock<ILockable> lock(*m_sequence);
 
 	if(m_sequence->m_status != m_status)
 	{
@@ -84,97 +348,57 @@ void SequenceReader::read(int& length, bool& eos, sample_t* buffer)
 
 	if(m_sequence->m_entry_status != m_entry_status)
 	{
-		std::list<std::shared_ptr<SequenceHandle> > handles;
-
-		auto hit = m_handles.begin();
-		auto eit = m_sequence->m_entries.begin();
-
-		int result;
-		std::shared_ptr<SequenceHandle> handle;
+		auto& changes = m_sequence->m_entry_changes;
+		int first = m_sequence->m_entry_status - int(changes.size());
 
-		while(hit != m_handles.end() && eit != m_sequence->m_entries.end())
+		// readers that missed changes which aren't logged anymore synchronize all entries
+		if(m_entry_status < first)
+			synchronizeHandles();
+		else
 		{
-			handle = *hit;
-			std::shared_ptr<SequenceEntry> entry = *eit;
-
-			result = handle->compare(entry);
-
-			if(result < 0)
+			for(auto it = changes.begin() + (m_entry_status - first); it != changes.end(); it++)
 			{
-				try
-				{
-					handle = std::shared_ptr<SequenceHandle>(new SequenceHandle(entry, m_device));
-					handles.push_back(handle);
-				}
-				catch(Exception&)
+				switch(it->type)
 				{
+				case SequenceData::ENTRY_ADDED:
+					addHandle(it->id);
+					break;
+				case SequenceData::ENTRY_REMOVED:
+					removeHandle(it->id);
+					break;
+				case SequenceData::ENTRY_MOVED:
+					moveHandle(it->id);
+					break;
 				}
-				eit++;
-			}
-			else if(result == 0)
-			{
-				handles.push_back(handle);
-				hit++;
-				eit++;
-			}
-			else
-			{
-				handle->stop();
-				hit++;
-			}
-		}
-
-		while(hit != m_handles.end())
-		{
-			(*hit)->stop();
-			hit++;
-		}
-
-		while(eit != m_sequence->m_entries.end())
-		{
-			try
-			{
-				handle = std::shared_ptr<SequenceHandle>(new SequenceHandle(*eit, m_device));
-				handles.push_back(handle);
-			}
-			catch(Exception&)
-			{
 			}
-			eit++;
 		}
 
-		m_handles = handles;
-
 		m_entry_status = m_sequence->m_entry_status;
 	}
 
 	Specs specs = m_sequence->m_specs;
 	int pos = 0;
-	float time = float(m_position) / float(specs.rate);
-	float volume, frame;
-	int len, cfra;
+	float step = m_sequence->m_fps / float(specs.rate);
+	float time, frame;
+	int len;
 	Vector3 v, v2;
 	Quaternion q;
 
+	m_silent = true;
 
 	while(pos < length)
 	{
+		time = float(double(m_position + pos) / specs.rate);
 		frame = time * m_sequence->m_fps;
-		cfra = int(std::floor(frame));
 
-		len = int(std::ceil((cfra + 1) / m_sequence->m_fps * specs.rate)) - m_position;
-		len = std::min(length - pos, len);
-		len = std::max(len, 1);
+		if(m_schedule_invalid)
+			buildSchedule(time);
 
-		for(auto& handle : m_handles)
-		{
-			handle->update(time, frame, m_sequence->m_fps);
-		}
+		activateHandles(time);
 
-		m_sequence->m_volume.read(frame, &volume);
-		if(m_sequence->m_muted)
-			volume = 0.0f;
-		m_device.setVolume(volume);
+		len = getSliceLength(m_position + pos, length - pos);
+
+		updateHandles(time, frame, len, step);
 
 		m_sequence->m_orientation.read(frame, q.get());
 		m_device.setListenerOrientation(q);
@@ -184,10 +408,41 @@ void SequenceReader::read(int& length, bool& eos, sample_t* buffer)
 		v2 -= v;
 		m_device.setListenerVelocity(v2 * m_sequence->m_fps);
 
-		m_device.read(reinterpret_cast<data_t*>(buffer + specs.channels * pos), len);
+		sample_t* buf = buffer + specs.channels * pos;
+
+		// mixing only touches this reader's device, so other readers of the sequence can run meanwhile
+		lock.unlock();
+		m_device.read(reinterpret_cast<data_t*>(buf), len);
+		lock.lock();
+		m_silent = m_silent && m_device.isSilent();
+
+		// the overall volume is applied per sample
+		if(m_sequence->m_muted)
+			std::memset(buf, 0, len * specs.channels * sizeof(sample_t));
+		else if(!m_device.isSilent())
+		{
+			if(m_sequence->m_volume.isAnimated())
+			{
+				m_envelope.assureSize(len * sizeof(float));
+				float* envelope = m_envelope.getBuffer();
+				m_sequence->m_volume.read(frame, step, len, envelope);
+
+				for(int i = 0; i < len; i++)
+					for(int channel = 0; channel < specs.channels; channel++)
+						buf[i * specs.channels + channel] *= envelope[i];
+			}
+			else
+			{
+				float volume;
+				m_sequence->m_volume.read(frame, &volume);
+
+				if(volume != 1.0f)
+					for(int i = 0; i < len * specs.channels; i++)
+						buf[i] *= volume;
+			}
+		}
 
 		pos += len;
-		time += float(len) / float(specs.rate);
 	}
 
 	m_position += length;
@@ -195,4 +450,9 @@ void SequenceReader::read(int& length, bool& eos, sample_t* buffer)
 	eos = false;
 }
 
+bool SequenceReader::isSilent() const
+{
+	return m_silent;
+}
+
 AUD_NAMESPACE_END
@@ -0,0 +1,197 @@
+/*******************************************************************************
+ * Copyright 2009-2016 Jörg Müller
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ ******************************************************************************/
+
+#include "SharedSource.h"
+#include "ISound.h"
+
+#include <algorithm>
+#include <cstring>
+
+AUD_NAMESPACE_BEGIN
+
+SharedSource::SharedSource(std::shared_ptr<ISound> sound, std::shared_ptr<IReader> reader) :
+	m_sound(sound), m_reader(reader), m_block_start(0), m_block_length(0), m_block_eos(false)
+{
+	if(!m_reader)
+		m_reader = sound->createReader();
+
+	m_position = m_reader->getPosition();
+}
+
+bool SharedSource::isNeeded(const SharedSourceReader* reader) const
+{
+	for(const SharedSourceReader* other : m_readers)
+	{
+		if(other == reader)
+			continue;
+
+		int position = other->m_position;
+
+		if(position == m_position || (position >= m_block_start && position < m_block_start + m_block_length))
+			return true;
+	}
+
+	return false;
+}
+
+bool SharedSource::read(const SharedSourceReader* reader, int position, int& length, bool& eos, sample_t* buffer)
+{
+	int sample_size = AUD_SAMPLE_SIZE(reader->m_specs);
+
+	// another reader already read this block
+	if(position >= m_block_start && position + length <= m_block_start + m_block_length)
+	{
+		std::memcpy(buffer, m_block.getBuffer() + (position - m_block_start) * reader->m_specs.channels, length * sample_size);
+		eos = m_block_eos && position + length == m_block_start + m_block_length;
+		return true;
+	}
+
+	bool needed = isNeeded(reader);
+
+	if(position != m_position)
+	{
+		// the reader is out of step with the others
+		if(needed)
+			return false;
+
+		m_reader->seek(position);
+		m_position = position;
+	}
+
+	m_reader->read(length, eos, buffer);
+	m_position += length;
+
+	// the block only has to be kept if other readers might need it
+	if(m_readers.size() > 1)
+	{
+		m_block.assureSize(length * sample_size);
+		std::memcpy(m_block.getBuffer(), buffer, length * sample_size);
+		m_block_start = position;
+		m_block_length = length;
+		m_block_eos = eos;
+	}
+	else
+		m_block_length = 0;
+
+	return true;
+}
+
+std::shared_ptr<IReader> SharedSource::createReader(SharedSourceMap& sources, std::shared_ptr<ISound> sound, std::shared_ptr<IReader> reader)
+{
+	std::shared_ptr<SharedSource> source;
+
+	auto it = sources.find(sound.get());
+
+	if(it != sources.end())
+		source = it->second.lock();
+
+	if(source)
+	{
+		// sharing only pays off when starting in step, otherwise the prefetched reader is ready to go
+		if(reader && reader->getPosition() != source->m_position)
+			return std::make_shared<SharedSourceReader>(reader);
+
+		return std::make_shared<SharedSourceReader>(source, reader);
+	}
+
+	// forget sources nobody reads anymore
+	for(auto it = sources.begin(); it != sources.end();)
+	{
+		if(it->second.expired())
+			it = sources.erase(it);
+		else
+			++it;
+	}
+
+	source = std::make_shared<SharedSource>(sound, reader);
+	sources[sound.get()] = source;
+
+	return std::make_shared<SharedSourceReader>(source, nullptr);
+}
+
+SharedSourceReader::SharedSourceReader(std::shared_ptr<SharedSource> source, std::shared_ptr<IReader> spare) :
+	m_source(source), m_spare(spare), m_specs(source->m_reader->getSpecs()), m_position(source->m_position)
+{
+	source->m_readers.push_back(this);
+}
+
+SharedSourceReader::SharedSourceReader(std::shared_ptr<IReader> reader) :
+	m_reader(reader), m_specs(reader->getSpecs()), m_position(reader->getPosition())
+{
+}
+
+SharedSourceReader::~SharedSourceReader()
+{
+	if(m_source)
+	{
+		std::vector<SharedSourceReader*>& readers = m_source->m_readers;
+		readers.erase(std::find(readers.begin(), readers.end(), this));
+	}
+}
+
+bool SharedSourceReader::isSeekable() const
+{
+	return m_reader ? m_reader->isSeekable() : m_source->m_reader->isSeekable();
+}
+
+void SharedSourceReader::seek(int position)
+{
+	if(m_reader)
+		m_reader->seek(position);
+
+	m_position = position;
+}
+
+int SharedSourceReader::getLength() const
+{
+	return m_reader ? m_reader->getLength() : m_source->m_reader->getLength();
+}
+
+int SharedSourceReader::getPosition() const
+{
+	return m_position;
+}
+
+Specs SharedSourceReader::getSpecs() const
+{
+	return m_specs;
+}
+
+void SharedSourceReader::read(int& length, bool& eos, sample_t* buffer)
+{
+	if(m_source)
+	{
+		if(m_source->read(this, m_position, length, eos, buffer))
+		{
+			m_position += length;
+			return;
+		}
+
+		// continue with a reader of its own, so that the others aren't disturbed
+		m_reader = m_spare ? m_spare : m_source->m_sound->createReader();
+		m_reader->seek(m_position);
+		m_spare = nullptr;
+
+		std::vector<SharedSourceReader*>& readers = m_source->m_readers;
+		readers.erase(std::find(readers.begin(), readers.end(), this));
+		m_source = nullptr;
+	}
+
+	m_reader->read(length, eos, buffer);
+	m_position += length;
+}
+
+AUD_NAMESPACE_END
@@ -0,0 +1,169 @@
+/*******************************************************************************
+ * Copyright 2009-2016 Jörg Müller
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ ******************************************************************************/
+
+#pragma once
+
+#include "IReader.h"
+#include "util/Buffer.h"
+
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+AUD_NAMESPACE_BEGIN
+
+class ISound;
+class SharedSource;
+class SharedSourceReader;
+
+/// The shared sources of a sequence reader by their sound.
+typedef std::unordered_map<const ISound*, std::weak_ptr<SharedSource> > SharedSourceMap;
+
+/**
+ * This class reads a sound once for all handles of a sequence reader that play
+ * it at the same position, for example layered entries of the same sound.
+ *
+ * The last read block is kept, so that the other readers at the same position
+ * just copy it. Readers that fall out of step switch to a reader of their own.
+ */
+class SharedSource
+{
+	friend class SharedSourceReader;
+private:
+	/// The sound that is read.
+	std::shared_ptr<ISound> m_sound;
+
+	/// The reader of the sound.
+	std::shared_ptr<IReader> m_reader;
+
+	/// The position of the reader.
+	int m_position;
+
+	/// The last read block.
+	Buffer m_block;
+
+	/// The position of the last read block.
+	int m_block_start;
+
+	/// The length of the last read block, 0 if it hasn't been kept.
+	int m_block_length;
+
+	/// Whether the last read block ends at the end of the sound.
+	bool m_block_eos;
+
+	/// The readers currently reading from the source.
+	std::vector<SharedSourceReader*> m_readers;
+
+	// delete copy constructor and operator=
+	SharedSource(const SharedSource&) = delete;
+	SharedSource& operator=(const SharedSource&) = delete;
+
+	/**
+	 * Returns whether another reader still needs the current state of the source.
+	 * \param reader The reader asking.
+	 * \return Whether seeking would disturb another reader.
+	 */
+	bool isNeeded(const SharedSourceReader* reader) const;
+
+	/**
+	 * Reads for one of the readers.
+	 * \param reader The reader that reads.
+	 * \param position The position to read from.
+	 * \param[in,out] length The length to read, the length read afterwards.
+	 * \param[out] eos Whether the end of the sound has been reached.
+	 * \param buffer The buffer to read to.
+	 * \return false if the reader has to continue on its own.
+	 */
+	bool read(const SharedSourceReader* reader, int position, int& length, bool& eos, sample_t* buffer);
+
+public:
+	/**
+	 * Creates a new shared source.
+	 * \param sound The sound to read.
+	 * \param reader A reader of the sound to use, for example a prefetched
+	 *        one, may be nullptr.
+	 */
+	SharedSource(std::shared_ptr<ISound> sound, std::shared_ptr<IReader> reader);
+
+	/**
+	 * Creates a reader of a sound that shares its source with other readers of
+	 * the same sound.
+	 * \param sources The shared sources to look up and add to.
+	 * \param sound The sound to read.
+	 * \param reader A reader of the sound to use, for example a prefetched
+	 *        one, may be nullptr. It becomes the reader of a new source, or
+	 *        the reader's own one if the existing source is at a different
+	 *        position.
+	 * \return The reader.
+	 */
+	static std::shared_ptr<IReader> createReader(SharedSourceMap& sources, std::shared_ptr<ISound> sound, std::shared_ptr<IReader> reader);
+};
+
+/**
+ * A reader of a shared source.
+ */
+class SharedSourceReader : public IReader
+{
+	friend class SharedSource;
+private:
+	/// The source while the reader shares it.
+	std::shared_ptr<SharedSource> m_source;
+
+	/// The reader of its own after it stopped sharing.
+	std::shared_ptr<IReader> m_reader;
+
+	/// A reader of the sound to continue with once the reader stops sharing, may be nullptr.
+	std::shared_ptr<IReader> m_spare;
+
+	/// The specification of the sound.
+	Specs m_specs;
+
+	/// The current position.
+	int m_position;
+
+	// delete copy constructor and operator=
+	SharedSourceReader(const SharedSourceReader&) = delete;
+	SharedSourceReader& operator=(const SharedSourceReader&) = delete;
+
+public:
+	/**
+	 * Creates a new reader of a shared source.
+	 * \param source The source to read from.
+	 * \param spare A reader of the sound to continue with once the reader
+	 *        stops sharing, may be nullptr.
+	 */
+	SharedSourceReader(std::shared_ptr<SharedSource> source, std::shared_ptr<IReader> spare);
+
+	/**
+	 * Creates a new reader that doesn't share a source.
+	 * \param reader The reader of its own.
+	 */
+	SharedSourceReader(std::shared_ptr<IReader> reader);
+
+	/**
+	 * Stops sharing the source.
+	 */
+	virtual ~SharedSourceReader();
+
+	virtual bool isSeekable() const;
+	virtual void seek(int position);
+	virtual int getLength() const;
+	virtual int getPosition() const;
+	virtual Specs getSpecs() const;
+	virtual void read(int& length, bool& eos, sample_t* buffer);
+};
+
+AUD_NAMESPACE_END
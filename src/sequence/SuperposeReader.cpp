@@ -23,7 +23,7 @@
 AUD_NAMESPACE_BEGIN
 
 SuperposeReader::SuperposeReader(std::shared_ptr<IReader> reader1, std::shared_ptr<IReader> reader2) :
-	m_reader1(reader1), m_reader2(reader2)
+	m_reader1(reader1), m_reader2(reader2), m_silent(false)
 {
 }
 
@@ -85,11 +85,21 @@ void SuperposeReader::read(int& length, bool& eos, sample_t* buffer)
 	sample_t* buf = m_buffer.getBuffer();
 	m_reader2->read(len2, eos2, buf);
 
-	for(int i = 0; i < len2 * specs.channels; i++)
-		buffer[i] += buf[i];
+	if(!m_reader2->isSilent())
+	{
+		for(int i = 0; i < len2 * specs.channels; i++)
+			buffer[i] += buf[i];
+	}
+
+	m_silent = m_reader1->isSilent() && m_reader2->isSilent();
 
 	length = std::max(len1, len2);
 	eos &= eos2;
 }
 
+bool SuperposeReader::isSilent() const
+{
+	return m_silent;
+}
+
 AUD_NAMESPACE_END
@@ -0,0 +1,275 @@
+/*******************************************************************************
+ * Copyright 2009-2016 Jörg Müller
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ ******************************************************************************/
+
+
+#include "util/AsyncLoader.h"
+#include "util/LoadProgress.h"
+#include "util/SoundCache.h"
+#include "util/StreamBuffer.h"
+#include "util/ThreadPool.h"
+#include "file/File.h"
+#include "IReader.h"
+#include "Exception.h"
+
+#include <algorithm>
+#include <queue>
+#include <thread>
+#include <vector>
+
+#define DEFAULT_THREAD_COUNT 2
+
+AUD_NAMESPACE_BEGIN
+
+/// A queued load.
+struct AsyncLoaderTask
+{
+	/// The request to fulfill.
+	std::shared_ptr<LoadRequest> request;
+
+	/// Runs the load, created by the AsyncLoader as it may access the request.
+	std::function<void()> run;
+
+	/// The order of submission, to load requests of the same priority FIFO.
+	unsigned int order;
+
+	bool operator<(const AsyncLoaderTask& other) const
+	{
+		if(request->getPriority() != other.request->getPriority())
+			return request->getPriority() < other.request->getPriority();
+
+		return order > other.order;
+	}
+};
+
+/// The global state of the AsyncLoader.
+struct AsyncLoaderState
+{
+	/// The queued loads, highest priority first.
+	std::priority_queue<AsyncLoaderTask> queue;
+
+	/// The loader threads.
+	std::vector<std::thread> threads;
+
+	/// The number of loader threads to run.
+	int thread_count;
+
+	/// The number of loads submitted so far.
+	unsigned int order;
+
+	/// Tells the loader threads to exit.
+	bool stop;
+
+	/// The decode thread pool.
+	std::shared_ptr<ThreadPool> pool;
+
+	/// Mutex for the state.
+	std::mutex mutex;
+
+	/// Signals new loads and stop requests.
+	std::condition_variable condition;
+
+	AsyncLoaderState() :
+		thread_count(DEFAULT_THREAD_COUNT), order(0), stop(false)
+	{
+		// loads may still use the sound cache while this is destroyed, so it
+		// has to be created first to be destroyed last
+		SoundCache::getBudget();
+	}
+
+	~AsyncLoaderState()
+	{
+		stopThreads(false);
+
+		while(!queue.empty())
+		{
+			queue.top().request->cancel();
+			queue.pop();
+		}
+	}
+
+	/// Starts missing loader threads, the mutex has to be locked.
+	void startThreads();
+
+	/// Stops the loader threads after their current load and restarts them if requested.
+	void stopThreads(bool restart)
+	{
+		std::vector<std::thread> stopped;
+
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			stop = true;
+			stopped.swap(threads);
+		}
+
+		condition.notify_all();
+
+		for(auto& thread : stopped)
+			thread.join();
+
+		std::lock_guard<std::mutex> lock(mutex);
+		stop = false;
+
+		if(restart && !queue.empty())
+			startThreads();
+	}
+};
+
+static AsyncLoaderState& asyncLoaderState()
+{
+	static AsyncLoaderState state;
+	return state;
+}
+
+static void async_loader_thread()
+{
+	AsyncLoaderState& state = asyncLoaderState();
+
+	for(;;)
+	{
+		AsyncLoaderTask task;
+
+		{
+			std::unique_lock<std::mutex> lock(state.mutex);
+
+			state.condition.wait(lock, [&]{ return state.stop || !state.queue.empty(); });
+
+			if(state.stop)
+				return;
+
+			task = state.queue.top();
+			state.queue.pop();
+		}
+
+		task.run();
+	}
+}
+
+void AsyncLoaderState::startThreads()
+{
+	if(stop)
+		return;
+
+	while(int(threads.size()) < thread_count)
+		threads.emplace_back(async_loader_thread);
+}
+
+void AsyncLoader::load(std::shared_ptr<LoadRequest> request, const task_t& task)
+{
+	// cancelled while queued
+	if(!request->start())
+		return;
+
+	std::shared_ptr<LoadProgress> progress = request->getProgress();
+
+	try
+	{
+		std::shared_ptr<ISound> sound = task(progress);
+
+		if(progress->isCancelled())
+			request->finish(LOAD_STATUS_CANCELLED, nullptr, "");
+		else
+			request->finish(LOAD_STATUS_DONE, sound, "");
+	}
+	catch(Exception& e)
+	{
+		if(progress->isCancelled())
+			request->finish(LOAD_STATUS_CANCELLED, nullptr, "");
+		else
+			request->finish(LOAD_STATUS_FAILED, nullptr, e.what());
+	}
+	catch(std::exception& e)
+	{
+		request->finish(LOAD_STATUS_FAILED, nullptr, e.what());
+	}
+}
+
+std::shared_ptr<LoadRequest> AsyncLoader::loadAsync(std::string filename, LoadPriority priority, LoadRequest::callback_t callback)
+{
+	return submit([filename](std::shared_ptr<LoadProgress>) -> std::shared_ptr<ISound> {
+		std::shared_ptr<ISound> sound = std::make_shared<File>(filename);
+		sound->createReader();
+		return sound;
+	}, priority, callback);
+}
+
+std::shared_ptr<LoadRequest> AsyncLoader::cacheAsync(std::shared_ptr<ISound> sound, LoadPriority priority, StorageFormat format, LoadRequest::callback_t callback, bool parallel)
+{
+	return submit([sound, format, parallel](std::shared_ptr<LoadProgress> progress) -> std::shared_ptr<ISound> {
+		return std::make_shared<StreamBuffer>(sound, parallel ? getDecodePool() : nullptr, format, progress);
+	}, priority, callback);
+}
+
+std::shared_ptr<LoadRequest> AsyncLoader::submit(task_t task, LoadPriority priority, LoadRequest::callback_t callback)
+{
+	AsyncLoaderState& state = asyncLoaderState();
+
+	std::shared_ptr<LoadRequest> request = std::make_shared<LoadRequest>(priority, callback);
+
+	{
+		std::lock_guard<std::mutex> lock(state.mutex);
+
+		AsyncLoaderTask entry;
+		entry.request = request;
+		entry.run = [request, task]() { load(request, task); };
+		entry.order = state.order++;
+		state.queue.push(entry);
+
+		state.startThreads();
+	}
+
+	state.condition.notify_one();
+
+	return request;
+}
+
+void AsyncLoader::setThreadCount(int count)
+{
+	AsyncLoaderState& state = asyncLoaderState();
+
+	if(count < 1)
+		AUD_THROW(StateException, "The number of loader threads must be at least 1.");
+
+	{
+		std::lock_guard<std::mutex> lock(state.mutex);
+		state.thread_count = count;
+	}
+
+	// running loads finish, queued ones are picked up by the new threads
+	state.stopThreads(true);
+}
+
+int AsyncLoader::getThreadCount()
+{
+	AsyncLoaderState& state = asyncLoaderState();
+
+	std::lock_guard<std::mutex> lock(state.mutex);
+
+	return state.thread_count;
+}
+
+std::shared_ptr<ThreadPool> AsyncLoader::getDecodePool()
+{
+	AsyncLoaderState& state = asyncLoaderState();
+
+	std::lock_guard<std::mutex> lock(state.mutex);
+
+	if(!state.pool)
+		state.pool = std::make_shared<ThreadPool>(std::max(std::thread::hardware_concurrency(), 1u));
+
+	return state.pool;
+}
+
+AUD_NAMESPACE_END
@@ -0,0 +1,540 @@
+/*******************************************************************************
+ * Copyright 2009-2016 Jörg Müller
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ ******************************************************************************/
+
+#include "util/BlockBuffer.h"
+#include "util/Buffer.h"
+#include "Exception.h"
+
+#include <algorithm>
+#include <climits>
+#include <cmath>
+#include <cstring>
+#include <stdint.h>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define AUD_BLOCK_SSE2
+#include <emmintrin.h>
+#endif
+
+#define S16_SCALE 32767.0f
+#define S24_SCALE 8388607.0f
+
+/// Unary rice quotients of this size are followed by the raw value instead.
+#define RICE_ESCAPE 32
+
+AUD_NAMESPACE_BEGIN
+
+static inline int32_t quantize(float sample, float scale)
+{
+	float value = std::lrint(sample * scale);
+
+	return int32_t(std::max(-scale - 1.0f, std::min(scale, value)));
+}
+
+static void encode_s16(const sample_t* source, data_t* target, int count)
+{
+	int16_t* t = reinterpret_cast<int16_t*>(target);
+
+	for(int i = 0; i < count; i++)
+		t[i] = int16_t(quantize(source[i], S16_SCALE));
+}
+
+static void decode_s16(const data_t* source, sample_t* target, int count)
+{
+	const int16_t* s = reinterpret_cast<const int16_t*>(source);
+	const float scale = 1.0f / S16_SCALE;
+	int i = 0;
+
+#ifdef AUD_BLOCK_SSE2
+	const __m128 factor = _mm_set1_ps(scale);
+
+	for(; i + 8 <= count; i += 8)
+	{
+		__m128i samples = _mm_loadu_si128(reinterpret_cast<const __m128i*>(s + i));
+		__m128i low = _mm_srai_epi32(_mm_unpacklo_epi16(samples, samples), 16);
+		__m128i high = _mm_srai_epi32(_mm_unpackhi_epi16(samples, samples), 16);
+		_mm_storeu_ps(target + i, _mm_mul_ps(_mm_cvtepi32_ps(low), factor));
+		_mm_storeu_ps(target + i + 4, _mm_mul_ps(_mm_cvtepi32_ps(high), factor));
+	}
+#endif
+
+	for(; i < count; i++)
+		target[i] = s[i] * scale;
+}
+
+static void encode_s24(const sample_t* source, data_t* target, int count)
+{
+	for(int i = 0; i < count; i++)
+	{
+		int32_t value = quantize(source[i], S24_SCALE);
+		target[i * 3] = value & 0xFF;
+		target[i * 3 + 1] = (value >> 8) & 0xFF;
+		target[i * 3 + 2] = (value >> 16) & 0xFF;
+	}
+}
+
+static void decode_s24(const data_t* source, sample_t* target, int count)
+{
+	const float scale = 1.0f / S24_SCALE;
+
+	for(int i = 0; i < count; i++)
+	{
+		// shift up and back down to sign extend
+		int32_t value = int32_t(uint32_t(source[i * 3]) << 8 | uint32_t(source[i * 3 + 1]) << 16 | uint32_t(source[i * 3 + 2]) << 24) >> 8;
+		target[i] = value * scale;
+	}
+}
+
+/// Writes a bit stream MSB first.
+class BitWriter
+{
+private:
+	std::vector<data_t>& m_data;
+	uint64_t m_bits;
+	int m_count;
+
+public:
+	BitWriter(std::vector<data_t>& data) : m_data(data), m_bits(0), m_count(0) {}
+
+	inline void write(uint32_t value, int bits)
+	{
+		m_bits = (m_bits << bits) | (value & ((uint64_t(1) << bits) - 1));
+		m_count += bits;
+
+		while(m_count >= 8)
+		{
+			m_count -= 8;
+			m_data.push_back(data_t(m_bits >> m_count));
+		}
+
+		m_bits &= (uint64_t(1) << m_count) - 1;
+	}
+
+	inline void flush()
+	{
+		if(m_count)
+			m_data.push_back(data_t(m_bits << (8 - m_count)));
+
+		m_bits = 0;
+		m_count = 0;
+	}
+};
+
+/// Reads a bit stream MSB first.
+class BitReader
+{
+private:
+	const data_t* m_data;
+	size_t m_size;
+	size_t m_position;
+	uint64_t m_bits;
+	int m_count;
+
+public:
+	BitReader(const data_t* data, size_t size) : m_data(data), m_size(size), m_position(0), m_bits(0), m_count(0) {}
+
+	inline uint32_t read(int bits)
+	{
+		while(m_count < bits)
+		{
+			m_bits = (m_bits << 8) | (m_position < m_size ? m_data[m_position++] : 0);
+			m_count += 8;
+		}
+
+		m_count -= bits;
+
+		return uint32_t((m_bits >> m_count) & ((uint64_t(1) << bits) - 1));
+	}
+
+	inline int readUnary(int max)
+	{
+		int count = 0;
+
+		while(count < max && read(1))
+			count++;
+
+		return count;
+	}
+};
+
+/*
+ * The lossless format stores each channel of a block after the other: the
+ * rice parameter in 5 bits followed by the rice coded residuals of a second
+ * order fixed predictor. Each block starts its prediction from scratch so
+ * that it can be decoded on its own.
+ */
+
+static void encode_lossless(const sample_t* source, int length, int channels, float scale, std::vector<data_t>& data)
+{
+	BitWriter writer(data);
+	std::vector<uint32_t> residuals(length);
+
+	for(int channel = 0; channel < channels; channel++)
+	{
+		int32_t previous1 = 0;
+		int32_t previous2 = 0;
+		uint64_t sum = 0;
+
+		for(int i = 0; i < length; i++)
+		{
+			int32_t value = quantize(source[i * channels + channel], scale);
+			int32_t prediction = i == 0 ? 0 : (i == 1 ? previous1 : 2 * previous1 - previous2);
+			int32_t residual = value - prediction;
+
+			residuals[i] = (uint32_t(residual) << 1) ^ uint32_t(residual >> 31);
+			sum += residuals[i];
+
+			previous2 = previous1;
+			previous1 = value;
+		}
+
+		int k = 0;
+		while(k < 30 && (uint64_t(length) << k) < sum)
+			k++;
+
+		writer.write(k, 5);
+
+		for(int i = 0; i < length; i++)
+		{
+			uint32_t quotient = residuals[i] >> k;
+
+			if(quotient < RICE_ESCAPE)
+			{
+				writer.write(((uint32_t(1) << quotient) - 1) << 1, quotient + 1);
+				writer.write(residuals[i], k);
+			}
+			else
+			{
+				writer.write(0xFFFFFFFF, RICE_ESCAPE);
+				writer.write(residuals[i], 32);
+			}
+		}
+	}
+
+	writer.flush();
+}
+
+static void decode_lossless(const data_t* source, size_t size, int length, int channels, float scale, sample_t* target)
+{
+	BitReader reader(source, size);
+	const float factor = 1.0f / scale;
+
+	for(int channel = 0; channel < channels; channel++)
+	{
+		int k = reader.read(5);
+		int32_t previous1 = 0;
+		int32_t previous2 = 0;
+
+		for(int i = 0; i < length; i++)
+		{
+			uint32_t quotient = reader.readUnary(RICE_ESCAPE);
+			uint32_t residual;
+
+			if(quotient < RICE_ESCAPE)
+				residual = (quotient << k) | reader.read(k);
+			else
+				residual = reader.read(32);
+
+			int32_t prediction = i == 0 ? 0 : (i == 1 ? previous1 : 2 * previous1 - previous2);
+			int32_t value = prediction + (int32_t(residual >> 1) ^ -int32_t(residual & 1));
+
+			target[i * channels + channel] = value * factor;
+
+			previous2 = previous1;
+			previous1 = value;
+		}
+	}
+}
+
+BlockBuffer::Block BlockBuffer::encode(const sample_t* samples, int length) const
+{
+	Block block;
+	int count = length * m_specs.channels;
+
+	block.offset = 0;
+	block.length = length;
+
+	switch(m_format)
+	{
+	case STORAGE_S16:
+		block.size = count * 2;
+		block.buffer = std::make_shared<Buffer>(block.size);
+		encode_s16(samples, reinterpret_cast<data_t*>(block.buffer->getBuffer()), count);
+		break;
+	case STORAGE_S24:
+		block.size = count * 3;
+		block.buffer = std::make_shared<Buffer>(block.size);
+		encode_s24(samples, reinterpret_cast<data_t*>(block.buffer->getBuffer()), count);
+		break;
+	case STORAGE_LOSSLESS_S16:
+	case STORAGE_LOSSLESS_S24:
+	{
+		std::vector<data_t> data;
+		data.reserve(count * 2);
+		encode_lossless(samples, length, m_specs.channels, m_format == STORAGE_LOSSLESS_S16 ? S16_SCALE : S24_SCALE, data);
+		block.size = data.size();
+		block.buffer = std::make_shared<Buffer>(block.size);
+		std::memcpy(block.buffer->getBuffer(), data.data(), block.size);
+		break;
+	}
+	default:
+		block.size = count * sizeof(sample_t);
+		block.buffer = std::make_shared<Buffer>(block.size);
+		std::memcpy(block.buffer->getBuffer(), samples, block.size);
+		break;
+	}
+
+	return block;
+}
+
+size_t BlockBuffer::getDataSize() const
+{
+	// blocks of a buffer the block buffer was created from precede the own ones
+	if(m_blocks.empty() || m_blocks.back().buffer != m_data)
+		return 0;
+
+	return m_blocks.back().offset + m_blocks.back().size;
+}
+
+void BlockBuffer::addBlock(const sample_t* samples, int length)
+{
+	Block block;
+
+	if(m_format == STORAGE_FLOAT32)
+	{
+		block.size = size_t(length) * AUD_SAMPLE_SIZE(m_specs);
+		block.length = length;
+
+		if(!m_data)
+			m_data = std::make_shared<Buffer>(0);
+
+		block.buffer = m_data;
+		block.offset = getDataSize();
+
+		// grow geometrically, the blocks stay valid as they refer to the buffer object
+		if(block.offset + block.size > size_t(m_data->getSize()))
+			m_data->resize(int(std::min<size_t>(std::max(block.offset + block.size, size_t(m_data->getSize()) * 2), INT_MAX)), true);
+
+		std::memcpy(reinterpret_cast<data_t*>(m_data->getBuffer()) + block.offset, samples, block.size);
+	}
+	else
+		block = encode(samples, length);
+
+	m_blocks.push_back(block);
+	m_size += block.size;
+	m_length += length;
+}
+
+BlockBuffer::BlockBuffer(Specs specs, StorageFormat format) :
+	m_specs(specs), m_format(format), m_length(0), m_size(0), m_pending_length(0)
+{
+}
+
+BlockBuffer::BlockBuffer(std::shared_ptr<Buffer> buffer, Specs specs) :
+	m_specs(specs), m_format(STORAGE_FLOAT32), m_length(buffer->getSize() / AUD_SAMPLE_SIZE(specs)), m_size(buffer->getSize()), m_pending_length(0)
+{
+	int sample_size = AUD_SAMPLE_SIZE(specs);
+
+	for(int position = 0; position < m_length; position += BLOCK_LENGTH)
+	{
+		Block block;
+		block.buffer = buffer;
+		block.offset = size_t(position) * sample_size;
+		block.length = std::min(BLOCK_LENGTH, m_length - position);
+		block.size = size_t(block.length) * sample_size;
+		m_blocks.push_back(block);
+	}
+}
+
+void BlockBuffer::append(const sample_t* buffer, int length)
+{
+	int channels = m_specs.channels;
+
+	while(length > 0)
+	{
+		// whole blocks are encoded directly from the source
+		if(!m_pending_length && length >= BLOCK_LENGTH)
+		{
+			addBlock(buffer, BLOCK_LENGTH);
+			buffer += BLOCK_LENGTH * channels;
+			length -= BLOCK_LENGTH;
+			continue;
+		}
+
+		if(!m_pending)
+			m_pending = std::make_shared<Buffer>(BLOCK_LENGTH * AUD_SAMPLE_SIZE(m_specs));
+
+		int count = std::min(length, BLOCK_LENGTH - m_pending_length);
+		std::memcpy(m_pending->getBuffer() + m_pending_length * channels, buffer, count * AUD_SAMPLE_SIZE(m_specs));
+		m_pending_length += count;
+		buffer += count * channels;
+		length -= count;
+
+		if(m_pending_length == BLOCK_LENGTH)
+		{
+			addBlock(m_pending->getBuffer(), BLOCK_LENGTH);
+			m_pending_length = 0;
+		}
+	}
+}
+
+void BlockBuffer::append(const BlockBuffer& buffer)
+{
+	if(m_pending_length || m_length != int(m_blocks.size()) * BLOCK_LENGTH)
+		AUD_THROW(StateException, "Blocks can only be appended to a buffer of full blocks.");
+
+	if(buffer.m_format != m_format || buffer.m_specs.channels != m_specs.channels || buffer.m_specs.rate != m_specs.rate)
+		AUD_THROW(StateException, "The buffers to join have different formats.");
+
+	if(m_format == STORAGE_FLOAT32)
+	{
+		for(const Block& block : buffer.m_blocks)
+			addBlock(reinterpret_cast<const sample_t*>(reinterpret_cast<const data_t*>(block.buffer->getBuffer()) + block.offset), block.length);
+
+		return;
+	}
+
+	m_blocks.insert(m_blocks.end(), buffer.m_blocks.begin(), buffer.m_blocks.end());
+	m_size += buffer.m_size;
+	m_length += buffer.m_length;
+}
+
+void BlockBuffer::finish()
+{
+	if(m_pending_length)
+	{
+		addBlock(m_pending->getBuffer(), m_pending_length);
+		m_pending_length = 0;
+	}
+
+	if(m_data && size_t(m_data->getSize()) > getDataSize())
+		m_data->resize(int(getDataSize()), true);
+}
+
+Specs BlockBuffer::getSpecs() const
+{
+	return m_specs;
+}
+
+StorageFormat BlockBuffer::getFormat() const
+{
+	return m_format;
+}
+
+int BlockBuffer::getLength() const
+{
+	return m_length;
+}
+
+size_t BlockBuffer::getSize() const
+{
+	return m_size;
+}
+
+bool BlockBuffer::isRandomAccess() const
+{
+	return m_format != STORAGE_LOSSLESS_S16 && m_format != STORAGE_LOSSLESS_S24;
+}
+
+int BlockBuffer::decodeBlock(int index, sample_t* buffer) const
+{
+	const Block& block = m_blocks[index];
+	const data_t* data = reinterpret_cast<const data_t*>(block.buffer->getBuffer()) + block.offset;
+	int count = block.length * m_specs.channels;
+
+	switch(m_format)
+	{
+	case STORAGE_S16:
+		decode_s16(data, buffer, count);
+		break;
+	case STORAGE_S24:
+		decode_s24(data, buffer, count);
+		break;
+	case STORAGE_LOSSLESS_S16:
+		decode_lossless(data, block.size, block.length, m_specs.channels, S16_SCALE, buffer);
+		break;
+	case STORAGE_LOSSLESS_S24:
+		decode_lossless(data, block.size, block.length, m_specs.channels, S24_SCALE, buffer);
+		break;
+	default:
+		std::memcpy(buffer, data, block.size);
+		break;
+	}
+
+	return block.length;
+}
+
+void BlockBuffer::read(int position, int length, sample_t* buffer) const
+{
+	int channels = m_specs.channels;
+	std::shared_ptr<Buffer> temp;
+
+	while(length > 0)
+	{
+		int index = position / BLOCK_LENGTH;
+		int offset = position % BLOCK_LENGTH;
+		int count = std::min(length, m_blocks[index].length - offset);
+
+		if(isRandomAccess())
+		{
+			const Block& block = m_blocks[index];
+			const data_t* data = reinterpret_cast<const data_t*>(block.buffer->getBuffer()) + block.offset;
+			int start = offset * channels;
+
+			switch(m_format)
+			{
+			case STORAGE_S16:
+				decode_s16(data + start * 2, buffer, count * channels);
+				break;
+			case STORAGE_S24:
+				decode_s24(data + start * 3, buffer, count * channels);
+				break;
+			default:
+				std::memcpy(buffer, data + start * sizeof(sample_t), count * AUD_SAMPLE_SIZE(m_specs));
+				break;
+			}
+		}
+		else if(!offset && count == m_blocks[index].length)
+			decodeBlock(index, buffer);
+		else
+		{
+			if(!temp)
+				temp = std::make_shared<Buffer>(BLOCK_LENGTH * AUD_SAMPLE_SIZE(m_specs));
+
+			decodeBlock(index, temp->getBuffer());
+			std::memcpy(buffer, temp->getBuffer() + offset * channels, count * AUD_SAMPLE_SIZE(m_specs));
+		}
+
+		position += count;
+		length -= count;
+		buffer += count * channels;
+	}
+}
+
+std::shared_ptr<Buffer> BlockBuffer::toBuffer() const
+{
+	// a float buffer that is stored in one piece can be returned directly
+	if(m_format == STORAGE_FLOAT32 && !m_blocks.empty() && m_blocks.front().buffer == m_blocks.back().buffer &&
+	   m_blocks.front().offset == 0 && size_t(m_blocks.front().buffer->getSize()) == m_size)
+		return m_blocks.front().buffer;
+
+	std::shared_ptr<Buffer> buffer = std::make_shared<Buffer>(m_length * AUD_SAMPLE_SIZE(m_specs));
+	read(0, m_length, buffer->getBuffer());
+
+	return buffer;
+}
+
+AUD_NAMESPACE_END
@@ -0,0 +1,108 @@
+/*******************************************************************************
+ * Copyright 2009-2016 Jörg Müller
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ ******************************************************************************/
+
+#include "util/BlockBufferReader.h"
+#include "util/BlockBuffer.h"
+
+#include <algorithm>
+#include <cstring>
+
+AUD_NAMESPACE_BEGIN
+
+BlockBufferReader::BlockBufferReader(std::shared_ptr<BlockBuffer> buffer) :
+	m_position(0), m_buffer(buffer), m_block_index(-1)
+{
+}
+
+bool BlockBufferReader::isSeekable() const
+{
+	return true;
+}
+
+bool BlockBufferReader::isSeekAccurate() const
+{
+	return true;
+}
+
+void BlockBufferReader::seek(int position)
+{
+	m_position = position;
+}
+
+int BlockBufferReader::getLength() const
+{
+	return m_buffer->getLength();
+}
+
+int BlockBufferReader::getPosition() const
+{
+	return m_position;
+}
+
+Specs BlockBufferReader::getSpecs() const
+{
+	return m_buffer->getSpecs();
+}
+
+void BlockBufferReader::read(int& length, bool& eos, sample_t* buffer)
+{
+	eos = false;
+
+	// in case the end of the buffer is reached
+	if(m_position + length > m_buffer->getLength())
+	{
+		length = m_buffer->getLength() - m_position;
+		eos = true;
+	}
+
+	if(length < 0 || m_position < 0)
+	{
+		length = 0;
+		return;
+	}
+
+	if(m_buffer->isRandomAccess())
+	{
+		m_buffer->read(m_position, length, buffer);
+		m_position += length;
+		return;
+	}
+
+	Specs specs = m_buffer->getSpecs();
+	int sample_size = AUD_SAMPLE_SIZE(specs);
+
+	for(int left = length; left > 0;)
+	{
+		int index = m_position / BlockBuffer::BLOCK_LENGTH;
+		int offset = m_position % BlockBuffer::BLOCK_LENGTH;
+
+		if(index != m_block_index)
+		{
+			m_block.assureSize(BlockBuffer::BLOCK_LENGTH * sample_size);
+			m_buffer->decodeBlock(index, m_block.getBuffer());
+			m_block_index = index;
+		}
+
+		int count = std::min(left, BlockBuffer::BLOCK_LENGTH - offset);
+		std::memcpy(buffer, m_block.getBuffer() + offset * specs.channels, count * sample_size);
+
+		buffer += count * specs.channels;
+		m_position += count;
+		left -= count;
+	}
+}
+
+AUD_NAMESPACE_END
@@ -32,6 +32,11 @@ bool BufferReader::isSeekable() const
 	return true;
 }
 
+bool BufferReader::isSeekAccurate() const
+{
+	return true;
+}
+
 void BufferReader::seek(int position)
 {
 	m_position = position;
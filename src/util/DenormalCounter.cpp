@@ -0,0 +1,71 @@
+/*******************************************************************************
+ * Copyright 2009-2016 Jörg Müller
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ ******************************************************************************/
+
+#include "util/DenormalCounter.h"
+
+#include <atomic>
+#include <cmath>
+#include <mutex>
+
+AUD_NAMESPACE_BEGIN
+
+static std::atomic<bool> denormal_counter_enabled(false);
+static std::mutex denormal_counter_mutex;
+
+static std::map<std::string, unsigned long long>& denormalCounts()
+{
+	static std::map<std::string, unsigned long long> counts;
+	return counts;
+}
+
+void DenormalCounter::countDenormals(const char* name, const sample_t* buffer, int length)
+{
+	unsigned long long count = 0;
+
+	for(int i = 0; i < length; i++)
+		if(std::fpclassify(buffer[i]) == FP_SUBNORMAL)
+			count++;
+
+	if(count > 0)
+	{
+		std::lock_guard<std::mutex> lock(denormal_counter_mutex);
+		denormalCounts()[name] += count;
+	}
+}
+
+void DenormalCounter::setEnabled(bool enabled)
+{
+	denormal_counter_enabled = enabled;
+}
+
+bool DenormalCounter::isEnabled()
+{
+	return denormal_counter_enabled;
+}
+
+std::map<std::string, unsigned long long> DenormalCounter::getCounts()
+{
+	std::lock_guard<std::mutex> lock(denormal_counter_mutex);
+	return denormalCounts();
+}
+
+void DenormalCounter::reset()
+{
+	std::lock_guard<std::mutex> lock(denormal_counter_mutex);
+	denormalCounts().clear();
+}
+
+AUD_NAMESPACE_END
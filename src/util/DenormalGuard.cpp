@@ -0,0 +1,99 @@
+/*******************************************************************************
+ * Copyright 2009-2016 Jörg Müller
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ ******************************************************************************/
+
+#include "util/DenormalGuard.h"
+
+#include <atomic>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define AUD_DENORMAL_SSE
+#include <xmmintrin.h>
+#elif defined(__aarch64__) && defined(__GNUC__)
+#define AUD_DENORMAL_AARCH64
+#endif
+
+#ifdef AUD_DENORMAL_SSE
+/// MXCSR flush to zero and denormals are zero bits.
+#define AUD_DENORMAL_FLAGS 0x8040
+#endif
+
+#ifdef AUD_DENORMAL_AARCH64
+/// FPCR flush to zero bit.
+#define AUD_DENORMAL_FLAGS (1ULL << 24)
+#endif
+
+AUD_NAMESPACE_BEGIN
+
+static std::atomic<bool> denormal_guard_enabled(true);
+
+DenormalGuard::DenormalGuard() :
+	m_state(0), m_active(false)
+{
+	if(!denormal_guard_enabled)
+		return;
+
+#if defined(AUD_DENORMAL_SSE)
+	m_state = _mm_getcsr();
+
+	if((m_state & AUD_DENORMAL_FLAGS) != AUD_DENORMAL_FLAGS)
+	{
+		_mm_setcsr(static_cast<unsigned int>(m_state | AUD_DENORMAL_FLAGS));
+		m_active = true;
+	}
+#elif defined(AUD_DENORMAL_AARCH64)
+	asm volatile("mrs %0, fpcr" : "=r"(m_state));
+
+	if((m_state & AUD_DENORMAL_FLAGS) != AUD_DENORMAL_FLAGS)
+	{
+		unsigned long long state = m_state | AUD_DENORMAL_FLAGS;
+		asm volatile("msr fpcr, %0" : : "r"(state));
+		m_active = true;
+	}
+#endif
+}
+
+DenormalGuard::~DenormalGuard()
+{
+	if(!m_active)
+		return;
+
+#if defined(AUD_DENORMAL_SSE)
+	_mm_setcsr(static_cast<unsigned int>(m_state));
+#elif defined(AUD_DENORMAL_AARCH64)
+	asm volatile("msr fpcr, %0" : : "r"(m_state));
+#endif
+}
+
+void DenormalGuard::setEnabled(bool enabled)
+{
+	denormal_guard_enabled = enabled;
+}
+
+bool DenormalGuard::isEnabled()
+{
+	return denormal_guard_enabled;
+}
+
+bool DenormalGuard::isSupported()
+{
+#if defined(AUD_DENORMAL_SSE) || defined(AUD_DENORMAL_AARCH64)
+	return true;
+#else
+	return false;
+#endif
+}
+
+AUD_NAMESPACE_END
@@ -0,0 +1,83 @@
+/*******************************************************************************
+ * Copyright 2009-2016 Jörg Müller
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ ******************************************************************************/
+
+
+#include "util/LoadProgress.h"
+
+AUD_NAMESPACE_BEGIN
+
+LoadProgress::LoadProgress() :
+	m_loaded(0), m_total(0), m_finished(false), m_cancelled(false)
+{
+}
+
+float LoadProgress::getProgress() const
+{
+	if(m_finished && !m_cancelled)
+		return 1.0f;
+
+	int total = m_total;
+
+	if(total <= 0)
+		return 0.0f;
+
+	float progress = float(m_loaded) / float(total);
+
+	// lengths reported by readers may be inaccurate
+	return progress < 1.0f ? progress : 1.0f;
+}
+
+int LoadProgress::getLoaded() const
+{
+	return m_loaded;
+}
+
+int LoadProgress::getTotal() const
+{
+	return m_total;
+}
+
+bool LoadProgress::isFinished() const
+{
+	return m_finished;
+}
+
+void LoadProgress::cancel()
+{
+	m_cancelled = true;
+}
+
+bool LoadProgress::isCancelled() const
+{
+	return m_cancelled;
+}
+
+void LoadProgress::setTotal(int total)
+{
+	m_total = total;
+}
+
+void LoadProgress::advance(int length)
+{
+	m_loaded += length;
+}
+
+void LoadProgress::finish()
+{
+	m_finished = true;
+}
+
+AUD_NAMESPACE_END
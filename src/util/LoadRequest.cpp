@@ -0,0 +1,135 @@
+/*******************************************************************************
+ * Copyright 2009-2016 Jörg Müller
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ ******************************************************************************/
+
+
+#include "util/LoadRequest.h"
+#include "util/LoadProgress.h"
+
+#include <chrono>
+
+AUD_NAMESPACE_BEGIN
+
+LoadRequest::LoadRequest(LoadPriority priority, callback_t callback) :
+	m_progress(std::make_shared<LoadProgress>()), m_priority(priority), m_status(LOAD_STATUS_QUEUED), m_callback(callback)
+{
+}
+
+bool LoadRequest::start()
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+
+	if(m_status != LOAD_STATUS_QUEUED)
+		return false;
+
+	m_status = LOAD_STATUS_LOADING;
+
+	return true;
+}
+
+void LoadRequest::finish(LoadStatus status, std::shared_ptr<ISound> sound, const std::string& error)
+{
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+
+		m_status = status;
+		m_sound = sound;
+		m_error = error;
+		m_progress->finish();
+	}
+
+	// waiting threads resume after the callback
+	if(m_callback)
+		m_callback(*this);
+
+	m_condition.notify_all();
+}
+
+LoadPriority LoadRequest::getPriority() const
+{
+	return m_priority;
+}
+
+LoadStatus LoadRequest::getStatus() const
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+
+	return m_status;
+}
+
+bool LoadRequest::isFinished() const
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+
+	return m_status != LOAD_STATUS_QUEUED && m_status != LOAD_STATUS_LOADING;
+}
+
+std::shared_ptr<LoadProgress> LoadRequest::getProgress() const
+{
+	return m_progress;
+}
+
+std::shared_ptr<ISound> LoadRequest::getSound() const
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+
+	return m_sound;
+}
+
+std::string LoadRequest::getError() const
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+
+	return m_error;
+}
+
+void LoadRequest::cancel()
+{
+	m_progress->cancel();
+
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+
+		// running requests finish themselves once they notice the cancellation
+		if(m_status != LOAD_STATUS_QUEUED)
+			return;
+
+		m_status = LOAD_STATUS_CANCELLED;
+		m_progress->finish();
+	}
+
+	if(m_callback)
+		m_callback(*this);
+
+	m_condition.notify_all();
+}
+
+std::shared_ptr<ISound> LoadRequest::wait()
+{
+	std::unique_lock<std::mutex> lock(m_mutex);
+
+	m_condition.wait(lock, [this]{ return m_status != LOAD_STATUS_QUEUED && m_status != LOAD_STATUS_LOADING; });
+
+	return m_sound;
+}
+
+bool LoadRequest::wait(float timeout)
+{
+	std::unique_lock<std::mutex> lock(m_mutex);
+
+	return m_condition.wait_for(lock, std::chrono::duration<float>(timeout), [this]{ return m_status != LOAD_STATUS_QUEUED && m_status != LOAD_STATUS_LOADING; });
+}
+
+AUD_NAMESPACE_END
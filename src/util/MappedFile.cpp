@@ -0,0 +1,119 @@
+/*******************************************************************************
+ * Copyright 2009-2016 Jörg Müller
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ ******************************************************************************/
+
+#include "util/MappedFile.h"
+#include "Exception.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+AUD_NAMESPACE_BEGIN
+
+#ifdef _WIN32
+
+MappedFile::MappedFile(std::string filename) :
+	m_data(nullptr), m_size(0), m_mapping(nullptr)
+{
+	HANDLE file = CreateFileA(filename.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+
+	if(file == INVALID_HANDLE_VALUE)
+		AUD_THROW(FileException, "The file couldn't be opened.");
+
+	LARGE_INTEGER size;
+
+	if(!GetFileSizeEx(file, &size) || size.QuadPart == 0)
+	{
+		CloseHandle(file);
+		AUD_THROW(FileException, "The file is empty or its size couldn't be determined.");
+	}
+
+	HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+	CloseHandle(file);
+
+	if(!mapping)
+		AUD_THROW(FileException, "The file couldn't be mapped into memory.");
+
+	m_data = reinterpret_cast<const data_t*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+
+	if(!m_data)
+	{
+		CloseHandle(mapping);
+		AUD_THROW(FileException, "The file couldn't be mapped into memory.");
+	}
+
+	m_size = size_t(size.QuadPart);
+	m_mapping = mapping;
+}
+
+MappedFile::~MappedFile()
+{
+	UnmapViewOfFile(m_data);
+	CloseHandle(m_mapping);
+}
+
+#else
+
+MappedFile::MappedFile(std::string filename) :
+	m_data(nullptr), m_size(0), m_mapping(nullptr)
+{
+	int file = open(filename.c_str(), O_RDONLY);
+
+	if(file < 0)
+		AUD_THROW(FileException, "The file couldn't be opened.");
+
+	struct stat info;
+
+	if(fstat(file, &info) < 0 || info.st_size <= 0)
+	{
+		close(file);
+		AUD_THROW(FileException, "The file is empty or its size couldn't be determined.");
+	}
+
+	void* mapping = mmap(nullptr, size_t(info.st_size), PROT_READ, MAP_PRIVATE, file, 0);
+	close(file);
+
+	if(mapping == MAP_FAILED)
+		AUD_THROW(FileException, "The file couldn't be mapped into memory.");
+
+	m_size = size_t(info.st_size);
+	m_mapping = mapping;
+	m_data = reinterpret_cast<const data_t*>(mapping);
+}
+
+MappedFile::~MappedFile()
+{
+	munmap(m_mapping, m_size);
+}
+
+#endif
+
+const data_t* MappedFile::getData() const
+{
+	return m_data;
+}
+
+size_t MappedFile::getSize() const
+{
+	return m_size;
+}
+
+AUD_NAMESPACE_END
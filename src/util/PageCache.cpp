@@ -0,0 +1,226 @@
+/*******************************************************************************
+ * Copyright 2009-2016 Jörg Müller
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ ******************************************************************************/
+
+#include "util/PageCache.h"
+#include "util/Buffer.h"
+
+#include <condition_variable>
+#include <list>
+#include <map>
+#include <mutex>
+#include <set>
+#include <utility>
+
+AUD_NAMESPACE_BEGIN
+
+typedef std::pair<std::string, int> PageKey;
+
+/// An entry of the least recently used list.
+struct PageCacheEntry
+{
+	PageKey key;
+	std::shared_ptr<const PageCache::Page> page;
+	size_t size;
+};
+
+/// The source information.
+struct PageCacheSource
+{
+	Specs specs;
+	int length;
+};
+
+/// The global cache state.
+struct PageCacheState
+{
+	std::mutex mutex;
+	std::condition_variable condition;
+	size_t budget = 0;
+	size_t usage = 0;
+	std::list<PageCacheEntry> entries;
+	std::map<PageKey, std::list<PageCacheEntry>::iterator> pages;
+	std::set<PageKey> loading;
+	std::map<std::string, PageCacheSource> infos;
+};
+
+static PageCacheState& pageCacheState()
+{
+	static PageCacheState state;
+	return state;
+}
+
+// called with the mutex locked
+static void evictPages(PageCacheState& cache)
+{
+	while(cache.usage > cache.budget && !cache.entries.empty())
+	{
+		cache.usage -= cache.entries.back().size;
+		cache.pages.erase(cache.entries.back().key);
+		cache.entries.pop_back();
+	}
+}
+
+void PageCache::setBudget(size_t bytes)
+{
+	PageCacheState& cache = pageCacheState();
+	std::lock_guard<std::mutex> lock(cache.mutex);
+
+	cache.budget = bytes;
+	evictPages(cache);
+}
+
+size_t PageCache::getBudget()
+{
+	PageCacheState& cache = pageCacheState();
+	std::lock_guard<std::mutex> lock(cache.mutex);
+
+	return cache.budget;
+}
+
+size_t PageCache::getMemoryUsage()
+{
+	PageCacheState& cache = pageCacheState();
+	std::lock_guard<std::mutex> lock(cache.mutex);
+
+	return cache.usage;
+}
+
+void PageCache::clear()
+{
+	PageCacheState& cache = pageCacheState();
+	std::lock_guard<std::mutex> lock(cache.mutex);
+
+	cache.entries.clear();
+	cache.pages.clear();
+	cache.infos.clear();
+	cache.usage = 0;
+}
+
+std::shared_ptr<const PageCache::Page> PageCache::getPage(const std::string& source, int index, const loader_f& loader)
+{
+	PageCacheState& cache = pageCacheState();
+	PageKey key(source, index);
+
+	std::unique_lock<std::mutex> lock(cache.mutex);
+
+	for(;;)
+	{
+		auto it = cache.pages.find(key);
+
+		if(it != cache.pages.end())
+		{
+			cache.entries.splice(cache.entries.begin(), cache.entries, it->second);
+			return it->second->page;
+		}
+
+		if(!cache.loading.count(key))
+			break;
+
+		cache.condition.wait(lock);
+	}
+
+	cache.loading.insert(key);
+	lock.unlock();
+
+	std::shared_ptr<Page> page = std::make_shared<Page>();
+	bool loaded = false;
+
+	try
+	{
+		loaded = loader(*page);
+	}
+	catch(...)
+	{
+		lock.lock();
+		cache.loading.erase(key);
+		cache.condition.notify_all();
+		throw;
+	}
+
+	lock.lock();
+	cache.loading.erase(key);
+
+	if(loaded && cache.budget > 0)
+	{
+		PageCacheEntry entry;
+		entry.key = key;
+		entry.page = page;
+		entry.size = page->buffer ? page->buffer->getSize() : 0;
+
+		cache.entries.push_front(entry);
+		cache.pages[key] = cache.entries.begin();
+		cache.usage += entry.size;
+
+		evictPages(cache);
+	}
+
+	cache.condition.notify_all();
+
+	if(!loaded)
+		return nullptr;
+
+	return page;
+}
+
+void PageCache::addPage(const std::string& source, int index, std::shared_ptr<const Page> page)
+{
+	PageCacheState& cache = pageCacheState();
+	PageKey key(source, index);
+
+	std::lock_guard<std::mutex> lock(cache.mutex);
+
+	if(cache.budget == 0 || cache.pages.count(key) || cache.loading.count(key))
+		return;
+
+	PageCacheEntry entry;
+	entry.key = key;
+	entry.page = page;
+	entry.size = page->buffer ? page->buffer->getSize() : 0;
+
+	cache.entries.push_front(entry);
+	cache.pages[key] = cache.entries.begin();
+	cache.usage += entry.size;
+
+	evictPages(cache);
+}
+
+bool PageCache::getInfo(const std::string& source, Specs& specs, int& length)
+{
+	PageCacheState& cache = pageCacheState();
+	std::lock_guard<std::mutex> lock(cache.mutex);
+
+	auto it = cache.infos.find(source);
+
+	if(it == cache.infos.end())
+		return false;
+
+	specs = it->second.specs;
+	length = it->second.length;
+
+	return true;
+}
+
+void PageCache::setInfo(const std::string& source, Specs specs, int length)
+{
+	PageCacheState& cache = pageCacheState();
+	std::lock_guard<std::mutex> lock(cache.mutex);
+
+	PageCacheSource& info = cache.infos[source];
+	info.specs = specs;
+	info.length = length;
+}
+
+AUD_NAMESPACE_END
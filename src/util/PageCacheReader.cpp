@@ -0,0 +1,260 @@
+/*******************************************************************************
+ * Copyright 2009-2016 Jörg Müller
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ ******************************************************************************/
+
+#include "util/PageCacheReader.h"
+#include "util/Buffer.h"
+#include "file/FileManager.h"
+#include "Exception.h"
+
+#include <algorithm>
+#include <cstring>
+#include <map>
+#include <mutex>
+#include <sys/stat.h>
+
+// the maximum amount of pages decoded forward instead of seeking sample accurate readers
+#define MAX_DECODE_AHEAD 16
+
+AUD_NAMESPACE_BEGIN
+
+struct PageCacheReader::Decoder
+{
+	/// The decoding reader, created on demand.
+	std::shared_ptr<IReader> reader;
+
+	/// The index of the page the reader decodes next.
+	int page;
+
+	/// Mutex for decoding.
+	std::mutex mutex;
+};
+
+std::shared_ptr<PageCacheReader::Decoder> PageCacheReader::getDecoder(const std::string& source)
+{
+	static std::map<std::string, std::weak_ptr<Decoder> > decoders;
+	static std::mutex mutex;
+
+	std::lock_guard<std::mutex> lock(mutex);
+
+	std::shared_ptr<Decoder> decoder = decoders[source].lock();
+
+	if(!decoder)
+	{
+		decoder = std::make_shared<Decoder>();
+		decoder->page = 0;
+		decoders[source] = decoder;
+
+		// forget decoders of files that aren't read anymore
+		for(auto it = decoders.begin(); it != decoders.end();)
+		{
+			if(it->second.expired())
+				it = decoders.erase(it);
+			else
+				++it;
+		}
+	}
+
+	return decoder;
+}
+
+PageCacheReader::PageCacheReader(std::string filename) :
+	m_filename(filename),
+	m_position(0),
+	m_page_index(-1)
+{
+	struct stat info;
+
+	if(stat(filename.c_str(), &info) != 0)
+		AUD_THROW(FileException, "The file couldn't be found.");
+
+	// the size and modification time make sure changed files aren't read from stale pages
+	m_source = filename + ":" + std::to_string((long long)info.st_size) + ":" + std::to_string((long long)info.st_mtime);
+
+	std::shared_ptr<IReader> reader;
+
+	if(!PageCache::getInfo(m_source, m_specs, m_length))
+	{
+		reader = FileManager::createReader(filename);
+
+		if(!reader->isSeekable())
+			AUD_THROW(FileException, "The file isn't seekable and can't be cached in pages.");
+
+		m_specs = reader->getSpecs();
+		m_length = reader->getLength();
+
+		PageCache::setInfo(m_source, m_specs, m_length);
+	}
+
+	m_decoder = getDecoder(m_source);
+
+	// the reader opened for the file information is at the start of the file
+	std::lock_guard<std::mutex> lock(m_decoder->mutex);
+
+	if(reader && !m_decoder->reader)
+	{
+		m_decoder->reader = reader;
+		m_decoder->page = 0;
+	}
+}
+
+void PageCacheReader::decodePage(PageCache::Page& page)
+{
+	int start = m_decoder->page * PageCache::PAGE_LENGTH;
+
+	page.buffer = std::make_shared<Buffer>(PageCache::PAGE_LENGTH * AUD_SAMPLE_SIZE(m_specs));
+	page.length = 0;
+	page.last = false;
+
+	while(page.length < PageCache::PAGE_LENGTH && !page.last)
+	{
+		int length = PageCache::PAGE_LENGTH - page.length;
+
+		m_decoder->reader->read(length, page.last, page.buffer->getBuffer() + page.length * m_specs.channels);
+
+		page.length += length;
+
+		if(length == 0)
+			page.last = true;
+	}
+
+	m_decoder->page++;
+
+	// now the exact length is known
+	if(page.last)
+	{
+		m_length = start + page.length;
+		PageCache::setInfo(m_source, m_specs, m_length);
+	}
+}
+
+bool PageCacheReader::loadPage(int index, PageCache::Page& page)
+{
+	std::lock_guard<std::mutex> lock(m_decoder->mutex);
+
+	if(!m_decoder->reader)
+	{
+		m_decoder->reader = FileManager::createReader(m_filename);
+		m_decoder->page = 0;
+	}
+
+	if(m_decoder->reader->isSeekAccurate())
+	{
+		// seeking is slower than decoding a few pages, so short jumps forward are decoded
+		if(index < m_decoder->page || index - m_decoder->page > MAX_DECODE_AHEAD)
+		{
+			m_decoder->reader->seek(index * PageCache::PAGE_LENGTH);
+			m_decoder->page = index;
+		}
+	}
+	// pages decoded after an inexact seek would be misaligned for all readers of the file
+	else if(index < m_decoder->page)
+	{
+		m_decoder->reader = FileManager::createReader(m_filename);
+		m_decoder->page = 0;
+	}
+
+	while(m_decoder->page < index)
+	{
+		int passed = m_decoder->page;
+		std::shared_ptr<PageCache::Page> skipped = std::make_shared<PageCache::Page>();
+
+		decodePage(*skipped);
+		PageCache::addPage(m_source, passed, skipped);
+
+		if(skipped->last)
+		{
+			page.buffer = nullptr;
+			page.length = 0;
+			page.last = true;
+			return true;
+		}
+	}
+
+	decodePage(page);
+
+	return true;
+}
+
+bool PageCacheReader::isSeekable() const
+{
+	return true;
+}
+
+void PageCacheReader::seek(int position)
+{
+	m_position = std::max(position, 0);
+}
+
+int PageCacheReader::getLength() const
+{
+	return m_length;
+}
+
+int PageCacheReader::getPosition() const
+{
+	return m_position;
+}
+
+Specs PageCacheReader::getSpecs() const
+{
+	return m_specs;
+}
+
+void PageCacheReader::read(int& length, bool& eos, sample_t* buffer)
+{
+	eos = false;
+
+	int sample_size = AUD_SAMPLE_SIZE(m_specs);
+	int done = 0;
+
+	while(done < length)
+	{
+		int index = m_position / PageCache::PAGE_LENGTH;
+		int offset = m_position % PageCache::PAGE_LENGTH;
+
+		if(!m_page || m_page_index != index)
+		{
+			m_page = PageCache::getPage(m_source, index, [this, index](PageCache::Page& page) { return loadPage(index, page); });
+			m_page_index = index;
+
+			if(!m_page)
+			{
+				eos = true;
+				break;
+			}
+		}
+
+		int count = std::min(length - done, m_page->length - offset);
+
+		if(count > 0)
+		{
+			std::memcpy(buffer + done * m_specs.channels, m_page->buffer->getBuffer() + offset * m_specs.channels, count * sample_size);
+
+			done += count;
+			m_position += count;
+		}
+
+		if(m_page->last && offset + std::max(count, 0) >= m_page->length)
+		{
+			eos = true;
+			break;
+		}
+	}
+
+	length = done;
+}
+
+AUD_NAMESPACE_END
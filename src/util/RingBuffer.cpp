@@ -0,0 +1,102 @@
+/*******************************************************************************
+ * Copyright 2009-2016 Jörg Müller
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ ******************************************************************************/
+
+#include "util/RingBuffer.h"
+
+#include <algorithm>
+#include <cstring>
+
+AUD_NAMESPACE_BEGIN
+
+RingBuffer::RingBuffer(int size) :
+	m_buffer((size + 1) * sizeof(sample_t)),
+	m_size(size + 1),
+	m_read(0),
+	m_write(0)
+{
+}
+
+int RingBuffer::getSize() const
+{
+	return m_size - 1;
+}
+
+void RingBuffer::resize(int size)
+{
+	m_buffer.resize((size + 1) * sizeof(sample_t));
+	m_size = size + 1;
+	reset();
+}
+
+void RingBuffer::reset()
+{
+	m_read = 0;
+	m_write = 0;
+}
+
+int RingBuffer::getReadSpace() const
+{
+	int read = m_read.load(std::memory_order_relaxed);
+	int write = m_write.load(std::memory_order_acquire);
+
+	return (write - read + m_size) % m_size;
+}
+
+int RingBuffer::getWriteSpace() const
+{
+	int read = m_read.load(std::memory_order_acquire);
+	int write = m_write.load(std::memory_order_relaxed);
+
+	return (read - write + m_size - 1) % m_size;
+}
+
+int RingBuffer::read(sample_t* buffer, int length)
+{
+	int read = m_read.load(std::memory_order_relaxed);
+	int write = m_write.load(std::memory_order_acquire);
+
+	length = std::min(length, (write - read + m_size) % m_size);
+
+	sample_t* data = m_buffer.getBuffer();
+	int first = std::min(length, m_size - read);
+
+	std::memcpy(buffer, data + read, first * sizeof(sample_t));
+	std::memcpy(buffer + first, data, (length - first) * sizeof(sample_t));
+
+	m_read.store((read + length) % m_size, std::memory_order_release);
+
+	return length;
+}
+
+int RingBuffer::write(const sample_t* buffer, int length)
+{
+	int read = m_read.load(std::memory_order_acquire);
+	int write = m_write.load(std::memory_order_relaxed);
+
+	length = std::min(length, (read - write + m_size - 1) % m_size);
+
+	sample_t* data = m_buffer.getBuffer();
+	int first = std::min(length, m_size - write);
+
+	std::memcpy(data + write, buffer, first * sizeof(sample_t));
+	std::memcpy(data, buffer + first, (length - first) * sizeof(sample_t));
+
+	m_write.store((write + length) % m_size, std::memory_order_release);
+
+	return length;
+}
+
+AUD_NAMESPACE_END
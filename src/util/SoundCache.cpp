@@ -0,0 +1,206 @@
+/*******************************************************************************
+ * Copyright 2009-2016 Jörg Müller
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ ******************************************************************************/
+
+#include "util/SoundCache.h"
+#include "util/BlockBuffer.h"
+
+#include <list>
+#include <map>
+#include <mutex>
+
+AUD_NAMESPACE_BEGIN
+
+/// An entry of the least recently used list.
+struct SoundCacheEntry
+{
+	unsigned int id;
+	std::shared_ptr<BlockBuffer> buffer;
+	size_t size;
+	bool evictable;
+};
+
+/// The global cache state.
+struct SoundCacheState
+{
+	std::mutex mutex;
+	size_t budget = 0;
+	size_t usage = 0;
+	unsigned int next_id = 0;
+	unsigned long long hits = 0;
+	unsigned long long misses = 0;
+	unsigned long long evictions = 0;
+	std::list<SoundCacheEntry> entries;
+	std::map<unsigned int, std::list<SoundCacheEntry>::iterator> ids;
+};
+
+static SoundCacheState& soundCacheState()
+{
+	static SoundCacheState state;
+	return state;
+}
+
+// called with the mutex locked, the most recently used entry is kept
+static void evictSounds(SoundCacheState& cache)
+{
+	if(!cache.budget || cache.entries.empty())
+		return;
+
+	auto it = cache.entries.end();
+
+	while(cache.usage > cache.budget && --it != cache.entries.begin())
+	{
+		if(!it->evictable)
+			continue;
+
+		cache.usage -= it->size;
+		cache.ids.erase(it->id);
+		it = cache.entries.erase(it);
+		cache.evictions++;
+	}
+}
+
+// called with the mutex locked
+static void insertSound(SoundCacheState& cache, unsigned int id, std::shared_ptr<BlockBuffer> buffer, bool evictable)
+{
+	SoundCacheEntry entry;
+	entry.id = id;
+	entry.buffer = buffer;
+	entry.size = buffer ? buffer->getSize() : 0;
+	entry.evictable = evictable;
+
+	cache.entries.push_front(entry);
+	cache.ids[id] = cache.entries.begin();
+	cache.usage += entry.size;
+
+	evictSounds(cache);
+}
+
+void SoundCache::setBudget(size_t bytes)
+{
+	SoundCacheState& cache = soundCacheState();
+	std::lock_guard<std::mutex> lock(cache.mutex);
+
+	cache.budget = bytes;
+	evictSounds(cache);
+}
+
+size_t SoundCache::getBudget()
+{
+	SoundCacheState& cache = soundCacheState();
+	std::lock_guard<std::mutex> lock(cache.mutex);
+
+	return cache.budget;
+}
+
+size_t SoundCache::getMemoryUsage()
+{
+	SoundCacheState& cache = soundCacheState();
+	std::lock_guard<std::mutex> lock(cache.mutex);
+
+	return cache.usage;
+}
+
+unsigned long long SoundCache::getHits()
+{
+	SoundCacheState& cache = soundCacheState();
+	std::lock_guard<std::mutex> lock(cache.mutex);
+
+	return cache.hits;
+}
+
+unsigned long long SoundCache::getMisses()
+{
+	SoundCacheState& cache = soundCacheState();
+	std::lock_guard<std::mutex> lock(cache.mutex);
+
+	return cache.misses;
+}
+
+unsigned long long SoundCache::getEvictions()
+{
+	SoundCacheState& cache = soundCacheState();
+	std::lock_guard<std::mutex> lock(cache.mutex);
+
+	return cache.evictions;
+}
+
+void SoundCache::resetStatistics()
+{
+	SoundCacheState& cache = soundCacheState();
+	std::lock_guard<std::mutex> lock(cache.mutex);
+
+	cache.hits = 0;
+	cache.misses = 0;
+	cache.evictions = 0;
+}
+
+unsigned int SoundCache::add(std::shared_ptr<BlockBuffer> buffer, bool evictable)
+{
+	SoundCacheState& cache = soundCacheState();
+	std::lock_guard<std::mutex> lock(cache.mutex);
+
+	unsigned int id = cache.next_id++;
+
+	insertSound(cache, id, buffer, evictable);
+
+	return id;
+}
+
+void SoundCache::restore(unsigned int id, std::shared_ptr<BlockBuffer> buffer)
+{
+	SoundCacheState& cache = soundCacheState();
+	std::lock_guard<std::mutex> lock(cache.mutex);
+
+	// another thread might have restored it already
+	if(!cache.ids.count(id))
+		insertSound(cache, id, buffer, true);
+}
+
+std::shared_ptr<BlockBuffer> SoundCache::get(unsigned int id)
+{
+	SoundCacheState& cache = soundCacheState();
+	std::lock_guard<std::mutex> lock(cache.mutex);
+
+	auto it = cache.ids.find(id);
+
+	if(it == cache.ids.end())
+	{
+		cache.misses++;
+		return nullptr;
+	}
+
+	cache.hits++;
+	cache.entries.splice(cache.entries.begin(), cache.entries, it->second);
+
+	return it->second->buffer;
+}
+
+void SoundCache::remove(unsigned int id)
+{
+	SoundCacheState& cache = soundCacheState();
+	std::lock_guard<std::mutex> lock(cache.mutex);
+
+	auto it = cache.ids.find(id);
+
+	if(it == cache.ids.end())
+		return;
+
+	cache.usage -= it->second->size;
+	cache.entries.erase(it->second);
+	cache.ids.erase(it);
+}
+
+AUD_NAMESPACE_END
@@ -15,59 +15,291 @@
  ******************************************************************************/
 
 #include "util/StreamBuffer.h"
-#include "util/BufferReader.h"
+#include "util/BlockBufferReader.h"
 #include "util/Buffer.h"
+#include "util/LoadProgress.h"
+#include "util/SoundCache.h"
+#include "util/ThreadPool.h"
+#include "Exception.h"
 
-// 5 sec * 48000 samples/sec * 4 bytes/sample * 6 channels
-#define BUFFER_RESIZE_BYTES 5760000
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <mutex>
+#include <vector>
+
+// the minimum length of a range decoded in parallel
+#define MIN_RANGE_LENGTH (BlockBuffer::BLOCK_LENGTH * 16)
+// the amount of ranges per thread, more ranges balance the load better
+#define RANGES_PER_THREAD 4
 
 AUD_NAMESPACE_BEGIN
 
-StreamBuffer::StreamBuffer(std::shared_ptr<ISound> sound) :
-	m_buffer(new Buffer())
+/// The state shared by the threads decoding a StreamBuffer in parallel.
+struct StreamBufferJob
 {
-	std::shared_ptr<IReader> reader = sound->createReader();
+	/// The sound to decode.
+	std::shared_ptr<ISound> sound;
+
+	/// The specification of the samples.
+	Specs specs;
+
+	/// The storage format of the samples.
+	StorageFormat format;
+
+	/// The progress to report to, may be nullptr.
+	std::shared_ptr<LoadProgress> progress;
+
+	/// The length of all ranges but the last in samples.
+	int range_length;
+
+	/// The decoded ranges.
+	std::vector<std::shared_ptr<BlockBuffer>> ranges;
+
+	/// The index of the next range to decode.
+	std::atomic<int> next;
+
+	/// The amount of ranges that have been decoded.
+	int done;
+
+	/// Whether a range ended before its expected end.
+	bool incomplete;
+
+	/// The first error that occured.
+	std::exception_ptr error;
+
+	/// Mutex for the results.
+	std::mutex mutex;
 
-	m_specs = reader->getSpecs();
+	/// Signals finished ranges.
+	std::condition_variable condition;
+};
 
-	int sample_size = AUD_SAMPLE_SIZE(m_specs);
-	int length;
-	int index = 0;
+/**
+ * Reads samples from a reader into a block buffer.
+ * \param reader The reader to read from.
+ * \param buffer The buffer to append to.
+ * \param length The amount of samples to read or -1 to read until the end.
+ * \param progress The progress to report to, may be nullptr.
+ */
+static void read_samples(std::shared_ptr<IReader> reader, BlockBuffer& buffer, int length, LoadProgress* progress)
+{
+	Buffer block(BlockBuffer::BLOCK_LENGTH * AUD_SAMPLE_SIZE(buffer.getSpecs()));
+	int len;
 	bool eos = false;
 
-	// get an approximated size if possible
-	int size = reader->getLength();
+	// blocks are appended, so nothing is copied while the buffer grows
+	while(!eos && length != 0)
+	{
+		if(progress && progress->isCancelled())
+			return;
+
+		len = BlockBuffer::BLOCK_LENGTH;
+
+		if(length > 0)
+		{
+			len = std::min(len, length);
+			length -= len;
+		}
+
+		reader->read(len, eos, block.getBuffer());
+		buffer.append(block.getBuffer(), len);
+
+		if(progress)
+			progress->advance(len);
+	}
+
+	buffer.finish();
+}
+
+/**
+ * Decodes ranges of a job until there are none left.
+ * \param job The job to work on.
+ * \param reader A reader at position 0 to use for the first range or nullptr.
+ */
+static void decode_ranges(std::shared_ptr<StreamBufferJob> job, std::shared_ptr<IReader> reader)
+{
+	int count = job->ranges.size();
+
+	for(int index = job->next++; index < count; index = job->next++)
+	{
+		std::shared_ptr<BlockBuffer> buffer = std::make_shared<BlockBuffer>(job->specs, job->format);
+		bool last = index == count - 1;
+		std::exception_ptr error;
+
+		try
+		{
+			if(index || !reader)
+			{
+				reader = job->sound->createReader();
+				reader->seek(index * job->range_length);
+			}
+
+			read_samples(reader, *buffer, last ? -1 : job->range_length, job->progress.get());
+		}
+		catch(...)
+		{
+			error = std::current_exception();
+		}
+
+		std::lock_guard<std::mutex> lock(job->mutex);
+
+		job->ranges[index] = buffer;
+
+		if(!last && buffer->getLength() != job->range_length)
+			job->incomplete = true;
+
+		if(error && !job->error)
+			job->error = error;
+
+		job->done++;
+		job->condition.notify_all();
+	}
+}
 
-	if(size <= 0)
-		size = BUFFER_RESIZE_BYTES / sample_size;
-	else
-		size += m_specs.rate;
+StreamBuffer::StreamBuffer(std::shared_ptr<ISound> sound, StorageFormat format) :
+	m_sound(sound), m_format(format)
+{
+	m_id = SoundCache::add(decode(m_specs, nullptr), true);
+}
 
-	// as long as the end of the stream is not reached
-	while(!eos)
+StreamBuffer::StreamBuffer(std::shared_ptr<ISound> sound, std::shared_ptr<ThreadPool> threadPool, StorageFormat format, std::shared_ptr<LoadProgress> progress) :
+	m_sound(sound), m_format(format), m_pool(threadPool)
+{
+	try
 	{
-		// increase
-		m_buffer->resize(size*sample_size, true);
-
-		// read more
-		length = size-index;
-		reader->read(length, eos, m_buffer->getBuffer() + index * m_specs.channels);
-		if(index == m_buffer->getSize() / sample_size)
-			size += BUFFER_RESIZE_BYTES / sample_size;
-		index += length;
+		m_id = SoundCache::add(decode(m_specs, progress), true);
+	}
+	catch(...)
+	{
+		if(progress)
+			progress->finish();
+		throw;
 	}
 
-	m_buffer->resize(index * sample_size, true);
+	if(progress)
+		progress->finish();
 }
 
 StreamBuffer::StreamBuffer(std::shared_ptr<Buffer> buffer, Specs specs) :
-	m_buffer(buffer), m_specs(specs)
+	m_specs(specs), m_format(STORAGE_FLOAT32)
 {
+	m_id = SoundCache::add(std::make_shared<BlockBuffer>(buffer, specs), false);
+}
+
+StreamBuffer::~StreamBuffer()
+{
+	SoundCache::remove(m_id);
+}
+
+std::shared_ptr<BlockBuffer> StreamBuffer::decode(Specs& specs, std::shared_ptr<LoadProgress> progress)
+{
+	std::shared_ptr<IReader> reader = m_sound->createReader();
+
+	specs = reader->getSpecs();
+
+	int length = reader->getLength();
+
+	if(progress)
+		progress->setTotal(std::max(length, 0));
+
+	std::shared_ptr<BlockBuffer> buffer;
+
+	// ranges only join seamlessly if seeking doesn't shift or reset the samples
+	if(m_pool && reader->isSeekable() && reader->isSeekAccurate() && length >= 2 * MIN_RANGE_LENGTH)
+	{
+		buffer = decodeParallel(reader, progress);
+
+		if(buffer)
+			return buffer;
+
+		// the reported length was wrong, start over on this thread
+		if(progress)
+			progress->advance(-progress->getLoaded());
+
+		reader = m_sound->createReader();
+	}
+
+	buffer = std::make_shared<BlockBuffer>(specs, m_format);
+
+	read_samples(reader, *buffer, -1, progress.get());
+
+	if(progress && progress->isCancelled())
+		AUD_THROW(StateException, "Loading the sound has been cancelled.");
+
+	return buffer;
+}
+
+std::shared_ptr<BlockBuffer> StreamBuffer::decodeParallel(std::shared_ptr<IReader> reader, std::shared_ptr<LoadProgress> progress)
+{
+	int length = reader->getLength();
+	int threads = m_pool->getNumOfThreads() + 1;
+	int count = std::max(std::min(threads * RANGES_PER_THREAD, length / MIN_RANGE_LENGTH), 1);
+
+	std::shared_ptr<StreamBufferJob> job = std::make_shared<StreamBufferJob>();
+	job->sound = m_sound;
+	job->specs = reader->getSpecs();
+	job->format = m_format;
+	job->progress = progress;
+
+	// ranges consist of whole blocks so that they can be joined
+	job->range_length = (length + count - 1) / count;
+	job->range_length = (job->range_length + BlockBuffer::BLOCK_LENGTH - 1) / BlockBuffer::BLOCK_LENGTH * BlockBuffer::BLOCK_LENGTH;
+	count = (length + job->range_length - 1) / job->range_length;
+
+	job->ranges.resize(count);
+	job->next = 0;
+	job->done = 0;
+	job->incomplete = false;
+
+	std::shared_ptr<IReader> none;
+
+	for(int i = 1; i < std::min(threads, count); i++)
+		m_pool->enqueue(decode_ranges, job, none);
+
+	// the calling thread works as well, which guarantees progress even if
+	// all threads of the pool are busy
+	decode_ranges(job, reader);
+
+	std::unique_lock<std::mutex> lock(job->mutex);
+
+	job->condition.wait(lock, [&]{ return job->done == count; });
+
+	if(job->error)
+		std::rethrow_exception(job->error);
+
+	if(progress && progress->isCancelled())
+		AUD_THROW(StateException, "Loading the sound has been cancelled.");
+
+	if(job->incomplete)
+		return nullptr;
+
+	std::shared_ptr<BlockBuffer> buffer = job->ranges[0];
+
+	for(int i = 1; i < count; i++)
+	{
+		buffer->append(*job->ranges[i]);
+		job->ranges[i] = nullptr;
+	}
+
+	buffer->finish();
+
+	return buffer;
 }
 
 std::shared_ptr<Buffer> StreamBuffer::getBuffer()
 {
-	return m_buffer;
+	std::shared_ptr<BlockBuffer> buffer = SoundCache::get(m_id);
+
+	if(!buffer)
+	{
+		Specs specs;
+		buffer = decode(specs, nullptr);
+		SoundCache::restore(m_id, buffer);
+	}
+
+	return buffer->toBuffer();
 }
 
 Specs StreamBuffer::getSpecs()
@@ -75,9 +307,20 @@ Specs StreamBuffer::getSpecs()
 	return m_specs;
 }
 
+StorageFormat StreamBuffer::getFormat()
+{
+	return m_format;
+}
+
 std::shared_ptr<IReader> StreamBuffer::createReader()
 {
-	return std::shared_ptr<IReader>(new BufferReader(m_buffer, m_specs));
+	std::shared_ptr<BlockBuffer> buffer = SoundCache::get(m_id);
+
+	// the buffer has been evicted, stream from the source instead
+	if(!buffer)
+		return m_sound->createReader();
+
+	return std::shared_ptr<IReader>(new BlockBufferReader(buffer));
 }
 
 AUD_NAMESPACE_END
@@ -15,6 +15,7 @@
 ******************************************************************************/
 
 #include "util/ThreadPool.h"
+#include "util/DenormalGuard.h"
 
 AUD_NAMESPACE_BEGIN
 
@@ -42,6 +43,8 @@ unsigned int ThreadPool::getNumOfThreads()
 
 void ThreadPool::threadFunction()
 {
+	DenormalGuard guard;
+
 	while(true)
 	{
 		std::function<void()> task;
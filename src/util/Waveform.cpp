@@ -0,0 +1,314 @@
+/*******************************************************************************
+ * Copyright 2009-2016 Jörg Müller
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ ******************************************************************************/
+
+#include "util/Waveform.h"
+#include "util/Buffer.h"
+#include "util/LoadProgress.h"
+#include "respec/ChannelMapper.h"
+#include "IReader.h"
+#include "Exception.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+
+// the number of samples summarized by a bucket of the lowest level
+#define WAVEFORM_BUCKET 64
+
+// the minimum number of buckets a pixel spans when reading coarser levels
+#define WAVEFORM_BUCKETS_PER_PIXEL 4
+
+// the number of buckets decoded at once
+#define WAVEFORM_CHUNK 256
+
+#define WAVEFORM_MAGIC "AUDPEAKS"
+#define WAVEFORM_VERSION 1
+
+AUD_NAMESPACE_BEGIN
+
+Waveform::Waveform() :
+	m_rate(RATE_INVALID), m_length(0)
+{
+}
+
+std::shared_ptr<Waveform> Waveform::compute(std::shared_ptr<ISound> sound, std::shared_ptr<LoadProgress> progress)
+{
+	DeviceSpecs specs;
+	specs.rate = RATE_INVALID;
+	specs.channels = CHANNELS_MONO;
+	specs.format = FORMAT_INVALID;
+
+	std::shared_ptr<IReader> reader = ChannelMapper(sound, specs).createReader();
+
+	std::shared_ptr<Waveform> waveform(new Waveform());
+	waveform->m_rate = reader->getSpecs().rate;
+
+	if(progress)
+		progress->setTotal(std::max(reader->getLength(), 0));
+
+	Buffer buffer(WAVEFORM_BUCKET * WAVEFORM_CHUNK * sizeof(sample_t));
+	std::vector<Peak> peaks;
+	bool eos = false;
+
+	try
+	{
+		while(!eos)
+		{
+			if(progress && progress->isCancelled())
+				AUD_THROW(StateException, "Computing the waveform has been cancelled.");
+
+			sample_t* buf = buffer.getBuffer();
+			int len = 0;
+
+			// only the last bucket may be incomplete, so fill the whole chunk
+			while(len < WAVEFORM_BUCKET * WAVEFORM_CHUNK && !eos)
+			{
+				int read = WAVEFORM_BUCKET * WAVEFORM_CHUNK - len;
+				reader->read(read, eos, buf + len);
+
+				if(read <= 0 && !eos)
+					eos = true;
+
+				len += read;
+			}
+
+			for(int i = 0; i < len; i += WAVEFORM_BUCKET)
+			{
+				int count = std::min(WAVEFORM_BUCKET, len - i);
+				Peak peak;
+				peak.min = peak.max = buf[i];
+				peak.power = 0;
+
+				for(int j = i; j < i + count; j++)
+				{
+					peak.min = std::min(peak.min, buf[j]);
+					peak.max = std::max(peak.max, buf[j]);
+					peak.power += buf[j] * buf[j];
+				}
+
+				peaks.push_back(peak);
+			}
+
+			waveform->m_length += len;
+
+			if(progress)
+				progress->advance(len);
+		}
+	}
+	catch(...)
+	{
+		if(progress)
+			progress->finish();
+		throw;
+	}
+
+	if(progress)
+		progress->finish();
+
+	waveform->m_levels.push_back(std::move(peaks));
+
+	// every level combines two buckets of the level below
+	while(waveform->m_levels.back().size() > 1)
+	{
+		const std::vector<Peak>& below = waveform->m_levels.back();
+		std::vector<Peak> level((below.size() + 1) / 2);
+
+		for(std::size_t i = 0; i < level.size(); i++)
+		{
+			level[i] = below[i * 2];
+
+			if(i * 2 + 1 < below.size())
+			{
+				const Peak& peak = below[i * 2 + 1];
+				level[i].min = std::min(level[i].min, peak.min);
+				level[i].max = std::max(level[i].max, peak.max);
+				level[i].power += peak.power;
+			}
+		}
+
+		waveform->m_levels.push_back(std::move(level));
+	}
+
+	return waveform;
+}
+
+std::shared_ptr<Waveform> Waveform::load(std::string filename, unsigned long long stamp)
+{
+	std::FILE* file = std::fopen(filename.c_str(), "rb");
+
+	if(!file)
+		return nullptr;
+
+	std::fseek(file, 0, SEEK_END);
+	long file_size = std::ftell(file);
+	std::fseek(file, 0, SEEK_SET);
+
+	std::shared_ptr<Waveform> waveform(new Waveform());
+
+	char magic[sizeof(WAVEFORM_MAGIC) - 1];
+	int version, rate, levels;
+	unsigned long long file_stamp;
+	bool valid = std::fread(magic, sizeof(magic), 1, file) == 1 && !std::memcmp(magic, WAVEFORM_MAGIC, sizeof(magic)) &&
+				 std::fread(&version, sizeof(version), 1, file) == 1 && version == WAVEFORM_VERSION &&
+				 std::fread(&file_stamp, sizeof(file_stamp), 1, file) == 1 && file_stamp == stamp &&
+				 std::fread(&rate, sizeof(rate), 1, file) == 1 && rate > 0 &&
+				 std::fread(&waveform->m_length, sizeof(waveform->m_length), 1, file) == 1 && waveform->m_length >= 0 &&
+				 std::fread(&levels, sizeof(levels), 1, file) == 1 && levels > 0;
+
+	waveform->m_rate = SampleRate(rate);
+
+	// the levels have to have exactly the sizes compute() produces
+	long long expected = (waveform->m_length + WAVEFORM_BUCKET - 1) / WAVEFORM_BUCKET;
+
+	for(int i = 0; valid && i < levels; i++)
+	{
+		long long size;
+
+		valid = std::fread(&size, sizeof(size), 1, file) == 1 && size == expected && (i == levels - 1) == (size <= 1) &&
+				size <= (file_size - std::ftell(file)) / long(sizeof(Peak));
+
+		if(valid)
+		{
+			std::vector<Peak> level(size);
+			valid = std::fread(level.data(), sizeof(Peak), size, file) == std::size_t(size);
+			waveform->m_levels.push_back(std::move(level));
+		}
+
+		expected = (expected + 1) / 2;
+	}
+
+	std::fclose(file);
+
+	if(!valid)
+		return nullptr;
+
+	return waveform;
+}
+
+bool Waveform::save(std::string filename, unsigned long long stamp) const
+{
+	std::FILE* file = std::fopen(filename.c_str(), "wb");
+
+	if(!file)
+		return false;
+
+	int version = WAVEFORM_VERSION;
+	int rate = int(m_rate);
+	int levels = m_levels.size();
+
+	bool valid = std::fwrite(WAVEFORM_MAGIC, sizeof(WAVEFORM_MAGIC) - 1, 1, file) == 1 &&
+				 std::fwrite(&version, sizeof(version), 1, file) == 1 &&
+				 std::fwrite(&stamp, sizeof(stamp), 1, file) == 1 &&
+				 std::fwrite(&rate, sizeof(rate), 1, file) == 1 &&
+				 std::fwrite(&m_length, sizeof(m_length), 1, file) == 1 &&
+				 std::fwrite(&levels, sizeof(levels), 1, file) == 1;
+
+	for(const std::vector<Peak>& level : m_levels)
+	{
+		long long size = level.size();
+
+		valid = valid && std::fwrite(&size, sizeof(size), 1, file) == 1 &&
+				std::fwrite(level.data(), sizeof(Peak), size, file) == std::size_t(size);
+	}
+
+	valid = std::fclose(file) == 0 && valid;
+
+	// don't leave a broken file behind
+	if(!valid)
+		std::remove(filename.c_str());
+
+	return valid;
+}
+
+SampleRate Waveform::getRate() const
+{
+	return m_rate;
+}
+
+long long Waveform::getLength() const
+{
+	return m_length;
+}
+
+float Waveform::getPeak() const
+{
+	const std::vector<Peak>& top = m_levels.back();
+
+	if(top.empty())
+		return 0;
+
+	return std::max(-top[0].min, top[0].max);
+}
+
+size_t Waveform::getSize() const
+{
+	size_t size = 0;
+
+	for(const std::vector<Peak>& level : m_levels)
+		size += level.size() * sizeof(Peak);
+
+	return size;
+}
+
+int Waveform::read(float* buffer, int length, double start, double pixels_per_second) const
+{
+	if(m_levels.empty() || m_levels[0].empty())
+		return 0;
+
+	double samples_per_pixel = m_rate / pixels_per_second;
+
+	// use the coarsest level with a few buckets per pixel, as a bucket can stick out of its pixel
+	int level = 0;
+
+	while(level + 1 < int(m_levels.size()) && double(WAVEFORM_BUCKET << (level + 1)) * WAVEFORM_BUCKETS_PER_PIXEL <= samples_per_pixel)
+		level++;
+
+	const std::vector<Peak>& peaks = m_levels[level];
+	long long bucket = WAVEFORM_BUCKET << level;
+	double offset = start * m_rate;
+
+	for(int i = 0; i < length; i++)
+	{
+		long long begin = (long long)std::floor(offset + samples_per_pixel * i);
+		long long end = std::min((long long)std::floor(offset + samples_per_pixel * (i + 1)), m_length);
+
+		if(begin >= m_length || begin < 0)
+			return i;
+
+		long long first = begin / bucket;
+		long long last = std::max((end - 1) / bucket, first);
+
+		Peak peak = peaks[first];
+		long long count = std::min(bucket, m_length - first * bucket);
+
+		for(long long j = first + 1; j <= last; j++)
+		{
+			peak.min = std::min(peak.min, peaks[j].min);
+			peak.max = std::max(peak.max, peaks[j].max);
+			peak.power += peaks[j].power;
+			count += std::min(bucket, m_length - j * bucket);
+		}
+
+		buffer[i * 3] = peak.min;
+		buffer[i * 3 + 1] = peak.max;
+		buffer[i * 3 + 2] = std::sqrt(peak.power / count);
+	}
+
+	return length;
+}
+
+AUD_NAMESPACE_END
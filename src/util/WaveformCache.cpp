@@ -0,0 +1,307 @@
+/*******************************************************************************
+ * Copyright 2009-2016 Jörg Müller
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ ******************************************************************************/
+
+#include "util/WaveformCache.h"
+#include "util/AsyncLoader.h"
+#include "util/ThreadPool.h"
+#include "file/File.h"
+
+#include <cstdio>
+#include <functional>
+#include <list>
+#include <mutex>
+#include <unordered_map>
+#include <sys/stat.h>
+
+#define SIDECAR_EXTENSION ".peaks"
+#define DEFAULT_BUDGET (64 << 20)
+
+AUD_NAMESPACE_BEGIN
+
+/// A waveform kept by the cache.
+struct WaveformCacheEntry
+{
+	/// The path of the sound file.
+	std::string filename;
+
+	/// The waveform, possibly still being computed.
+	std::shared_future<std::shared_ptr<Waveform> > waveform;
+
+	/// Identifies the version of the sound file the waveform belongs to.
+	unsigned long long stamp;
+
+	/// Identifies the computation, so that a finished one doesn't touch a newer entry.
+	unsigned int id;
+
+	/// The memory used by the waveform, 0 while it's being computed.
+	size_t size;
+};
+
+/// The global state of the waveform cache.
+struct WaveformCacheState
+{
+	/// The waveforms, most recently requested first.
+	std::list<WaveformCacheEntry> entries;
+
+	/// The waveforms by path.
+	std::unordered_map<std::string, std::list<WaveformCacheEntry>::iterator> files;
+
+	/// The maximum size of all waveforms in bytes, 0 for no limit.
+	size_t budget;
+
+	/// The size of all computed waveforms in bytes.
+	size_t usage;
+
+	/// The id of the next computation.
+	unsigned int next_id;
+
+	/// The directory of the sidecar files.
+	std::string directory;
+
+	/// Whether sidecar files are used.
+	bool persistent;
+
+	/// Mutex for the cache.
+	std::mutex mutex;
+
+	WaveformCacheState() :
+		budget(DEFAULT_BUDGET), usage(0), next_id(0), persistent(true)
+	{
+	}
+};
+
+static WaveformCacheState& waveformCacheState()
+{
+	static WaveformCacheState state;
+	return state;
+}
+
+// called with the mutex locked, the most recently requested waveform is kept
+static void evict_waveforms(WaveformCacheState& state)
+{
+	if(!state.budget || state.entries.empty())
+		return;
+
+	auto it = state.entries.end();
+
+	while(state.usage > state.budget && --it != state.entries.begin())
+	{
+		// waveforms still being computed don't use memory yet
+		if(!it->size)
+			continue;
+
+		state.usage -= it->size;
+		state.files.erase(it->filename);
+		it = state.entries.erase(it);
+	}
+}
+
+// called with the mutex locked
+static void remove_waveform(WaveformCacheState& state, std::list<WaveformCacheEntry>::iterator it)
+{
+	state.usage -= it->size;
+	state.files.erase(it->filename);
+	state.entries.erase(it);
+}
+
+static std::string sidecar_path(const std::string& filename, const std::string& directory)
+{
+	if(directory.empty())
+		return filename + SIDECAR_EXTENSION;
+
+	// the hash of the full path keeps files with the same name apart
+	std::string::size_type separator = filename.find_last_of("/\\");
+	std::string name = separator == std::string::npos ? filename : filename.substr(separator + 1);
+
+	char hash[17];
+	std::snprintf(hash, sizeof(hash), "%016llx", (unsigned long long)std::hash<std::string>()(filename));
+
+	return directory + "/" + name + "." + hash + SIDECAR_EXTENSION;
+}
+
+static std::shared_ptr<Waveform> compute_waveform(std::string filename, std::string sidecar, unsigned long long stamp)
+{
+	std::shared_ptr<Waveform> waveform;
+
+	if(!sidecar.empty())
+		waveform = Waveform::load(sidecar, stamp);
+
+	if(!waveform)
+	{
+		waveform = Waveform::compute(std::make_shared<File>(filename));
+
+		if(!sidecar.empty())
+			waveform->save(sidecar, stamp);
+	}
+
+	return waveform;
+}
+
+static std::shared_ptr<Waveform> load_waveform(std::string filename, std::string sidecar, unsigned long long stamp, unsigned int id)
+{
+	WaveformCacheState& state = waveformCacheState();
+	std::shared_ptr<Waveform> waveform;
+
+	try
+	{
+		waveform = compute_waveform(filename, sidecar, stamp);
+	}
+	catch(...)
+	{
+		// forget the failure, so that the next request tries again
+		std::lock_guard<std::mutex> lock(state.mutex);
+
+		auto it = state.files.find(filename);
+
+		if(it != state.files.end() && it->second->id == id)
+			remove_waveform(state, it->second);
+
+		throw;
+	}
+
+	std::lock_guard<std::mutex> lock(state.mutex);
+
+	auto it = state.files.find(filename);
+
+	// the entry might have been replaced, evicted or cleared in the meantime
+	if(it != state.files.end() && it->second->id == id)
+	{
+		it->second->size = waveform->getSize();
+		state.usage += it->second->size;
+		evict_waveforms(state);
+	}
+
+	return waveform;
+}
+
+std::shared_future<std::shared_ptr<Waveform> > WaveformCache::get(std::string filename)
+{
+	WaveformCacheState& state = waveformCacheState();
+	struct stat info;
+	unsigned long long stamp = 0;
+
+	if(stat(filename.c_str(), &info) == 0)
+		stamp = (unsigned long long)info.st_size * 0x9E3779B97F4A7C15ull ^ (unsigned long long)info.st_mtime;
+
+	std::lock_guard<std::mutex> lock(state.mutex);
+
+	auto it = state.files.find(filename);
+
+	if(it != state.files.end())
+	{
+		if(it->second->stamp == stamp)
+		{
+			state.entries.splice(state.entries.begin(), state.entries, it->second);
+			return it->second->waveform;
+		}
+
+		remove_waveform(state, it->second);
+	}
+
+	// files that can't be stat'ed, like URLs, can't be validated against a sidecar
+	std::string sidecar = state.persistent && stamp ? sidecar_path(filename, state.directory) : "";
+
+	WaveformCacheEntry entry;
+	entry.filename = filename;
+	entry.stamp = stamp;
+	entry.id = state.next_id++;
+	entry.size = 0;
+
+	// the computation locks the mutex when it finishes, so it finds the entry inserted below
+	entry.waveform = AsyncLoader::getDecodePool()->enqueue(load_waveform, filename, sidecar, stamp, entry.id).share();
+
+	state.entries.push_front(entry);
+	state.files[filename] = state.entries.begin();
+
+	return entry.waveform;
+}
+
+void WaveformCache::setDirectory(std::string directory)
+{
+	WaveformCacheState& state = waveformCacheState();
+
+	std::lock_guard<std::mutex> lock(state.mutex);
+
+	state.directory = directory;
+}
+
+std::string WaveformCache::getDirectory()
+{
+	WaveformCacheState& state = waveformCacheState();
+
+	std::lock_guard<std::mutex> lock(state.mutex);
+
+	return state.directory;
+}
+
+void WaveformCache::setPersistent(bool persistent)
+{
+	WaveformCacheState& state = waveformCacheState();
+
+	std::lock_guard<std::mutex> lock(state.mutex);
+
+	state.persistent = persistent;
+}
+
+bool WaveformCache::isPersistent()
+{
+	WaveformCacheState& state = waveformCacheState();
+
+	std::lock_guard<std::mutex> lock(state.mutex);
+
+	return state.persistent;
+}
+
+void WaveformCache::setBudget(size_t bytes)
+{
+	WaveformCacheState& state = waveformCacheState();
+
+	std::lock_guard<std::mutex> lock(state.mutex);
+
+	state.budget = bytes;
+	evict_waveforms(state);
+}
+
+size_t WaveformCache::getBudget()
+{
+	WaveformCacheState& state = waveformCacheState();
+
+	std::lock_guard<std::mutex> lock(state.mutex);
+
+	return state.budget;
+}
+
+size_t WaveformCache::getMemoryUsage()
+{
+	WaveformCacheState& state = waveformCacheState();
+
+	std::lock_guard<std::mutex> lock(state.mutex);
+
+	return state.usage;
+}
+
+void WaveformCache::clear()
+{
+	WaveformCacheState& state = waveformCacheState();
+
+	std::lock_guard<std::mutex> lock(state.mutex);
+
+	state.entries.clear();
+	state.files.clear();
+	state.usage = 0;
+}
+
+AUD_NAMESPACE_END